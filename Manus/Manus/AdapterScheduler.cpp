@@ -0,0 +1,267 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "AdapterScheduler.h"
+
+#include <float.h>
+
+#include <algorithm>
+
+void AdapterScheduler::GetDefaultCapacity(GLOVE_ADAPTER_CAPACITY* capacity)
+{
+	capacity->Connections = SCHEDULER_CONNECTIONS;
+	capacity->Bandwidth = SCHEDULER_BANDWIDTH;
+}
+
+int AdapterScheduler::AddAdapter()
+{
+	ADAPTER adapter;
+	GetDefaultCapacity(&adapter.capacity);
+	adapter.migrations = 0;
+	m_adapters.push_back(adapter);
+	return (int)m_adapters.size() - 1;
+}
+
+void AdapterScheduler::SetCapacity(int adapter, const GLOVE_ADAPTER_CAPACITY& capacity)
+{
+	m_adapters[adapter].capacity = capacity;
+}
+
+void AdapterScheduler::AddGlove(uint64_t glove, int adapter)
+{
+	std::map<uint64_t, GLOVE>::iterator it = m_gloves.find(glove);
+	if (it == m_gloves.end())
+	{
+		GLOVE entry;
+		entry.adapter = -1;
+		entry.measured = false;
+		entry.rate = 0.0f;
+		entry.loss = 0.0f;
+		entry.settled = 0;
+		it = m_gloves.insert(std::make_pair(glove, entry)).first;
+	}
+
+	std::vector<int>& adapters = it->second.adapters;
+	if (std::find(adapters.begin(), adapters.end(), adapter) == adapters.end())
+		adapters.push_back(adapter);
+}
+
+int AdapterScheduler::Assign(uint64_t glove)
+{
+	std::map<uint64_t, GLOVE>::iterator it = m_gloves.find(glove);
+	if (it == m_gloves.end())
+		return -1;
+
+	GLOVE& entry = it->second;
+	if (entry.adapter >= 0)
+		return entry.adapter;
+
+	// Prefer an adapter with a free connection, then the lowest load with the glove added
+	float demand = GetDemand(entry);
+	bool best_full = true;
+	float best_load = FLT_MAX;
+	for (int adapter : entry.adapters)
+	{
+		GLOVE_ADAPTER_INFO info;
+		GetInfo(adapter, &info);
+
+		bool full = info.Gloves >= info.Capacity.Connections;
+		float load = GetLoad(adapter, info.Gloves + 1, info.Demand + demand);
+		if ((best_full && !full) || (full == best_full && load < best_load))
+		{
+			entry.adapter = adapter;
+			best_full = full;
+			best_load = load;
+		}
+	}
+
+	return entry.adapter;
+}
+
+int AdapterScheduler::GetAdapter(uint64_t glove) const
+{
+	std::map<uint64_t, GLOVE>::const_iterator it = m_gloves.find(glove);
+	return it != m_gloves.end() ? it->second.adapter : -1;
+}
+
+void AdapterScheduler::Update(uint64_t glove, uint64_t now, float rate, float loss)
+{
+	std::map<uint64_t, GLOVE>::iterator it = m_gloves.find(glove);
+	if (it == m_gloves.end() || now < it->second.settled)
+		return;
+
+	it->second.measured = true;
+	it->second.rate = rate;
+	it->second.loss = loss;
+}
+
+void AdapterScheduler::Rebalance(uint64_t now, std::vector<ADAPTER_MIGRATION>& migrations)
+{
+	migrations.clear();
+
+	std::vector<GLOVE_ADAPTER_INFO> infos(m_adapters.size());
+	std::vector<int> order;
+	for (int adapter = 0; adapter < (int)m_adapters.size(); adapter++)
+	{
+		GetInfo(adapter, &infos[adapter]);
+		order.push_back(adapter);
+	}
+
+	// Relieve the most loaded adapters first
+	std::sort(order.begin(), order.end(), [&](int a, int b) { return infos[a].Load > infos[b].Load; });
+
+	for (int source : order)
+	{
+		// Over capacity the moves follow from the numbers, a loss only shows how one move worked out
+		for (bool first = true; ; first = false)
+		{
+			const GLOVE_ADAPTER_INFO& info = infos[source];
+			bool over = info.Gloves > info.Capacity.Connections ||
+				info.Demand > info.Capacity.Bandwidth * SCHEDULER_SATURATION;
+			if (!(first ? info.Saturated : over) || !Migrate(source, now, infos, migrations))
+				break;
+		}
+	}
+}
+
+bool AdapterScheduler::Migrate(int source, uint64_t now, std::vector<GLOVE_ADAPTER_INFO>& infos,
+	std::vector<ADAPTER_MIGRATION>& migrations)
+{
+	// Move the glove with the largest demand that fits on another adapter
+	GLOVE* best = nullptr;
+	uint64_t best_glove = 0;
+	int best_target = -1;
+	float best_demand = -1.0f;
+	float best_load = FLT_MAX;
+	for (std::pair<const uint64_t, GLOVE>& entry : m_gloves)
+	{
+		GLOVE& glove = entry.second;
+		if (glove.adapter != source || now < glove.settled)
+			continue;
+
+		float demand = GetDemand(glove);
+		for (int target : glove.adapters)
+		{
+			const GLOVE_ADAPTER_INFO& info = infos[target];
+			if (target == source || info.Saturated ||
+				info.Gloves + 1 > info.Capacity.Connections ||
+				info.Demand + demand > info.Capacity.Bandwidth * SCHEDULER_SATURATION)
+				continue;
+
+			float load = GetLoad(target, info.Gloves + 1, info.Demand + demand);
+			if (demand > best_demand || (demand == best_demand && load < best_load))
+			{
+				best = &glove;
+				best_glove = entry.first;
+				best_target = target;
+				best_demand = demand;
+				best_load = load;
+			}
+		}
+	}
+
+	if (!best)
+		return false;
+
+	// The rate belongs to the glove, the loss to the adapter it leaves
+	best->adapter = best_target;
+	best->loss = 0.0f;
+	best->settled = now + SCHEDULER_SETTLE;
+	m_adapters[source].migrations++;
+
+	ADAPTER_MIGRATION migration;
+	migration.glove = best_glove;
+	migration.from = source;
+	migration.to = best_target;
+	migrations.push_back(migration);
+
+	// Later moves see the ones made so far
+	GetInfo(source, &infos[source]);
+	GetInfo(best_target, &infos[best_target]);
+
+	return true;
+}
+
+void AdapterScheduler::Revert(const ADAPTER_MIGRATION& migration)
+{
+	std::map<uint64_t, GLOVE>::iterator it = m_gloves.find(migration.glove);
+	if (it == m_gloves.end() || it->second.adapter != migration.to)
+		return;
+
+	it->second.adapter = migration.from;
+	if (m_adapters[migration.from].migrations > 0)
+		m_adapters[migration.from].migrations--;
+}
+
+void AdapterScheduler::GetInfo(int adapter, GLOVE_ADAPTER_INFO* info) const
+{
+	const ADAPTER& entry = m_adapters[adapter];
+	info->Capacity = entry.capacity;
+	info->Migrations = entry.migrations;
+	info->Gloves = 0;
+	info->Demand = 0.0f;
+
+	float measured = 0.0f;
+	float received = 0.0f;
+	for (const std::pair<const uint64_t, GLOVE>& glove : m_gloves)
+	{
+		if (glove.second.adapter != adapter)
+			continue;
+
+		float demand = GetDemand(glove.second);
+		info->Gloves++;
+		info->Demand += demand;
+		if (glove.second.measured)
+		{
+			measured += demand;
+			received += glove.second.rate;
+		}
+	}
+
+	info->Loss = measured > 0.0f ? std::max(0.0f, 1.0f - received / measured) : 0.0f;
+	info->Load = GetLoad(adapter, info->Gloves, info->Demand);
+	info->Saturated = info->Gloves > entry.capacity.Connections ||
+		info->Demand > entry.capacity.Bandwidth * SCHEDULER_SATURATION ||
+		info->Loss > SCHEDULER_LOSS;
+}
+
+void AdapterScheduler::Clear()
+{
+	m_adapters.clear();
+	m_gloves.clear();
+}
+
+float AdapterScheduler::GetDemand(const GLOVE& glove)
+{
+	if (!glove.measured)
+		return SCHEDULER_RATE;
+
+	// A glove that loses everything is silent rather than demanding
+	return glove.loss < 1.0f ? glove.rate / (1.0f - glove.loss) : 0.0f;
+}
+
+float AdapterScheduler::GetLoad(int adapter, unsigned int gloves, float demand) const
+{
+	const GLOVE_ADAPTER_CAPACITY& capacity = m_adapters[adapter].capacity;
+	float connections = capacity.Connections > 0 ? (float)gloves / capacity.Connections : (gloves > 0 ? FLT_MAX : 0.0f);
+	float bandwidth = capacity.Bandwidth > 0.0f ? demand / capacity.Bandwidth : (demand > 0.0f ? FLT_MAX : 0.0f);
+	return std::max(connections, bandwidth);
+}
@@ -0,0 +1,167 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Manus.h"
+
+#include <inttypes.h>
+#include <map>
+#include <vector>
+
+// Default capacity of an adapter, a typical radio keeps about seven
+// connections and delivers the reports of about ten gloves
+#define SCHEDULER_CONNECTIONS 7
+#define SCHEDULER_BANDWIDTH   1000.0f
+
+// Reports per second assumed for a glove until its rate is measured
+#define SCHEDULER_RATE 100.0f
+
+// An adapter saturates above this fraction of its bandwidth or this loss
+#define SCHEDULER_SATURATION 0.9f
+#define SCHEDULER_LOSS       0.05f
+
+// Time in microseconds between two looks at the load of the adapters
+#define SCHEDULER_PERIOD 1000000
+
+// Time in microseconds for the link of a glove that was moved to settle,
+// the reconnection itself shows up as lost reports
+#define SCHEDULER_SETTLE 3000000
+
+/*! A glove to move from one adapter to another. */
+typedef struct
+{
+	uint64_t glove;
+	int from;
+	int to;
+} ADAPTER_MIGRATION;
+
+/*
+ * Spreads the gloves over the Bluetooth adapters they are paired with.
+ *
+ * A glove is placed on the reachable adapter that has the lowest load
+ * afterwards, where the load is the larger of the fractions of the
+ * connections and the bandwidth in use. The demand of a glove is its
+ * measured rate plus the reports it loses, so an adapter that can't keep
+ * up still sees the full demand of its gloves.
+ *
+ * Rebalance looks for adapters that are over their capacity or lose too
+ * many reports and moves gloves off them, to adapters that stay below
+ * saturation with the glove added. Gloves are moved until an adapter is
+ * back within its capacity, but a loss is answered with a single move per
+ * round as it doesn't tell how many gloves are too many. A glove that was
+ * moved isn't considered again until its link has settled, so the loss
+ * caused by the move itself doesn't bounce it around.
+ *
+ * The scheduler only deals with numbers, gloves are identified by their
+ * Bluetooth address and adapters by an index, so it can be driven by
+ * simulated adapters as well. It isn't synchronized, the caller serializes
+ * access to it.
+ */
+class AdapterScheduler
+{
+private:
+	typedef struct
+	{
+		GLOVE_ADAPTER_CAPACITY capacity;
+		unsigned int migrations;
+	} ADAPTER;
+
+	typedef struct
+	{
+		// Adapters the glove is paired with
+		std::vector<int> adapters;
+		// Adapter the glove is connected through, -1 when not placed yet
+		int adapter;
+		bool measured;
+		float rate;
+		float loss;
+		// Measurements before this time are ignored
+		uint64_t settled;
+	} GLOVE;
+
+	std::vector<ADAPTER> m_adapters;
+	std::map<uint64_t, GLOVE> m_gloves;
+
+public:
+	/*! Get the default capacity of an adapter. */
+	static void GetDefaultCapacity(GLOVE_ADAPTER_CAPACITY* capacity);
+
+	/*! \brief Add an adapter with the default capacity.
+	*
+	*  \return The index of the adapter.
+	*/
+	int AddAdapter();
+
+	size_t GetAdapterCount() const { return m_adapters.size(); }
+	void SetCapacity(int adapter, const GLOVE_ADAPTER_CAPACITY& capacity);
+
+	/*! \brief Make a glove reachable through an adapter.
+	*
+	*  The glove isn't placed until Assign is called, so all the adapters
+	*  a glove is paired with can be added first.
+	*/
+	void AddGlove(uint64_t glove, int adapter);
+
+	/*! \brief Place a glove on the adapter with the lowest load.
+	*
+	*  A glove that was placed before keeps its adapter.
+	*
+	*  \return The adapter of the glove, or -1 if the glove is unknown.
+	*/
+	int Assign(uint64_t glove);
+
+	/*! The adapter of a glove, or -1 if the glove isn't placed. */
+	int GetAdapter(uint64_t glove) const;
+
+	/*! \brief Update the measured link of a glove.
+	*
+	*  \param now Current time on the SDK clock.
+	*  \param rate Reports received per second, zero for a glove that is silent.
+	*  \param loss Fraction of the reports lost.
+	*/
+	void Update(uint64_t glove, uint64_t now, float rate, float loss);
+
+	/*! \brief Move gloves off the saturated adapters.
+	*
+	*  The gloves are assigned to their new adapter right away, the caller
+	*  reconnects them.
+	*
+	*  \param now Current time on the SDK clock.
+	*  \param migrations Receives the gloves to move.
+	*/
+	void Rebalance(uint64_t now, std::vector<ADAPTER_MIGRATION>& migrations);
+
+	/*! \brief Undo a migration that couldn't be carried out.
+	*
+	*  The glove stays settling, so it isn't moved again right away.
+	*/
+	void Revert(const ADAPTER_MIGRATION& migration);
+
+	void GetInfo(int adapter, GLOVE_ADAPTER_INFO* info) const;
+
+	void Clear();
+
+private:
+	bool Migrate(int source, uint64_t now, std::vector<GLOVE_ADAPTER_INFO>& infos,
+		std::vector<ADAPTER_MIGRATION>& migrations);
+	static float GetDemand(const GLOVE& glove);
+	float GetLoad(int adapter, unsigned int gloves, float demand) const;
+};
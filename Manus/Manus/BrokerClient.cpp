@@ -0,0 +1,188 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "BrokerClient.h"
+#include "Clock.h"
+
+// Number of polls before a waiting reader starts giving up its time slice
+#define SPIN_COUNT 1000
+
+// Number of attempts at copying the newest slot before giving up
+#define READ_RETRIES 16
+
+BrokerClient::BrokerClient()
+	: m_mapping(nullptr)
+	, m_command_event(nullptr)
+	, m_region(nullptr)
+{
+}
+
+BrokerClient::~BrokerClient()
+{
+	Detach();
+}
+
+bool BrokerClient::Attach()
+{
+	if (m_region)
+		return false;
+
+	m_mapping = OpenFileMapping(FILE_MAP_ALL_ACCESS, FALSE, BROKER_REGION_NAME);
+	if (!m_mapping)
+		return false;
+
+	m_region = (BROKER_REGION*)MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(BROKER_REGION));
+	if (!m_region || m_region->magic != BROKER_MAGIC || m_region->version != BROKER_VERSION)
+	{
+		Detach();
+		return false;
+	}
+
+	m_command_event = OpenEvent(EVENT_MODIFY_STATE, FALSE, BROKER_COMMAND_NAME);
+
+	return true;
+}
+
+void BrokerClient::Detach()
+{
+	if (m_region)
+		UnmapViewOfFile(m_region);
+	m_region = nullptr;
+
+	if (m_command_event)
+		CloseHandle(m_command_event);
+	m_command_event = nullptr;
+
+	if (m_mapping)
+		CloseHandle(m_mapping);
+	m_mapping = nullptr;
+}
+
+bool BrokerClient::IsConnected(GLOVE_HAND hand) const
+{
+	if (!m_region->alive.load(std::memory_order_acquire) ||
+		!m_region->hands[hand].connected.load(std::memory_order_relaxed))
+		return false;
+
+	// An owner that crashed left alive set, but stopped its heartbeat
+	uint64_t heartbeat = m_region->heartbeat.load(std::memory_order_acquire);
+	uint64_t now = GetTimestamp();
+	return now < heartbeat || now - heartbeat < BROKER_STALE;
+}
+
+bool BrokerClient::ReadSlot(const BROKER_SLOT& slot, uint32_t index, GLOVE_SAMPLE* sample) const
+{
+	// The slot holds the requested sample once its sequence is 2 * index + 2
+	uint32_t expected = 2 * index + 2;
+	if (slot.sequence.load(std::memory_order_acquire) != expected)
+		return false;
+
+	*sample = slot.sample;
+
+	// Reject the copy if the writer touched the slot while we were reading it
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return slot.sequence.load(std::memory_order_relaxed) == expected;
+}
+
+int BrokerClient::GetData(GLOVE_HAND hand, GLOVE_DATA* data, unsigned int timeout)
+{
+	if (!m_region)
+		return MANUS_DISCONNECTED;
+
+	BROKER_HAND& ring = m_region->hands[hand];
+
+	// Optionally wait until the next package is published
+	if (timeout > 0)
+	{
+		uint32_t head = ring.head.load(std::memory_order_acquire);
+		uint64_t deadline = GetTimestamp() + timeout * 1000ull;
+
+		for (int spin = 0; ring.head.load(std::memory_order_acquire) == head; spin++)
+		{
+			if (!IsConnected(hand) && head > 0)
+				return MANUS_DISCONNECTED;
+			if (GetTimestamp() >= deadline)
+				break;
+
+			if (spin < SPIN_COUNT)
+				YieldProcessor();
+			else
+				Sleep(spin < 2 * SPIN_COUNT ? 0 : 1);
+		}
+	}
+
+	if (!IsConnected(hand))
+		return MANUS_DISCONNECTED;
+
+	// Retry if the writer lapped us while copying the newest slot
+	GLOVE_SAMPLE sample;
+	for (int retry = 0; retry < READ_RETRIES; retry++)
+	{
+		uint32_t head = ring.head.load(std::memory_order_acquire);
+		if (head == 0)
+			return MANUS_ERROR;
+
+		if (ReadSlot(ring.slots[(head - 1) & (BROKER_SLOTS - 1)], head - 1, &sample))
+		{
+			*data = sample.data;
+			return MANUS_SUCCESS;
+		}
+	}
+
+	return MANUS_ERROR;
+}
+
+unsigned int BrokerClient::Read(GLOVE_HAND hand, unsigned int* cursor, GLOVE_SAMPLE* samples, unsigned int count)
+{
+	if (!m_region)
+		return 0;
+
+	BROKER_HAND& ring = m_region->hands[hand];
+	uint32_t head = ring.head.load(std::memory_order_acquire);
+
+	// Skip the samples that have already been overwritten
+	if (head - *cursor > BROKER_SLOTS)
+		*cursor = head - BROKER_SLOTS;
+
+	unsigned int read = 0;
+	while (read < count && *cursor != head)
+	{
+		// A slot that no longer holds the expected index was overwritten, move past it
+		if (ReadSlot(ring.slots[*cursor & (BROKER_SLOTS - 1)], *cursor, &samples[read]))
+			read++;
+
+		(*cursor)++;
+	}
+
+	return read;
+}
+
+int BrokerClient::SetVibration(GLOVE_HAND hand, float power)
+{
+	if (!m_region || !m_command_event)
+		return MANUS_DISCONNECTED;
+
+	BROKER_HAND& ring = m_region->hands[hand];
+	ring.vibration.store(power, std::memory_order_relaxed);
+	ring.vibration_sequence.fetch_add(1, std::memory_order_release);
+	SetEvent(m_command_event);
+
+	return MANUS_SUCCESS;
+}
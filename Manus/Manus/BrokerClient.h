@@ -0,0 +1,61 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "BrokerRegion.h"
+
+class BrokerClient
+{
+private:
+	HANDLE m_mapping;
+	HANDLE m_command_event;
+	BROKER_REGION* m_region;
+
+public:
+	BrokerClient();
+	~BrokerClient();
+
+	/*! Attach to the region of a running broker. */
+	bool Attach();
+	void Detach();
+	bool IsAttached() const { return m_region != nullptr; }
+
+	/*! \brief Get the newest sample of a hand.
+	*
+	*  Waiting is done by polling the ring, the read itself takes no lock.
+	*/
+	int GetData(GLOVE_HAND hand, GLOVE_DATA* data, unsigned int timeout);
+
+	/*! \brief Read the samples written since the cursor.
+	*
+	*  The cursor is advanced past the samples read. If the reader fell
+	*  more than BROKER_SLOTS samples behind the oldest ones are skipped.
+	*
+	*  \return The number of samples read.
+	*/
+	unsigned int Read(GLOVE_HAND hand, unsigned int* cursor, GLOVE_SAMPLE* samples, unsigned int count);
+
+	/*! Ask the owner of the gloves to change the vibration power. */
+	int SetVibration(GLOVE_HAND hand, float power);
+
+private:
+	bool ReadSlot(const BROKER_SLOT& slot, uint32_t index, GLOVE_SAMPLE* sample) const;
+	bool IsConnected(GLOVE_HAND hand) const;
+};
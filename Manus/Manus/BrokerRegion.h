@@ -0,0 +1,86 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Glove.h"
+
+#include <atomic>
+
+#define BROKER_REGION_NAME  L"Local\\ManusBroker"
+#define BROKER_COMMAND_NAME L"Local\\ManusBrokerCommand"
+#define BROKER_MAGIC        0x4D425252
+#define BROKER_VERSION      3
+
+// Must be a power of two
+#define BROKER_SLOTS        64
+
+// Interval at which the owner refreshes the heartbeat in milliseconds
+#define BROKER_HEARTBEAT    100
+
+// Age in microseconds after which readers consider the owner to be gone
+#define BROKER_STALE        500000
+
+/*
+ * Layout of the shared memory region. There is a single writer, the process
+ * that owns the gloves, and any number of readers in other processes.
+ *
+ * Every slot is protected by a sequence lock: the writer makes the sequence
+ * odd before changing the sample and even again afterwards. A reader copies
+ * the sample and only accepts it if the sequence was even and unchanged, so
+ * readers never take a lock or make a system call.
+ *
+ * An owner that crashes never clears the alive flag, so it also refreshes a
+ * heartbeat. The performance counter is shared by all processes, so readers
+ * compare it against their own GetTimestamp and treat a stale heartbeat the
+ * same as a cleared alive flag.
+ *
+ * The region stays around as long as a reader has it open, so a new owner
+ * takes over a region whose heartbeat is stale or zero, which Stop leaves
+ * behind. It claims the region with a compare-exchange on the heartbeat,
+ * so two processes starting at once can't both own it.
+ */
+
+typedef struct
+{
+	std::atomic<uint32_t> sequence;
+	GLOVE_SAMPLE sample;
+} BROKER_SLOT;
+
+typedef struct
+{
+	// Total number of samples written, the newest is at (head - 1) % BROKER_SLOTS.
+	std::atomic<uint32_t> head;
+	std::atomic<uint32_t> connected;
+
+	// Vibration requested by a reader, applied by the owner.
+	std::atomic<uint32_t> vibration_sequence;
+	std::atomic<float> vibration;
+
+	BROKER_SLOT slots[BROKER_SLOTS];
+} BROKER_HAND;
+
+typedef struct
+{
+	uint32_t magic;
+	uint32_t version;
+	std::atomic<uint32_t> alive;
+	std::atomic<uint64_t> heartbeat;
+	BROKER_HAND hands[2];
+} BROKER_REGION;
@@ -0,0 +1,186 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "BrokerServer.h"
+#include "ThreadRegistry.h"
+#include "Clock.h"
+
+BrokerServer::BrokerServer()
+	: m_mapping(nullptr)
+	, m_command_event(nullptr)
+	, m_region(nullptr)
+	, m_running(false)
+{
+}
+
+BrokerServer::~BrokerServer()
+{
+	Stop();
+}
+
+bool BrokerServer::Start(std::function<void(GLOVE_HAND, float)> vibration)
+{
+	if (m_region)
+		return false;
+
+	m_mapping = CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+		0, sizeof(BROKER_REGION), BROKER_REGION_NAME);
+	if (!m_mapping)
+		return false;
+
+	// The mapping outlives an owner that crashed for as long as readers have it open
+	bool existing = GetLastError() == ERROR_ALREADY_EXISTS;
+
+	BROKER_REGION* region = (BROKER_REGION*)MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(BROKER_REGION));
+	if (!region)
+	{
+		CloseHandle(m_mapping);
+		m_mapping = nullptr;
+		return false;
+	}
+
+	// Only one process can own the gloves. A region without a fresh heartbeat has no owner, and
+	// moving the heartbeat forward from the value that was seen claims it, so only one process wins.
+	uint64_t now = GetTimestamp();
+	uint64_t heartbeat = region->heartbeat.load(std::memory_order_acquire);
+	bool stale = heartbeat == 0 || (now > heartbeat && now - heartbeat >= BROKER_STALE);
+	if (!stale || !region->heartbeat.compare_exchange_strong(heartbeat, now, std::memory_order_acq_rel))
+	{
+		UnmapViewOfFile(region);
+		CloseHandle(m_mapping);
+		m_mapping = nullptr;
+		return false;
+	}
+
+	m_command_event = CreateEvent(nullptr, FALSE, FALSE, BROKER_COMMAND_NAME);
+
+	// A new mapping is zero-filled, so only the header has to be set. The slots of a region taken
+	// over keep their sequences, which only grow, so readers carry on with the new samples.
+	region->magic = BROKER_MAGIC;
+	region->version = BROKER_VERSION;
+	if (existing)
+	{
+		region->hands[GLOVE_LEFT].connected.store(0, std::memory_order_relaxed);
+		region->hands[GLOVE_RIGHT].connected.store(0, std::memory_order_relaxed);
+	}
+	region->alive.store(1, std::memory_order_release);
+
+	// Publish only writes once the header is complete
+	m_region.store(region);
+
+	m_vibration = vibration;
+	m_running = true;
+	m_command_thread = std::thread(&BrokerServer::CommandThread, this);
+
+	return true;
+}
+
+void BrokerServer::Stop()
+{
+	if (!m_region)
+		return;
+
+	m_running = false;
+	SetEvent(m_command_event);
+	m_command_thread.join();
+
+	// Wait for the writers to leave the region before it goes away
+	std::lock(m_write_mutex[GLOVE_LEFT], m_write_mutex[GLOVE_RIGHT]);
+	std::lock_guard<std::mutex> left(m_write_mutex[GLOVE_LEFT], std::adopt_lock);
+	std::lock_guard<std::mutex> right(m_write_mutex[GLOVE_RIGHT], std::adopt_lock);
+
+	BROKER_REGION* region = m_region.exchange(nullptr);
+
+	// Let the readers know the gloves are gone
+	region->hands[GLOVE_LEFT].connected.store(0, std::memory_order_relaxed);
+	region->hands[GLOVE_RIGHT].connected.store(0, std::memory_order_relaxed);
+	region->alive.store(0, std::memory_order_release);
+
+	// The next owner can take the region over right away
+	region->heartbeat.store(0, std::memory_order_release);
+
+	UnmapViewOfFile(region);
+
+	CloseHandle(m_command_event);
+	m_command_event = nullptr;
+
+	CloseHandle(m_mapping);
+	m_mapping = nullptr;
+}
+
+void BrokerServer::Publish(const GLOVE_SAMPLE& sample)
+{
+	// Don't contend on the lock when there is no broker
+	if (!m_region.load(std::memory_order_relaxed))
+		return;
+
+	std::lock_guard<std::mutex> lock(m_write_mutex[sample.hand]);
+
+	// Stop may have unmapped the region while we were waiting
+	BROKER_REGION* region = m_region.load(std::memory_order_relaxed);
+	if (!region)
+		return;
+
+	BROKER_HAND& hand = region->hands[sample.hand];
+	uint32_t index = hand.head.load(std::memory_order_relaxed);
+	BROKER_SLOT& slot = hand.slots[index & (BROKER_SLOTS - 1)];
+
+	// The sequence is odd while writing and encodes the index when done,
+	// so a reader can tell a torn or overwritten slot apart.
+	slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot.sample = sample;
+
+	slot.sequence.store(2 * index + 2, std::memory_order_release);
+	hand.head.store(index + 1, std::memory_order_release);
+	hand.connected.store(1, std::memory_order_relaxed);
+}
+
+void BrokerServer::CommandThread()
+{
+	ThreadScope thread_scope(GLOVE_THREAD_BROKER);
+
+	BROKER_REGION* region = m_region.load();
+
+	// Requests left in a region that was taken over were meant for the previous owner
+	uint32_t handled[2];
+	for (int i = 0; i < 2; i++)
+		handled[i] = region->hands[i].vibration_sequence.load(std::memory_order_acquire);
+
+	// Readers signal the event after posting a request, the timeout only
+	// wakes the thread to keep the heartbeat fresh.
+	while (WaitForSingleObject(m_command_event, BROKER_HEARTBEAT) != WAIT_FAILED && m_running)
+	{
+		region->heartbeat.store(GetTimestamp(), std::memory_order_release);
+
+		for (int i = 0; i < 2; i++)
+		{
+			BROKER_HAND& hand = region->hands[i];
+			uint32_t sequence = hand.vibration_sequence.load(std::memory_order_acquire);
+			if (sequence == handled[i])
+				continue;
+
+			handled[i] = sequence;
+			if (m_vibration)
+				m_vibration((GLOVE_HAND)i, hand.vibration.load(std::memory_order_relaxed));
+		}
+	}
+}
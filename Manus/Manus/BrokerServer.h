@@ -0,0 +1,65 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "BrokerRegion.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class BrokerServer
+{
+private:
+	HANDLE m_mapping;
+	HANDLE m_command_event;
+	std::atomic<BROKER_REGION*> m_region;
+
+	std::atomic<bool> m_running;
+	std::thread m_command_thread;
+	std::function<void(GLOVE_HAND, float)> m_vibration;
+
+	// Gloves notify on their own threads, but every hand has a single writer.
+	// Stop takes both so the region isn't unmapped under a writer.
+	std::mutex m_write_mutex[2];
+
+public:
+	BrokerServer();
+	~BrokerServer();
+
+	/*! \brief Create the shared region and start accepting requests.
+	*
+	*  Takes over a region that readers still have open if its owner stopped
+	*  or its heartbeat is stale.
+	*
+	*  \param vibration Called when a reader requests a vibration change.
+	*  \return False if another process owns the region.
+	*/
+	bool Start(std::function<void(GLOVE_HAND, float)> vibration);
+	void Stop();
+	bool IsRunning() const { return m_region != nullptr; }
+
+	/*! Write a sample into the ring of its hand. */
+	void Publish(const GLOVE_SAMPLE& sample);
+
+private:
+	void CommandThread();
+};
@@ -0,0 +1,56 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+
+/*! \brief Get the current time of the SDK clock.
+*
+*  The clock is monotonic and shared by every part of the SDK
+*  so timestamps from different gloves can be compared.
+*
+*  \return Microseconds since an arbitrary point in time.
+*/
+inline uint64_t GetTimestamp()
+{
+	static const LARGE_INTEGER freq = [] { LARGE_INTEGER f; QueryPerformanceFrequency(&f); return f; }();
+
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+
+	// Split the conversion to avoid overflowing the 64-bit counter
+	return (uint64_t)(now.QuadPart / freq.QuadPart) * 1000000 +
+		(uint64_t)(now.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart;
+}
+
+/*! \brief Get the current time of the SDK clock in nanoseconds.
+*
+*  Meant for measuring short durations, see GetTimestamp.
+*/
+inline uint64_t GetTimestampNs()
+{
+	static const LARGE_INTEGER freq = [] { LARGE_INTEGER f; QueryPerformanceFrequency(&f); return f; }();
+
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+
+	return (uint64_t)(now.QuadPart / freq.QuadPart) * 1000000000 +
+		(uint64_t)(now.QuadPart % freq.QuadPart) * 1000000000 / freq.QuadPart;
+}
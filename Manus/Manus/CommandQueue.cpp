@@ -0,0 +1,119 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "CommandQueue.h"
+#include "ThreadRegistry.h"
+
+CommandQueue::CommandQueue()
+	: m_stop(true)
+{
+}
+
+CommandQueue::~CommandQueue()
+{
+	Stop();
+}
+
+void CommandQueue::Start()
+{
+	std::lock_guard<std::mutex> control_lock(m_control_mutex);
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_stop = false;
+}
+
+void CommandQueue::Post(std::function<int()> work, GLOVE_COMPLETION_CALLBACK callback, void* context)
+{
+	COMMAND command;
+	command.work = std::move(work);
+	command.callback = callback;
+	command.context = context;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (!m_stop)
+		{
+			m_commands.push_back(std::move(command));
+
+			if (!m_thread.joinable())
+				m_thread = std::thread(&CommandQueue::CommandThread, this);
+			m_wake.notify_one();
+			return;
+		}
+	}
+
+	// A stopped queue doesn't come back to life, the command is dropped outside the lock like in Stop
+	if (command.callback)
+		command.callback(MANUS_DISCONNECTED, command.context);
+}
+
+void CommandQueue::Stop()
+{
+	std::lock_guard<std::mutex> control_lock(m_control_mutex);
+
+	// The thread is taken out under the lock, so Post can't see it while it is joined
+	std::thread thread;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+		thread.swap(m_thread);
+		m_wake.notify_one();
+	}
+
+	if (thread.joinable())
+		thread.join();
+
+	// Complete the commands outside the lock, so the callbacks can queue new ones
+	std::deque<COMMAND> dropped;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		dropped.swap(m_commands);
+	}
+
+	for (const COMMAND& command : dropped)
+	{
+		if (command.callback)
+			command.callback(MANUS_DISCONNECTED, command.context);
+	}
+}
+
+void CommandQueue::CommandThread()
+{
+	ThreadScope thread_scope(GLOVE_THREAD_COMMANDS);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_wake.wait(lock, [this] { return m_stop || !m_commands.empty(); });
+		if (m_stop)
+			break;
+
+		COMMAND command = std::move(m_commands.front());
+		m_commands.pop_front();
+
+		lock.unlock();
+		int result = command.work();
+		if (command.callback)
+			command.callback(result, command.context);
+		lock.lock();
+	}
+}
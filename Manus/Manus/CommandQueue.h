@@ -0,0 +1,80 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Manus.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/*
+ * Runs commands for the gloves on a background thread.
+ *
+ * Writing to a glove waits for the Bluetooth stack, so the asynchronous
+ * functions queue the write here and return right away. Commands run in
+ * the order they were queued, and the completion callback of a command
+ * is called on the background thread when it is done.
+ *
+ * The queue is stopped until Start is called. A stopped queue completes
+ * every command it is given with MANUS_DISCONNECTED right away.
+ */
+class CommandQueue
+{
+private:
+	struct COMMAND
+	{
+		std::function<int()> work;
+		GLOVE_COMPLETION_CALLBACK callback;
+		void* context;
+	};
+
+	std::deque<COMMAND> m_commands;
+	std::thread m_thread;
+	bool m_stop;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+
+	// Keeps Start from running while Stop joins the thread
+	std::mutex m_control_mutex;
+
+public:
+	CommandQueue();
+	~CommandQueue();
+
+	/*! Accept commands again after Stop. */
+	void Start();
+
+	/*! Queue a command, the thread is started on the first command. */
+	void Post(std::function<int()> work, GLOVE_COMPLETION_CALLBACK callback, void* context);
+
+	/*! \brief Stop the thread once the running command is done.
+	*
+	*  Commands that haven't started are completed with MANUS_DISCONNECTED,
+	*  and so are the ones posted until the next Start.
+	*/
+	void Stop();
+
+private:
+	void CommandThread();
+};
@@ -0,0 +1,154 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "FingerProfile.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define FINGER_DIVISOR 255.0f
+
+void FingerProfile::GetDefault(GLOVE_PROFILE* profile)
+{
+	for (int i = 0; i < GLOVE_FINGERS; i++)
+	{
+		profile->Minimum[i] = 0.0f;
+		profile->Maximum[i] = 1.0f;
+	}
+
+	for (int i = 0; i < GLOVE_PROFILE_POINTS; i++)
+		profile->Curve[i] = i / (GLOVE_PROFILE_POINTS - 1.0f);
+}
+
+bool FingerProfile::IsValid(const GLOVE_PROFILE& profile)
+{
+	for (int i = 0; i < GLOVE_FINGERS; i++)
+	{
+		if (!isfinite(profile.Minimum[i]) || !isfinite(profile.Maximum[i]) ||
+			profile.Minimum[i] == profile.Maximum[i])
+			return false;
+	}
+
+	for (int i = 0; i < GLOVE_PROFILE_POINTS; i++)
+	{
+		if (!isfinite(profile.Curve[i]))
+			return false;
+	}
+
+	return true;
+}
+
+static bool ReadValues(char* values, float* out, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		char* end;
+		out[i] = strtof(values, &end);
+		if (end == values)
+			return false;
+		values = end;
+	}
+
+	return true;
+}
+
+bool FingerProfile::Load(const char* path, GLOVE_PROFILE* profile)
+{
+	FILE* file = fopen(path, "r");
+	if (!file)
+		return false;
+
+	GLOVE_PROFILE result;
+	GetDefault(&result);
+
+	bool valid = true;
+	char line[512];
+	while (valid && fgets(line, sizeof(line), file))
+	{
+		char name[32];
+		int length = 0;
+		if (line[0] == '#' || sscanf(line, "%31s%n", name, &length) != 1)
+			continue;
+
+		char* values = line + length;
+		if (strcmp(name, "minimum") == 0)
+			valid = ReadValues(values, result.Minimum, GLOVE_FINGERS);
+		else if (strcmp(name, "maximum") == 0)
+			valid = ReadValues(values, result.Maximum, GLOVE_FINGERS);
+		else if (strcmp(name, "curve") == 0)
+			valid = ReadValues(values, result.Curve, GLOVE_PROFILE_POINTS);
+	}
+
+	fclose(file);
+
+	if (!valid || !IsValid(result))
+		return false;
+
+	*profile = result;
+	return true;
+}
+
+static void WriteValues(FILE* file, const char* name, const float* values, int count)
+{
+	fprintf(file, "%s", name);
+	for (int i = 0; i < count; i++)
+		fprintf(file, " %.6g", values[i]);
+	fprintf(file, "\n");
+}
+
+bool FingerProfile::Save(const char* path, const GLOVE_PROFILE& profile)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+
+	fprintf(file, "# Manus finger profile\n");
+	WriteValues(file, "minimum", profile.Minimum, GLOVE_FINGERS);
+	WriteValues(file, "maximum", profile.Maximum, GLOVE_FINGERS);
+	WriteValues(file, "curve", profile.Curve, GLOVE_PROFILE_POINTS);
+
+	return fclose(file) == 0;
+}
+
+void FingerProfile::BuildTables(const GLOVE_PROFILE& profile, float tables[GLOVE_FINGERS][FINGER_TABLE_SIZE])
+{
+	for (int i = 0; i < GLOVE_FINGERS; i++)
+	{
+		float range = profile.Maximum[i] - profile.Minimum[i];
+
+		for (int value = 0; value < FINGER_TABLE_SIZE; value++)
+		{
+			// Map the calibrated range to 0-1, a negative range inverts the sensor
+			float t = (value / FINGER_DIVISOR - profile.Minimum[i]) / range;
+			if (t < 0.0f) t = 0.0f;
+			if (t > 1.0f) t = 1.0f;
+
+			// Interpolate the response curve
+			float position = t * (GLOVE_PROFILE_POINTS - 1);
+			int point = (int)position;
+			if (point > GLOVE_PROFILE_POINTS - 2)
+				point = GLOVE_PROFILE_POINTS - 2;
+			float fraction = position - point;
+
+			tables[i][value] = profile.Curve[point] + (profile.Curve[point + 1] - profile.Curve[point]) * fraction;
+		}
+	}
+}
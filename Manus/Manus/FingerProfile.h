@@ -0,0 +1,59 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Glove.h"
+
+/*
+ * Host-side calibration profile of the finger sensors.
+ *
+ * A profile is compiled into a lookup table per finger so decoding a finger
+ * costs a single load, whatever the calibration and response curve.
+ *
+ * Profiles are stored as text, one line per field followed by the values:
+ *
+ *   minimum <5 floats>
+ *   maximum <5 floats>
+ *   curve   <GLOVE_PROFILE_POINTS floats>
+ *
+ * Fields that are missing keep their default values, lines starting with '#'
+ * are ignored.
+ */
+class FingerProfile
+{
+public:
+	/*! Get the profile of an uncalibrated glove, which is a linear response over the whole range. */
+	static void GetDefault(GLOVE_PROFILE* profile);
+
+	/*! Check that every finger has a range and all values are finite. */
+	static bool IsValid(const GLOVE_PROFILE& profile);
+
+	static bool Load(const char* path, GLOVE_PROFILE* profile);
+	static bool Save(const char* path, const GLOVE_PROFILE& profile);
+
+	/*! \brief Compile a profile into lookup tables.
+	*
+	*  \param tables Tables indexed by the raw finger value, one for each finger in hand order.
+	*/
+	static void BuildTables(const GLOVE_PROFILE& profile, float tables[GLOVE_FINGERS][FINGER_TABLE_SIZE]);
+
+private:
+	FingerProfile();
+};
@@ -0,0 +1,88 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "FrameResampler.h"
+
+FrameResampler::FrameResampler()
+{
+	m_history[GLOVE_LEFT].SetCapacity(RESAMPLER_CAPACITY);
+	m_history[GLOVE_RIGHT].SetCapacity(RESAMPLER_CAPACITY);
+}
+
+void FrameResampler::Push(const GLOVE_SAMPLE& sample)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_history[sample.hand].Push(sample.timestamp, sample.data, sample.position);
+	}
+	m_sample_block.notify_all();
+}
+
+void FrameResampler::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_history[GLOVE_LEFT].Clear();
+	m_history[GLOVE_RIGHT].Clear();
+}
+
+bool FrameResampler::IsComplete(uint64_t timestamp) const
+{
+	// Every hand that is still sending has a sample after the frame
+	for (const SampleHistory& history : m_history)
+	{
+		if (history.IsEmpty())
+			continue;
+
+		uint64_t newest = history.GetNewest().timestamp;
+		if (newest <= timestamp && newest + RESAMPLER_STALE_US > timestamp)
+			return false;
+	}
+
+	return true;
+}
+
+void FrameResampler::GetFrame(uint64_t timestamp, GLOVE_FRAME* frame, unsigned int timeout)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if (timeout > 0)
+	{
+		m_sample_block.wait_for(lock, std::chrono::milliseconds(timeout),
+			[this, timestamp] { return IsComplete(timestamp); });
+	}
+
+	frame->Time = timestamp;
+	frame->ValidHands = 0;
+
+	for (int hand = GLOVE_LEFT; hand <= GLOVE_RIGHT; hand++)
+	{
+		const SampleHistory& history = m_history[hand];
+		GLOVE_DATA& data = frame->Hands[hand];
+
+		if (history.IsEmpty() || history.GetNewest().timestamp + RESAMPLER_STALE_US <= timestamp ||
+			!history.Sample(timestamp, &data))
+		{
+			memset(&data, 0, sizeof(data));
+			continue;
+		}
+
+		frame->ValidHands |= 1 << hand;
+	}
+}
@@ -0,0 +1,64 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Glove.h"
+#include "SampleHistory.h"
+
+#include <condition_variable>
+#include <mutex>
+
+// Enough for a couple of seconds at the rate of the glove
+#define RESAMPLER_CAPACITY 256
+
+// A hand without samples for this long is left out of the frame
+#define RESAMPLER_STALE_US 250000
+
+/*
+ * Aligns the samples of both hands in time.
+ *
+ * The samples of each glove are kept in a short history, so a frame can be
+ * produced for any recent point in time by interpolating between the
+ * samples around it. Callers pick the times, which lets them resample at a
+ * fixed rate such as the display rate.
+ */
+class FrameResampler
+{
+private:
+	SampleHistory m_history[2];
+	std::mutex m_mutex;
+	std::condition_variable m_sample_block;
+
+public:
+	FrameResampler();
+
+	void Push(const GLOVE_SAMPLE& sample);
+	void Clear();
+
+	/*! \brief Produce a frame for both hands.
+	*
+	*  \param timeout Milliseconds to wait for samples after the time of the
+	*  frame, so it is interpolated instead of holding the last sample.
+	*/
+	void GetFrame(uint64_t timestamp, GLOVE_FRAME* frame, unsigned int timeout);
+
+private:
+	bool IsComplete(uint64_t timestamp) const;
+};
@@ -0,0 +1,248 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "GestureEngine.h"
+
+#include <math.h>
+#include <xmmintrin.h>
+
+#define PI 3.14159265358979f
+
+// Cosine that no angle can reach, used to disable the padding templates
+#define NEVER_COS 2.0f
+
+GestureEngine::GestureEngine()
+	: m_active(GLOVE_GESTURE_NONE)
+{
+}
+
+bool GestureEngine::Add(const GLOVE_GESTURE& gesture)
+{
+	if (gesture.Id == GLOVE_GESTURE_NONE)
+		return false;
+
+	for (int i = 0; i < 5; i++)
+	{
+		if (!(gesture.Fingers[i] >= 0.0f && gesture.Fingers[i] <= 1.0f) || !(gesture.Tolerance[i] > 0.0f))
+			return false;
+	}
+
+	const GLOVE_VECTOR& axis = gesture.Axis;
+	const GLOVE_VECTOR& direction = gesture.Direction;
+	bool constrained = axis.x != 0.0f || axis.y != 0.0f || axis.z != 0.0f;
+	if (constrained && (direction.x == 0.0f && direction.y == 0.0f && direction.z == 0.0f))
+		return false;
+	if (constrained && !(gesture.MaxAngle >= 0.0f))
+		return false;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_gestures.push_back(gesture);
+	Rebuild();
+
+	return true;
+}
+
+void GestureEngine::Remove(unsigned int id)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (size_t i = 0; i < m_gestures.size();)
+	{
+		if (id == GLOVE_GESTURE_NONE || m_gestures[i].Id == id)
+			m_gestures.erase(m_gestures.begin() + i);
+		else
+			i++;
+	}
+
+	Rebuild();
+
+	// A removed gesture stops without an end event, as no packet ended it
+	if (m_active != GLOVE_GESTURE_NONE && (id == GLOVE_GESTURE_NONE || id == m_active))
+		m_active = GLOVE_GESTURE_NONE;
+}
+
+unsigned int GestureEngine::GetActive()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_active;
+}
+
+bool GestureEngine::Poll(GLOVE_GESTURE_EVENT* event)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_events.empty())
+		return false;
+
+	*event = m_events.front();
+	m_events.pop_front();
+	return true;
+}
+
+void GestureEngine::Rebuild()
+{
+	// Pad to a multiple of four with templates that never match
+	size_t count = (m_gestures.size() + 3) & ~(size_t)3;
+
+	for (int i = 0; i < 5; i++)
+	{
+		m_target[i].assign(count, 0.0f);
+		m_scale[i].assign(count, 0.0f);
+	}
+	for (int i = 0; i < 9; i++)
+		m_constraint[i].assign(count, 0.0f);
+	m_enter_cos.assign(count, NEVER_COS);
+	m_release_cos.assign(count, NEVER_COS);
+	m_ids.assign(count, GLOVE_GESTURE_NONE);
+
+	for (size_t k = 0; k < m_gestures.size(); k++)
+	{
+		const GLOVE_GESTURE& gesture = m_gestures[k];
+
+		for (int i = 0; i < 5; i++)
+		{
+			m_target[i][k] = gesture.Fingers[i];
+			m_scale[i][k] = 1.0f / gesture.Tolerance[i];
+		}
+
+		m_ids[k] = gesture.Id;
+
+		const GLOVE_VECTOR& a = gesture.Axis;
+		const GLOVE_VECTOR& d = gesture.Direction;
+		float a_length = sqrtf(a.x * a.x + a.y * a.y + a.z * a.z);
+		if (a_length == 0.0f)
+		{
+			// Unconstrained, the dot product is always zero
+			m_enter_cos[k] = -1.0f;
+			m_release_cos[k] = -1.0f;
+			continue;
+		}
+
+		// The rotated axis is R * a, its cosine with d is the sum of R[j][i] * d[j] * a[i]
+		float d_length = sqrtf(d.x * d.x + d.y * d.y + d.z * d.z);
+		float axis[3] = { a.x / a_length, a.y / a_length, a.z / a_length };
+		float direction[3] = { d.x / d_length, d.y / d_length, d.z / d_length };
+		for (int j = 0; j < 3; j++)
+		{
+			for (int i = 0; i < 3; i++)
+				m_constraint[j * 3 + i][k] = direction[j] * axis[i];
+		}
+
+		float release = gesture.MaxAngle * GESTURE_RELEASE_SCALE;
+		m_enter_cos[k] = cosf(gesture.MaxAngle < PI ? gesture.MaxAngle : PI);
+		m_release_cos[k] = cosf(release < PI ? release : PI);
+	}
+}
+
+void GestureEngine::Emit(unsigned int id, GLOVE_GESTURE_EVENT_TYPE type, const GLOVE_SAMPLE& sample)
+{
+	if (m_events.size() >= GESTURE_EVENT_QUEUE)
+		m_events.pop_front();
+
+	GLOVE_GESTURE_EVENT event;
+	event.Id = id;
+	event.Type = type;
+	event.PacketNumber = sample.data.PacketNumber;
+	event.Timestamp = sample.timestamp;
+	m_events.push_back(event);
+}
+
+void GestureEngine::Process(const GLOVE_SAMPLE& sample)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_gestures.empty())
+		return;
+
+	const GLOVE_DATA& data = sample.data;
+	__m128 fingers[5];
+	for (int i = 0; i < 5; i++)
+		fingers[i] = _mm_set1_ps(data.Fingers[i]);
+
+	// Rotation matrix of the glove
+	float w = data.Quaternion.w, x = data.Quaternion.x, y = data.Quaternion.y, z = data.Quaternion.z;
+	float r[9] = {
+		1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y - w * z), 2.0f * (x * z + w * y),
+		2.0f * (x * y + w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z - w * x),
+		2.0f * (x * z - w * y), 2.0f * (y * z + w * x), 1.0f - 2.0f * (x * x + y * y),
+	};
+	__m128 rotation[9];
+	for (int i = 0; i < 9; i++)
+		rotation[i] = _mm_set1_ps(r[i]);
+
+	const __m128 enter_distance = _mm_set1_ps(1.0f);
+	const __m128 release_distance = _mm_set1_ps(GESTURE_RELEASE_SCALE * GESTURE_RELEASE_SCALE);
+
+	bool keep = false;
+	unsigned int nearest = GLOVE_GESTURE_NONE;
+	float nearest_distance = 0.0f;
+
+	for (size_t k = 0; k < m_ids.size(); k += 4)
+	{
+		__m128 distance = _mm_setzero_ps();
+		for (int i = 0; i < 5; i++)
+		{
+			__m128 delta = _mm_mul_ps(_mm_sub_ps(fingers[i], _mm_loadu_ps(&m_target[i][k])), _mm_loadu_ps(&m_scale[i][k]));
+			distance = _mm_add_ps(distance, _mm_mul_ps(delta, delta));
+		}
+
+		__m128 cosine = _mm_setzero_ps();
+		for (int i = 0; i < 9; i++)
+			cosine = _mm_add_ps(cosine, _mm_mul_ps(rotation[i], _mm_loadu_ps(&m_constraint[i][k])));
+
+		int enter = _mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(distance, enter_distance),
+			_mm_cmpge_ps(cosine, _mm_loadu_ps(&m_enter_cos[k]))));
+		int release = _mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(distance, release_distance),
+			_mm_cmpge_ps(cosine, _mm_loadu_ps(&m_release_cos[k]))));
+
+		if ((enter | release) == 0)
+			continue;
+
+		float distances[4];
+		_mm_storeu_ps(distances, distance);
+		for (int lane = 0; lane < 4; lane++)
+		{
+			unsigned int id = m_ids[k + lane];
+			if ((release >> lane) & 1 && id == m_active)
+				keep = true;
+
+			if ((enter >> lane) & 1 && (nearest == GLOVE_GESTURE_NONE || distances[lane] < nearest_distance))
+			{
+				nearest = id;
+				nearest_distance = distances[lane];
+			}
+		}
+	}
+
+	// The active gesture holds until the hand moves out of its release range
+	if (keep)
+		return;
+
+	if (nearest == m_active)
+		return;
+
+	if (m_active != GLOVE_GESTURE_NONE)
+		Emit(m_active, GLOVE_GESTURE_END, sample);
+	if (nearest != GLOVE_GESTURE_NONE)
+		Emit(nearest, GLOVE_GESTURE_BEGIN, sample);
+
+	m_active = nearest;
+}
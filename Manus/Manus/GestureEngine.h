@@ -0,0 +1,77 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Glove.h"
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// Number of events kept until they are polled
+#define GESTURE_EVENT_QUEUE 64
+
+// An active gesture ends when the hand is this much further away than the tolerance
+#define GESTURE_RELEASE_SCALE 1.2f
+
+/*
+ * Recognizes gestures in the samples of a single glove.
+ *
+ * The templates are kept as a structure of arrays, padded to a multiple
+ * of four, so each sample is matched against four templates at a time
+ * with SSE. The orientation constraint of a template is folded into a
+ * 3x3 matrix, which turns the angle test into a dot product with the
+ * rotation matrix of the glove.
+ */
+class GestureEngine
+{
+private:
+	std::vector<GLOVE_GESTURE> m_gestures;
+
+	// Templates as a structure of arrays
+	std::vector<float> m_target[5];
+	std::vector<float> m_scale[5];
+	std::vector<float> m_constraint[9];
+	std::vector<float> m_enter_cos;
+	std::vector<float> m_release_cos;
+	std::vector<unsigned int> m_ids;
+
+	unsigned int m_active;
+	std::deque<GLOVE_GESTURE_EVENT> m_events;
+
+	std::mutex m_mutex;
+
+public:
+	GestureEngine();
+
+	/*! \return False if the template is invalid. */
+	bool Add(const GLOVE_GESTURE& gesture);
+	void Remove(unsigned int id);
+
+	unsigned int GetActive();
+	bool Poll(GLOVE_GESTURE_EVENT* event);
+
+	/*! Match a sample and queue the events it causes. */
+	void Process(const GLOVE_SAMPLE& sample);
+
+private:
+	void Rebuild();
+	void Emit(unsigned int id, GLOVE_GESTURE_EVENT_TYPE type, const GLOVE_SAMPLE& sample);
+};
@@ -19,7 +19,12 @@
 
 #include "stdafx.h"
 #include "Glove.h"
+#include "Pipeline.h"
 #include "ManusMath.h"
+#include "FingerProfile.h"
+#include "Clock.h"
+#include "ThreadRegistry.h"
+#include "Trace.h"
 
 #include <limits>
 
@@ -27,7 +32,6 @@
 #define ACCEL_DIVISOR 16384.0f
 #define QUAT_DIVISOR 16384.0f
 #define COMPASS_DIVISOR 32.0f
-#define FINGER_DIVISOR 255.0f
 // magnetometer conversion values
 #define FUTPERCOUNT 0.3f; 
 #define FCOUNTSPERUT 3.333f;
@@ -35,13 +39,19 @@
 #define FGPERCOUNT 0.00006103515f; // 1 / ACCEL_DIVISOR
 
 
-Glove::Glove(const wchar_t* device_path)
+Glove::Glove(const wchar_t* device_path, std::function<void(const GLOVE_SAMPLE&)> sample_callback, Pipeline* pipeline)
 	: m_connected(false)
+	, m_simulated(false)
+	, m_flags(0)
+	, m_packets(0)
 	, m_service_handle(INVALID_HANDLE_VALUE)
 	, m_num_characteristics(0)
 	, m_characteristics(nullptr)
 	, m_event_handle(INVALID_HANDLE_VALUE)
 	, m_value_changed_event(nullptr)
+	, m_sample_callback(sample_callback)
+	, m_pipeline(pipeline)
+	, m_channel(nullptr)
 {
 	//memset(&m_report, 0, sizeof(m_report));
 
@@ -49,24 +59,77 @@ Glove::Glove(const wchar_t* device_path)
 	m_device_path = new wchar_t[len];
 	memcpy(m_device_path, device_path, len * sizeof(wchar_t));
 
+	memset(&m_data, 0, sizeof(m_data));
+	memset(&m_received, 0, sizeof(m_received));
+	memset(&m_position, 0, sizeof(m_position));
+	memset(&m_filtered, 0, sizeof(m_filtered));
+
+	FingerProfile::GetDefault(&m_profile);
+	UpdateTables();
+
+	// The channel has to exist before the first report arrives
+	if (m_pipeline)
+		m_channel = m_pipeline->Attach(this);
+
 	Connect();
 }
 
+Glove::Glove(GLOVE_HAND hand, std::function<void(const GLOVE_SAMPLE&)> sample_callback, Pipeline* pipeline)
+	: m_connected(true)
+	, m_simulated(true)
+	, m_flags(hand == GLOVE_RIGHT ? GLOVE_FLAGS_HANDEDNESS : 0)
+	, m_packets(0)
+	, m_service_handle(INVALID_HANDLE_VALUE)
+	, m_num_characteristics(0)
+	, m_characteristics(nullptr)
+	, m_event_handle(INVALID_HANDLE_VALUE)
+	, m_value_changed_event(nullptr)
+	, m_sample_callback(sample_callback)
+	, m_pipeline(pipeline)
+	, m_channel(nullptr)
+{
+	memset(&m_data, 0, sizeof(m_data));
+	memset(&m_received, 0, sizeof(m_received));
+	memset(&m_position, 0, sizeof(m_position));
+	memset(&m_filtered, 0, sizeof(m_filtered));
+	memset(&m_report, 0, sizeof(m_report));
+	memset(&m_calib, 0, sizeof(m_calib));
+
+	m_device_path = new wchar_t[1];
+	m_device_path[0] = L'\0';
+
+	FingerProfile::GetDefault(&m_profile);
+	UpdateTables();
+
+	if (m_pipeline)
+		m_channel = m_pipeline->Attach(this);
+}
+
 Glove::~Glove()
 {
 	Disconnect();
-	delete m_device_path;
+	if (m_channel)
+		m_pipeline->Detach(m_channel);
+	delete[] m_device_path;
 }
 
-bool Glove::GetData(GLOVE_DATA* data, unsigned int timeout)
+bool Glove::GetData(GLOVE_DATA* data, unsigned int timeout, bool filtered)
 {
+	TRACE_SCOPE_ARG("Glove::GetData", GetHand());
+
 	// Wait until the thread is done writing a packet
-	std::unique_lock<std::mutex> lk(m_report_mutex);
+	std::unique_lock<std::mutex> lk(m_report_mutex, std::defer_lock);
+	{
+		TRACE_SCOPE("Glove::GetData lock");
+		lk.lock();
+	}
 
 	// Optionally wait until the next package is sent
 	if (timeout > 0)
 	{
-		m_report_block.wait_for(lk, std::chrono::milliseconds(timeout));
+		unsigned int packets = m_packets;
+		m_report_block.wait_for(lk, std::chrono::milliseconds(timeout),
+			[&] { return m_packets != packets || !IsConnected(); });
 		if (!IsConnected())
 		{
 			lk.unlock();
@@ -74,7 +137,7 @@ bool Glove::GetData(GLOVE_DATA* data, unsigned int timeout)
 		}
 	}
 	
-	*data = m_data;
+	*data = filtered ? m_filtered : m_data;
 
 	lk.unlock();
 
@@ -83,9 +146,21 @@ bool Glove::GetData(GLOVE_DATA* data, unsigned int timeout)
 
 void Glove::Connect()
 {
+	if (m_simulated)
+	{
+		m_connected = true;
+		return;
+	}
+
 	if (IsConnected())
 		Disconnect();
 
+	// The time without a connection isn't lost reports
+	m_link.Reset();
+
+	// SetFlags and SetVibration look up the characteristics from other threads
+	std::unique_lock<std::shared_timed_mutex> connection(m_connection_mutex);
+
 	// Open the device using CreateFile().
 	m_service_handle = CreateFile(m_device_path,
 		FILE_GENERIC_READ | FILE_GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
@@ -137,15 +212,33 @@ void Glove::Connect()
 		// Register for event callbacks on the characteristics.
 		m_value_changed_event->NumCharacteristics = 1;
 		memcpy(&m_value_changed_event->Characteristics, m_characteristics, sizeof(BTH_LE_GATT_CHARACTERISTIC));
-		HRESULT hr = BluetoothGATTRegisterEvent(m_service_handle, CharacteristicValueChangedEvent, m_value_changed_event,
-			Glove::OnCharacteristicChanged, this, &m_event_handle, BLUETOOTH_GATT_FLAG_NONE);
 
+		// Register without the lock like Disconnect unregisters, the first callback may arrive before this returns
+		PBLUETOOTH_GATT_VALUE_CHANGED_EVENT_REGISTRATION registration = m_value_changed_event;
+		HANDLE service_handle = m_service_handle;
+		connection.unlock();
+
+		BLUETOOTH_GATT_EVENT_HANDLE event_handle = INVALID_HANDLE_VALUE;
+		HRESULT hr = BluetoothGATTRegisterEvent(service_handle, CharacteristicValueChangedEvent, registration,
+			Glove::OnCharacteristicChanged, this, &event_handle, BLUETOOTH_GATT_FLAG_NONE);
+
+		connection.lock();
+		if (SUCCEEDED(hr))
+			m_event_handle = event_handle;
 		m_connected = SUCCEEDED(hr);
 	}
+
+	connection.unlock();
+
+	// The finger order depends on the handedness that was just read
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+	UpdateTables();
 }
 
 bool Glove::ReadCharacteristic(PBTH_LE_GATT_CHARACTERISTIC characteristic, void* dest, size_t length)
 {
+	TRACE_SCOPE_ARG("Glove::ReadCharacteristic", GetHand());
+
 	// Query the required size for the structure.
 	USHORT required_size = 0;
 	BluetoothGATTGetCharacteristicValue(m_service_handle, characteristic, 0, nullptr,
@@ -153,7 +246,10 @@ bool Glove::ReadCharacteristic(PBTH_LE_GATT_CHARACTERISTIC characteristic, void*
 
 	// HRESULT will never be S_OK here, so just check the size.
 	if (required_size == 0)
+	{
+		m_link.ReadFailed();
 		return false;
+	}
 
 	// Allocate the characteristic value structure.
 	PBTH_LE_GATT_CHARACTERISTIC_VALUE value = (PBTH_LE_GATT_CHARACTERISTIC_VALUE)malloc(required_size);
@@ -167,6 +263,9 @@ bool Glove::ReadCharacteristic(PBTH_LE_GATT_CHARACTERISTIC characteristic, void*
 	if (SUCCEEDED(hr) && length >= value->DataSize)
 		memcpy(dest, &value->Data, value->DataSize);
 
+	if (FAILED(hr))
+		m_link.ReadFailed();
+
 	free(value);
 	return SUCCEEDED(hr);
 }
@@ -251,12 +350,20 @@ void Glove::Disconnect()
 {
 	m_connected = false;
 	m_report_block.notify_all();
+	m_link.Reset();
 
-	std::unique_lock<std::mutex> lk(m_report_mutex);
+	// Unregister without the lock, the stack may wait for a callback in flight that needs it
+	BLUETOOTH_GATT_EVENT_HANDLE event_handle;
+	{
+		std::unique_lock<std::shared_timed_mutex> lk(m_connection_mutex);
+		event_handle = m_event_handle;
+		m_event_handle = INVALID_HANDLE_VALUE;
+	}
+	if (event_handle != INVALID_HANDLE_VALUE)
+		BluetoothGATTUnregisterEvent(event_handle, BLUETOOTH_GATT_FLAG_NONE);
 
-	if (m_event_handle != INVALID_HANDLE_VALUE)
-		BluetoothGATTUnregisterEvent(m_event_handle, BLUETOOTH_GATT_FLAG_NONE);
-	m_event_handle = INVALID_HANDLE_VALUE;
+	// No callback can be reading from the device once the lock is ours
+	std::unique_lock<std::shared_timed_mutex> lk(m_connection_mutex);
 
 	if (m_value_changed_event != nullptr)
 		free(m_value_changed_event);
@@ -271,16 +378,38 @@ void Glove::Disconnect()
 	m_characteristics = nullptr;
 }
 
+void Glove::SetDevicePath(const wchar_t* device_path)
+{
+	if (m_simulated)
+		return;
+
+	size_t len = wcslen(device_path) + 1;
+	delete[] m_device_path;
+	m_device_path = new wchar_t[len];
+	memcpy(m_device_path, device_path, len * sizeof(wchar_t));
+}
+
 void Glove::OnCharacteristicChanged(BTH_LE_GATT_EVENT_TYPE event_type, void* event_out, void* context)
 {
 	Glove* glove = (Glove*)context;
 
+	// The callback threads belong to Windows, register each one the first time it delivers a
+	// packet so it is reported. The registry leaves its affinity and priority alone.
+	static thread_local ThreadScope thread_scope(GLOVE_THREAD_BLUETOOTH);
+
+	TRACE_SCOPE_ARG("Glove::OnCharacteristicChanged", glove->GetHand());
+
+	uint64_t timestamp = GetTimestamp();
+
+	// Keep Disconnect from freeing the registration and closing the handle during the read
+	std::shared_lock<std::shared_timed_mutex> connection(glove->m_connection_mutex);
+
 	// Normally we would get this parameter from event_out, but it looks like it is an invalid pointer.
 	// However it seems the event struct we allocated is being kept up-to-date, so we'll just use that.
 	PBLUETOOTH_GATT_VALUE_CHANGED_EVENT_REGISTRATION changed_event =
 		(PBLUETOOTH_GATT_VALUE_CHANGED_EVENT_REGISTRATION)glove->m_value_changed_event;
-
-	std::lock_guard<std::mutex> lk(glove->m_report_mutex);
+	if (!changed_event || glove->m_service_handle == INVALID_HANDLE_VALUE)
+		return;
 
 	// Read all characteristics we're monitoring.
 	for (int i = 0; i < changed_event->NumCharacteristics; i++)
@@ -288,11 +417,80 @@ void Glove::OnCharacteristicChanged(BTH_LE_GATT_EVENT_TYPE event_type, void* eve
 		PBTH_LE_GATT_CHARACTERISTIC characteristic = &changed_event->Characteristics[i];
 
 		if (characteristic->CharacteristicUuid.Value.ShortUuid == BLE_UUID_MANUS_GLOVE_REPORT)
-			glove->ReadCharacteristic(characteristic, &glove->m_report, sizeof(GLOVE_REPORT));
+		{
+			// Read outside of the report lock, readers only need to wait for the decode.
+			GLOVE_REPORT report;
+			if (glove->ReadCharacteristic(characteristic, &report, sizeof(GLOVE_REPORT)))
+				glove->ProcessReport(report, timestamp);
+		}
+	}
+}
+
+void Glove::ProcessReport(const GLOVE_REPORT& report, uint64_t timestamp)
+{
+	// Account for the report on the transport thread, before it is queued
+	m_link.Receive(timestamp, memcmp(&report, &m_received, sizeof(GLOVE_REPORT)) == 0);
+	m_received = report;
+
+	if (m_channel)
+	{
+		m_pipeline->Submit(*m_channel, report, timestamp);
+		return;
+	}
+
+	GLOVE_SAMPLE sample;
+	sample.report = report;
+	sample.timestamp = timestamp;
+
+	// Decode and filter under a single lock when both run on this thread
+	{
+		TRACE_SCOPE_ARG("Glove::ProcessReport", GetHand());
+		std::lock_guard<std::mutex> lk(m_report_mutex);
+
+		m_report = report;
+		UpdateState();
+		m_palm.Update(m_data, timestamp, &m_position);
+		m_filter.Apply(m_data, timestamp, &m_filtered);
+
+		sample.hand = GetHand();
+		sample.data = m_data;
+		sample.position = m_position;
+	}
+
+	Publish(sample);
+}
+
+void Glove::Decode(GLOVE_SAMPLE& sample)
+{
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+
+	m_report = sample.report;
+	UpdateState();
+	m_palm.Update(m_data, sample.timestamp, &m_position);
+
+	sample.hand = GetHand();
+	sample.data = m_data;
+	sample.position = m_position;
+}
+
+void Glove::Filter(const GLOVE_SAMPLE& sample)
+{
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+
+	m_filter.Apply(sample.data, sample.timestamp, &m_filtered);
+}
+
+void Glove::Publish(const GLOVE_SAMPLE& sample)
+{
+	{
+		std::lock_guard<std::mutex> lk(m_report_mutex);
+		m_packets++;
 	}
+	m_report_block.notify_all();
 
-	glove->UpdateState();
-	glove->m_report_block.notify_all();
+	// Publish the sample outside of the lock so readers aren't held up.
+	if (m_sample_callback)
+		m_sample_callback(sample);
 }
 
 void Glove::UpdateState()
@@ -302,6 +500,7 @@ void Glove::UpdateState()
 	m_data.Acceleration.x = m_report.accel[0] / ACCEL_DIVISOR;
 	m_data.Acceleration.y = m_report.accel[1] / ACCEL_DIVISOR;
 	m_data.Acceleration.z = m_report.accel[2] / ACCEL_DIVISOR;
+	m_imu.Apply(&m_data.Acceleration);
 
 	// normalize quaternion data
 	m_data.Quaternion.w = m_report.quat[0] / QUAT_DIVISOR;
@@ -309,15 +508,9 @@ void Glove::UpdateState()
 	m_data.Quaternion.y = m_report.quat[2] / QUAT_DIVISOR;
 	m_data.Quaternion.z = m_report.quat[3] / QUAT_DIVISOR;
 
-	// normalize finger data
+	// normalize finger data, the tables include the calibration and finger order
 	for (int i = 0; i < GLOVE_FINGERS; i++)
-	{
-		// account for finger order
-		if (GetHand() == GLOVE_RIGHT)
-			m_data.Fingers[i] = m_report.fingers[i] / FINGER_DIVISOR;
-		else
-			m_data.Fingers[i] = m_report.fingers[GLOVE_FINGERS - (i + 1)] / FINGER_DIVISOR;
-	}
+		m_data.Fingers[i] = m_finger_tables[i][m_report.fingers[m_finger_source[i]]];
 
 	// calculate the euler angles
 	ManusMath::GetEuler(&m_data.Euler, &m_data.Quaternion);
@@ -334,9 +527,15 @@ GLOVE_HAND Glove::GetHand(){
 
 void Glove::SetFlags(uint8_t flags)
 {
-	m_flags = flags;
+	{
+		std::lock_guard<std::mutex> lk(m_report_mutex);
+		m_flags = flags;
+		UpdateTables();
+	}
 
-	WriteCharacteristic(GetCharacteristic(BLE_UUID_MANUS_GLOVE_FLAGS), &m_flags, sizeof(m_flags));
+	// Rebalancing disconnects the glove at any time, which frees the characteristics
+	std::shared_lock<std::shared_timed_mutex> connection(m_connection_mutex);
+	WriteCharacteristic(GetCharacteristic(BLE_UUID_MANUS_GLOVE_FLAGS), &flags, sizeof(flags));
 }
 
 void Glove::SetVibration(float power)
@@ -349,5 +548,106 @@ void Glove::SetVibration(float power)
 
 	report.value = uint16_t(power * std::numeric_limits<uint16_t>::max());
 
+	std::shared_lock<std::shared_timed_mutex> connection(m_connection_mutex);
 	WriteCharacteristic(GetCharacteristic(BLE_UUID_MANUS_GLOVE_RUMBLE), &report, sizeof(report));
 }
+
+void Glove::GetProfile(GLOVE_PROFILE* profile)
+{
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+	*profile = m_profile;
+}
+
+void Glove::SetProfile(const GLOVE_PROFILE& profile)
+{
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+	m_profile = profile;
+	UpdateTables();
+}
+
+void Glove::UpdateTables()
+{
+	FingerProfile::BuildTables(m_profile, m_finger_tables);
+
+	// The left glove reports the fingers in reverse order
+	for (int i = 0; i < GLOVE_FINGERS; i++)
+		m_finger_source[i] = GetHand() == GLOVE_RIGHT ? i : GLOVE_FINGERS - (i + 1);
+}
+
+void Glove::GetFilter(GLOVE_FILTER* filter)
+{
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+	*filter = m_filter.GetParameters();
+}
+
+void Glove::SetFilter(const GLOVE_FILTER& filter)
+{
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+	m_filter.SetParameters(filter);
+}
+
+void Glove::GetLinkStats(GLOVE_LINK_STATS* stats) const
+{
+	m_link.Get(GetTimestamp(), stats);
+}
+
+void Glove::GetPalmTracking(GLOVE_PALM_TRACKING* tracking)
+{
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+	*tracking = m_palm.GetParameters();
+}
+
+void Glove::SetPalmTracking(const GLOVE_PALM_TRACKING& tracking)
+{
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+	m_palm.SetParameters(tracking);
+}
+
+void Glove::GetPalmPosition(GLOVE_VECTOR* position)
+{
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+	*position = m_position;
+}
+
+void Glove::ResetPalmPosition()
+{
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+	m_palm.Reset();
+	memset(&m_position, 0, sizeof(m_position));
+}
+
+void Glove::StartImuCalibration()
+{
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+	m_imu.Start();
+}
+
+void Glove::StopImuCalibration()
+{
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+	m_imu.Stop();
+}
+
+bool Glove::SolveImuCalibration(GLOVE_IMU_CALIBRATION_STATUS* status, GLOVE_IMU_CALIBRATION* fit)
+{
+	// Solve outside of the lock so the decoder isn't held up
+	ImuCalibration snapshot;
+	{
+		std::lock_guard<std::mutex> lk(m_report_mutex);
+		snapshot = m_imu;
+	}
+
+	return snapshot.Solve(fit, status);
+}
+
+void Glove::GetImuCalibration(GLOVE_IMU_CALIBRATION* calibration)
+{
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+	*calibration = m_imu.GetCorrection();
+}
+
+void Glove::SetImuCalibration(const GLOVE_IMU_CALIBRATION& calibration)
+{
+	std::lock_guard<std::mutex> lk(m_report_mutex);
+	m_imu.SetCorrection(calibration);
+}
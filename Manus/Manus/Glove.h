@@ -20,9 +20,15 @@
 #pragma once
 
 #include "Manus.h"
+#include "GloveFilter.h"
+#include "ImuCalibration.h"
+#include "LinkStats.h"
+#include "PalmTracker.h"
 
 #include <condition_variable>
+#include <functional>
 #include <mutex>
+#include <shared_mutex>
 #include <inttypes.h>
 
 // flag for handedness (0 = left, 1 = right)
@@ -35,6 +41,9 @@
 #define GLOVE_QUATS     4
 #define GLOVE_FINGERS   5
 
+// One entry for every value of the finger byte in the glove report
+#define FINGER_TABLE_SIZE 256
+
 #define BLE_UUID_MANUS_GLOVE_SERVICE    0x0001
 #define BLE_UUID_MANUS_GLOVE_REPORT     0x0002
 #define BLE_UUID_MANUS_GLOVE_FLAGS      0x0004
@@ -64,17 +73,49 @@ typedef struct
 } RUMBLE_REPORT;
 #pragma pack(pop) //back to whatever the previous packing mode was
 
+/*! Decoded glove data together with the report it was decoded from. */
+typedef struct
+{
+	GLOVE_HAND hand;
+	GLOVE_DATA data;
+	GLOVE_REPORT report;
+	// Time of arrival on the SDK clock in microseconds.
+	uint64_t timestamp;
+	// Position of the palm in meters, zero when it isn't tracked.
+	GLOVE_VECTOR position;
+} GLOVE_SAMPLE;
+
+class Pipeline;
+struct PipelineChannel;
+
 class Glove
 {
 private:
 	bool m_connected;
+	bool m_simulated;
 	uint8_t m_flags;
 
 	GLOVE_DATA m_data;
+	GLOVE_DATA m_filtered;
+	GloveFilter m_filter;
+	ImuCalibration m_imu;
+	PalmTracker m_palm;
+	GLOVE_VECTOR m_position;
+
+	// Samples published so far, lets a waiting reader tell a new sample from a spurious wakeup
 	unsigned int m_packets;
 	GLOVE_REPORT m_report;
 	CALIB_REPORT m_calib;
 
+	// Link quality, the last report received is only touched by the transport
+	LinkStats m_link;
+	GLOVE_REPORT m_received;
+
+	// Decode tables compiled from the profile, in hand order
+	GLOVE_PROFILE m_profile;
+	float m_finger_tables[GLOVE_FINGERS][FINGER_TABLE_SIZE];
+	uint8_t m_finger_source[GLOVE_FINGERS];
+
 	wchar_t* m_device_path;
 
 	HANDLE m_service_handle;
@@ -84,21 +125,84 @@ private:
 	PBLUETOOTH_GATT_VALUE_CHANGED_EVENT_REGISTRATION m_value_changed_event;
 
 	std::mutex m_report_mutex;
+
+	// Held shared by the notification callback and the writes while they use the
+	// device, Connect and Disconnect take it exclusively to change the handles
+	std::shared_timed_mutex m_connection_mutex;
 	std::condition_variable m_report_block;
 
+	std::function<void(const GLOVE_SAMPLE&)> m_sample_callback;
+
+	Pipeline* m_pipeline;
+	PipelineChannel* m_channel;
+
 public:
-	Glove(const wchar_t* device_path);
+	Glove(const wchar_t* device_path, std::function<void(const GLOVE_SAMPLE&)> sample_callback = nullptr,
+		Pipeline* pipeline = nullptr);
+
+	/*! \brief Create a simulated glove that isn't backed by a device.
+	*
+	*  The glove is always connected and only receives reports through ProcessReport.
+	*/
+	Glove(GLOVE_HAND hand, std::function<void(const GLOVE_SAMPLE&)> sample_callback = nullptr,
+		Pipeline* pipeline = nullptr);
 	~Glove();
 
 	void Connect();
 	void Disconnect();
 	bool IsConnected() const { return m_connected; }
 	const wchar_t* GetDevicePath() const { return m_device_path; }
-	bool GetData(GLOVE_DATA* data, unsigned int timeout);
+
+	/*! \brief Change the device interface the glove connects through.
+	*
+	*  A glove that is paired with several adapters has a device interface
+	*  for each of them. The path takes effect on the next Connect.
+	*/
+	void SetDevicePath(const wchar_t* device_path);
+
+	bool GetData(GLOVE_DATA* data, unsigned int timeout, bool filtered = false);
 	uint8_t GetFlags();
 	void SetFlags(uint8_t flags);
 	void SetVibration(float power);
 	GLOVE_HAND GetHand();
+	void GetProfile(GLOVE_PROFILE* profile);
+	void SetProfile(const GLOVE_PROFILE& profile);
+	void GetFilter(GLOVE_FILTER* filter);
+	void SetFilter(const GLOVE_FILTER& filter);
+
+	void StartImuCalibration();
+	void StopImuCalibration();
+
+	/*! Solve the accelerometer calibration on a copy of the samples collected so far. */
+	bool SolveImuCalibration(GLOVE_IMU_CALIBRATION_STATUS* status, GLOVE_IMU_CALIBRATION* fit);
+
+	void GetImuCalibration(GLOVE_IMU_CALIBRATION* calibration);
+	void SetImuCalibration(const GLOVE_IMU_CALIBRATION& calibration);
+
+	void GetLinkStats(GLOVE_LINK_STATS* stats) const;
+
+	void GetPalmTracking(GLOVE_PALM_TRACKING* tracking);
+	void SetPalmTracking(const GLOVE_PALM_TRACKING& tracking);
+	void GetPalmPosition(GLOVE_VECTOR* position);
+	void ResetPalmPosition();
+
+	/*! \brief Update the glove with a report as if it was received from the device.
+	*
+	*  The report goes through the pipeline when the glove has one,
+	*  otherwise every stage runs on the calling thread.
+	*
+	*  \param timestamp Time of arrival on the SDK clock.
+	*/
+	void ProcessReport(const GLOVE_REPORT& report, uint64_t timestamp);
+
+	/*! Decode the report of a sample and fill in its hand and data. */
+	void Decode(GLOVE_SAMPLE& sample);
+
+	/*! Update the filtered data with a decoded sample. */
+	void Filter(const GLOVE_SAMPLE& sample);
+
+	/*! Wake up waiting readers and pass the sample to the callback. */
+	void Publish(const GLOVE_SAMPLE& sample);
 
 private:
 	static void OnCharacteristicChanged(BTH_LE_GATT_EVENT_TYPE event_type, void* event_out, void* context);
@@ -109,4 +213,5 @@ private:
 
 	static void QuatToEuler(GLOVE_VECTOR* v, const GLOVE_QUATERNION* q);
 	void UpdateState();
+	void UpdateTables();
 };
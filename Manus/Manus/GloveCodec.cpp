@@ -0,0 +1,402 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "GloveCodec.h"
+
+#include <stddef.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define BLOCK_HEADER_SIZE 12
+#define CHANNEL_HEADER_SIZE 6
+
+// Quotients this large are followed by the raw 64-bit value instead
+#define RICE_ESCAPE 24
+#define RICE_MAX_K 31
+
+// Highest predictor order, order 2 extrapolates linearly from the last two samples
+#define MAX_ORDER 2
+
+static inline int CountTrailingZeros(uint64_t value)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index;
+	_BitScanForward64(&index, value);
+	return (int)index;
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if (_BitScanForward(&index, (uint32_t)value))
+		return (int)index;
+	_BitScanForward(&index, (uint32_t)(value >> 32));
+	return (int)index + 32;
+#else
+	return __builtin_ctzll(value);
+#endif
+}
+
+static inline uint64_t ZigZag(int64_t value)
+{
+	return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t UnZigZag(uint64_t value)
+{
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static inline int64_t Predict(int order, int64_t prev1, int64_t prev2)
+{
+	switch (order)
+	{
+	case 0: return 0;
+	case 1: return prev1;
+	default: return 2 * prev1 - prev2;
+	}
+}
+
+static void WriteU32(std::vector<uint8_t>& output, size_t offset, uint32_t value)
+{
+	for (int i = 0; i < 4; i++)
+		output[offset + i] = (uint8_t)(value >> (i * 8));
+}
+
+static uint32_t ReadU32(const uint8_t* data)
+{
+	return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+// Bits are written least significant first, so a reader can find the end
+// of a unary code by counting trailing zeros.
+class BitWriter
+{
+private:
+	std::vector<uint8_t>& m_output;
+	uint64_t m_buffer;
+	int m_bits;
+
+public:
+	BitWriter(std::vector<uint8_t>& output) : m_output(output), m_buffer(0), m_bits(0) {}
+
+	void Write(uint64_t value, int bits)
+	{
+		m_buffer |= value << m_bits;
+		m_bits += bits;
+		while (m_bits >= 8)
+		{
+			m_output.push_back((uint8_t)m_buffer);
+			m_buffer >>= 8;
+			m_bits -= 8;
+		}
+	}
+
+	void WriteRice(uint64_t value, int k)
+	{
+		uint64_t quotient = value >> k;
+		if (quotient < RICE_ESCAPE)
+		{
+			Write(1ull << quotient, (int)quotient + 1);
+			Write(value & ((1ull << k) - 1), k);
+		}
+		else
+		{
+			Write(1ull << RICE_ESCAPE, RICE_ESCAPE + 1);
+			Write(value & 0xFFFFFFFF, 32);
+			Write(value >> 32, 32);
+		}
+	}
+
+	void Flush()
+	{
+		if (m_bits > 0)
+			m_output.push_back((uint8_t)m_buffer);
+		m_buffer = 0;
+		m_bits = 0;
+	}
+};
+
+class BitReader
+{
+private:
+	const uint8_t* m_data;
+	const uint8_t* m_end;
+	uint64_t m_buffer;
+	int m_bits;
+
+	void Refill()
+	{
+		if (m_end - m_data >= 8)
+		{
+			// Load a whole word and only advance by the bytes that fit
+			uint64_t word;
+			memcpy(&word, m_data, sizeof(word));
+			m_buffer |= word << m_bits;
+			m_data += (63 - m_bits) >> 3;
+			m_bits |= 56;
+		}
+		else
+		{
+			while (m_bits <= 56 && m_data < m_end)
+			{
+				m_buffer |= (uint64_t)*m_data++ << m_bits;
+				m_bits += 8;
+			}
+		}
+	}
+
+	uint64_t Read(int bits)
+	{
+		uint64_t value = m_buffer & ((1ull << bits) - 1);
+		m_buffer >>= bits;
+		m_bits -= bits;
+		return value;
+	}
+
+public:
+	BitReader(const uint8_t* data, size_t length) : m_data(data), m_end(data + length), m_buffer(0), m_bits(0) {}
+
+	bool ReadRice(int k, uint64_t* value)
+	{
+		// A code without escape is at most 56 bits, so one refill is enough
+		Refill();
+		if (m_buffer == 0)
+			return false;
+
+		int quotient = CountTrailingZeros(m_buffer);
+		if (quotient < RICE_ESCAPE)
+		{
+			int length = quotient + 1 + k;
+			if (length > m_bits)
+				return false;
+
+			*value = ((uint64_t)quotient << k) | ((m_buffer >> (quotient + 1)) & ((1ull << k) - 1));
+			m_buffer >>= length;
+			m_bits -= length;
+			return true;
+		}
+
+		if (quotient > RICE_ESCAPE || quotient + 1 > m_bits)
+			return false;
+		Read(quotient + 1);
+
+		Refill();
+		if (m_bits < 32)
+			return false;
+		uint64_t low = Read(32);
+		Refill();
+		if (m_bits < 32)
+			return false;
+		*value = low | (Read(32) << 32);
+
+		return true;
+	}
+};
+
+static int64_t GetChannel(const GLOVE_RECORD& record, int channel)
+{
+	if (channel == 0)
+		return (int64_t)record.timestamp;
+	channel -= 1;
+	if (channel < GLOVE_QUATS)
+		return record.report.quat[channel];
+	channel -= GLOVE_QUATS;
+	if (channel < GLOVE_AXES)
+		return record.report.accel[channel];
+	return record.report.fingers[channel - GLOVE_AXES];
+}
+
+// Decode the values of one channel straight into the records.
+template<typename T>
+static bool DecodeChannel(BitReader& reader, int order, int k, GLOVE_RECORD* records, size_t count, size_t offset)
+{
+	uint8_t* dest = (uint8_t*)records + offset;
+
+	// Written as weights so the loop doesn't branch on the order
+	const int64_t weight1 = order > 0 ? order : 0;
+	const int64_t weight2 = order > 1 ? -1 : 0;
+
+	int64_t prev1 = 0, prev2 = 0;
+	for (size_t i = 0; i < count; i++, dest += sizeof(GLOVE_RECORD))
+	{
+		uint64_t residual;
+		if (!reader.ReadRice(k, &residual))
+			return false;
+
+		int64_t value = weight1 * prev1 + weight2 * prev2 + UnZigZag(residual);
+		T field = (T)value;
+		memcpy(dest, &field, sizeof(T));
+		prev2 = prev1;
+		prev1 = value;
+	}
+	return true;
+}
+
+// Cost in bits of Rice coding the values with parameter k.
+static uint64_t RiceCost(const std::vector<uint64_t>& values, int k)
+{
+	uint64_t cost = 0;
+	for (uint64_t value : values)
+	{
+		uint64_t quotient = value >> k;
+		cost += quotient < RICE_ESCAPE ? quotient + 1 + k : RICE_ESCAPE + 1 + 64;
+	}
+	return cost;
+}
+
+void GloveCodec::EncodeBlock(const GLOVE_RECORD* records, size_t count, std::vector<uint8_t>& output)
+{
+	if (count > CODEC_BLOCK_SAMPLES)
+		count = CODEC_BLOCK_SAMPLES;
+
+	size_t block = output.size();
+	output.resize(block + BLOCK_HEADER_SIZE + CODEC_CHANNELS * CHANNEL_HEADER_SIZE);
+	WriteU32(output, block, CODEC_BLOCK_MAGIC);
+	WriteU32(output, block + 4, (uint32_t)count);
+
+	std::vector<int64_t> values(count);
+	std::vector<uint64_t> residuals[MAX_ORDER + 1];
+
+	for (int channel = 0; channel < CODEC_CHANNELS; channel++)
+	{
+		for (size_t i = 0; i < count; i++)
+			values[i] = GetChannel(records[i], channel);
+
+		// Try every predictor and keep the one with the smallest residuals
+		int order = 0;
+		uint64_t best = UINT64_MAX;
+		for (int o = 0; o <= MAX_ORDER; o++)
+		{
+			residuals[o].resize(count);
+
+			uint64_t sum = 0;
+			int64_t prev1 = 0, prev2 = 0;
+			for (size_t i = 0; i < count; i++)
+			{
+				residuals[o][i] = ZigZag(values[i] - Predict(o, prev1, prev2));
+
+				// The first residuals hold the raw values, which would
+				// favour the lower orders no matter how the signal moves
+				if (i >= MAX_ORDER)
+					sum += residuals[o][i] >> 1;
+				prev2 = prev1;
+				prev1 = values[i];
+			}
+
+			if (sum < best)
+			{
+				best = sum;
+				order = o;
+			}
+		}
+
+		// Try every parameter. Escaped values flatten the cost for small
+		// parameters and the first residuals are the raw values, so neither
+		// the mean nor a local search finds the best one reliably.
+		int k = 0;
+		uint64_t cost = UINT64_MAX;
+		for (int candidate = 0; candidate <= RICE_MAX_K; candidate++)
+		{
+			uint64_t candidate_cost = RiceCost(residuals[order], candidate);
+			if (candidate_cost < cost)
+			{
+				cost = candidate_cost;
+				k = candidate;
+			}
+		}
+
+		size_t stream = output.size();
+		BitWriter writer(output);
+		for (uint64_t residual : residuals[order])
+			writer.WriteRice(residual, k);
+		writer.Flush();
+
+		size_t header = block + BLOCK_HEADER_SIZE + channel * CHANNEL_HEADER_SIZE;
+		output[header] = (uint8_t)order;
+		output[header + 1] = (uint8_t)k;
+		WriteU32(output, header + 2, (uint32_t)(output.size() - stream));
+	}
+
+	WriteU32(output, block + 8, (uint32_t)(output.size() - block - BLOCK_HEADER_SIZE));
+}
+
+size_t GloveCodec::GetBlockSize(const uint8_t* data, size_t length)
+{
+	if (length < BLOCK_HEADER_SIZE || ReadU32(data) != CODEC_BLOCK_MAGIC)
+		return 0;
+
+	size_t size = BLOCK_HEADER_SIZE + (size_t)ReadU32(data + 8);
+	return size <= length && size <= CODEC_MAX_BLOCK_SIZE ? size : 0;
+}
+
+bool GloveCodec::DecodeBlock(const uint8_t* data, size_t length, std::vector<GLOVE_RECORD>& output)
+{
+	size_t size = GetBlockSize(data, length);
+	if (size < BLOCK_HEADER_SIZE + CODEC_CHANNELS * CHANNEL_HEADER_SIZE)
+		return false;
+
+	size_t count = ReadU32(data + 4);
+	if (count > CODEC_BLOCK_SAMPLES)
+		return false;
+
+	size_t first = output.size();
+	output.resize(first + count);
+	GLOVE_RECORD* records = &output[first];
+
+	const uint8_t* header = data + BLOCK_HEADER_SIZE;
+	const uint8_t* stream = header + CODEC_CHANNELS * CHANNEL_HEADER_SIZE;
+	const uint8_t* end = data + size;
+
+	for (int channel = 0; channel < CODEC_CHANNELS; channel++, header += CHANNEL_HEADER_SIZE)
+	{
+		int order = header[0];
+		int k = header[1];
+		size_t stream_size = ReadU32(header + 2);
+		if (order > MAX_ORDER || k > RICE_MAX_K || stream_size > (size_t)(end - stream))
+		{
+			output.resize(first);
+			return false;
+		}
+
+		BitReader reader(stream, stream_size);
+		bool decoded;
+		if (channel == 0)
+			decoded = DecodeChannel<uint64_t>(reader, order, k, records, count, offsetof(GLOVE_RECORD, timestamp));
+		else if (channel <= GLOVE_QUATS)
+			decoded = DecodeChannel<int16_t>(reader, order, k, records, count,
+				offsetof(GLOVE_RECORD, report) + offsetof(GLOVE_REPORT, quat) + (channel - 1) * sizeof(int16_t));
+		else if (channel <= GLOVE_QUATS + GLOVE_AXES)
+			decoded = DecodeChannel<int16_t>(reader, order, k, records, count,
+				offsetof(GLOVE_RECORD, report) + offsetof(GLOVE_REPORT, accel) + (channel - 1 - GLOVE_QUATS) * sizeof(int16_t));
+		else
+			decoded = DecodeChannel<uint8_t>(reader, order, k, records, count,
+				offsetof(GLOVE_RECORD, report) + offsetof(GLOVE_REPORT, fingers) + (channel - 1 - GLOVE_QUATS - GLOVE_AXES));
+
+		if (!decoded)
+		{
+			output.resize(first);
+			return false;
+		}
+
+		stream += stream_size;
+	}
+
+	return true;
+}
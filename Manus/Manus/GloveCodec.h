@@ -0,0 +1,86 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Glove.h"
+
+#include <vector>
+
+#define CODEC_BLOCK_MAGIC   0x4B424E4D // "MNBK"
+#define CODEC_BLOCK_SAMPLES 1024
+
+// Timestamp, four quaternion, three acceleration and five finger channels
+#define CODEC_CHANNELS      (1 + GLOVE_QUATS + GLOVE_AXES + GLOVE_FINGERS)
+
+// Upper bound of an encoded block, an escaped value takes 89 bits
+#define CODEC_MAX_BLOCK_SIZE (12 + CODEC_CHANNELS * (6 + CODEC_BLOCK_SAMPLES * 12))
+
+/*! A raw report as received from the glove. */
+typedef struct
+{
+	uint64_t timestamp;
+	GLOVE_REPORT report;
+} GLOVE_RECORD;
+
+/*
+ * Lossless codec for blocks of glove reports.
+ *
+ * Every block can be decoded on its own, which allows a recording to be
+ * decoded in parallel. Within a block each channel is stored separately:
+ * the value is predicted from the previous samples, and the residual is
+ * zigzag mapped and Rice coded with a parameter chosen for that channel.
+ *
+ * Block layout, all fields little-endian:
+ *
+ *   uint32  magic
+ *   uint32  number of samples
+ *   uint32  size of the rest of the block in bytes
+ *   per channel:
+ *     uint8   predictor order
+ *     uint8   Rice parameter
+ *     uint32  size of the bit stream in bytes
+ *   the bit streams of every channel
+ */
+class GloveCodec
+{
+public:
+	/*! \brief Encode a block of at most CODEC_BLOCK_SAMPLES records.
+	*
+	*  The encoded block is appended to the output.
+	*/
+	static void EncodeBlock(const GLOVE_RECORD* records, size_t count, std::vector<uint8_t>& output);
+
+	/*! \brief Read the size of a block from its header.
+	*
+	*  \return The total size of the block in bytes, or zero if there is no valid block.
+	*/
+	static size_t GetBlockSize(const uint8_t* data, size_t length);
+
+	/*! \brief Decode a single block.
+	*
+	*  The decoded records are appended to the output.
+	*
+	*  \return False if the block is corrupt.
+	*/
+	static bool DecodeBlock(const uint8_t* data, size_t length, std::vector<GLOVE_RECORD>& output);
+
+private:
+	GloveCodec();
+};
@@ -0,0 +1,140 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "GloveFilter.h"
+#include "ManusMath.h"
+
+#include <emmintrin.h>
+#include <math.h>
+#include <string.h>
+
+#define FILTER_PI 3.14159265f
+
+// Cutoff for the speed estimate, as in the One Euro paper
+#define SPEED_CUTOFF 1.0f
+
+// Used when the timestamps don't advance, the rate of the glove
+#define NOMINAL_INTERVAL 0.01f
+
+// Start over after a gap, the old state has nothing to do with the new sample
+#define MAX_INTERVAL 0.5f
+
+// Smoothing factor of an exponential filter with the given cutoff in Hz
+static float GetAlpha(float cutoff, float interval)
+{
+	float r = 2.0f * FILTER_PI * cutoff * interval;
+	return r / (1.0f + r);
+}
+
+static __m128 GetAlpha(__m128 cutoff, __m128 interval)
+{
+	__m128 r = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(2.0f * FILTER_PI), cutoff), interval);
+	return _mm_div_ps(r, _mm_add_ps(_mm_set1_ps(1.0f), r));
+}
+
+GloveFilter::GloveFilter()
+{
+	GetDefault(&m_parameters);
+	Reset();
+}
+
+void GloveFilter::GetDefault(GLOVE_FILTER* parameters)
+{
+	parameters->FingerMinCutoff = 1.5f;
+	parameters->FingerBeta = 5.0f;
+	parameters->OrientationMinCutoff = 1.5f;
+	parameters->OrientationBeta = 2.0f;
+}
+
+void GloveFilter::SetParameters(const GLOVE_FILTER& parameters)
+{
+	m_parameters = parameters;
+}
+
+void GloveFilter::Reset()
+{
+	m_initialized = false;
+	m_timestamp = 0;
+	memset(m_fingers, 0, sizeof(m_fingers));
+	memset(m_finger_speed, 0, sizeof(m_finger_speed));
+	m_angular_speed = 0.0f;
+}
+
+void GloveFilter::Apply(const GLOVE_DATA& data, uint64_t timestamp, GLOVE_DATA* filtered)
+{
+	float interval = m_initialized && timestamp > m_timestamp ?
+		(timestamp - m_timestamp) / 1000000.0f : NOMINAL_INTERVAL;
+	m_timestamp = timestamp;
+
+	if (!m_initialized || interval > MAX_INTERVAL)
+	{
+		memcpy(m_fingers, data.Fingers, sizeof(data.Fingers));
+		memset(m_finger_speed, 0, sizeof(m_finger_speed));
+		m_orientation = data.Quaternion;
+		m_angular_speed = 0.0f;
+		m_initialized = true;
+
+		*filtered = data;
+		return;
+	}
+
+	// Fingers, one SSE vector of four lanes at a time over all FILTER_LANES
+	float input[FILTER_LANES] = { 0 };
+	memcpy(input, data.Fingers, sizeof(data.Fingers));
+
+	__m128 dt = _mm_set1_ps(interval);
+	__m128 speed_alpha = _mm_set1_ps(GetAlpha(SPEED_CUTOFF, interval));
+	__m128 min_cutoff = _mm_set1_ps(m_parameters.FingerMinCutoff);
+	__m128 beta = _mm_set1_ps(m_parameters.FingerBeta);
+	__m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+	for (int i = 0; i < FILTER_LANES; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(input + i);
+		__m128 prev = _mm_loadu_ps(m_fingers + i);
+		__m128 prev_speed = _mm_loadu_ps(m_finger_speed + i);
+
+		// Smoothed speed of the signal
+		__m128 speed = _mm_div_ps(_mm_sub_ps(x, prev), dt);
+		speed = _mm_add_ps(prev_speed, _mm_mul_ps(speed_alpha, _mm_sub_ps(speed, prev_speed)));
+
+		// Raise the cutoff with the speed
+		__m128 cutoff = _mm_add_ps(min_cutoff, _mm_mul_ps(beta, _mm_and_ps(speed, abs_mask)));
+		__m128 alpha = GetAlpha(cutoff, dt);
+		__m128 result = _mm_add_ps(prev, _mm_mul_ps(alpha, _mm_sub_ps(x, prev)));
+
+		_mm_storeu_ps(m_fingers + i, result);
+		_mm_storeu_ps(m_finger_speed + i, speed);
+	}
+
+	// Orientation, the speed is the angle between the filtered and new orientation
+	const GLOVE_QUATERNION& q = data.Quaternion;
+	float dot = fabsf(m_orientation.w * q.w + m_orientation.x * q.x + m_orientation.y * q.y + m_orientation.z * q.z);
+	float angle = 2.0f * acosf(dot < 1.0f ? dot : 1.0f);
+
+	m_angular_speed += GetAlpha(SPEED_CUTOFF, interval) * (angle / interval - m_angular_speed);
+	float cutoff = m_parameters.OrientationMinCutoff + m_parameters.OrientationBeta * m_angular_speed;
+	m_orientation = ManusMath::QuaternionSlerp(m_orientation, q, GetAlpha(cutoff, interval));
+
+	*filtered = data;
+	memcpy(filtered->Fingers, m_fingers, sizeof(filtered->Fingers));
+	filtered->Quaternion = m_orientation;
+	ManusMath::GetEuler(&filtered->Euler, &filtered->Quaternion);
+}
@@ -0,0 +1,68 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Manus.h"
+
+#include <inttypes.h>
+
+// The five fingers padded to two SSE vectors of four lanes
+#define FILTER_LANES 8
+
+/*
+ * Adaptive low-pass filter for the glove data, based on the One Euro filter.
+ *
+ * The cutoff frequency rises with the speed of the signal, so slow movements
+ * are smoothed heavily while fast movements pass with little lag. The
+ * fingers are filtered with SSE, the orientation is smoothed with a slerp
+ * towards the new sample using the same adaptive cutoff.
+ */
+class GloveFilter
+{
+private:
+	GLOVE_FILTER m_parameters;
+	bool m_initialized;
+	uint64_t m_timestamp;
+
+	// Filtered fingers and their filtered speed, padded to FILTER_LANES
+	float m_fingers[FILTER_LANES];
+	float m_finger_speed[FILTER_LANES];
+
+	GLOVE_QUATERNION m_orientation;
+	float m_angular_speed;
+
+public:
+	GloveFilter();
+
+	static void GetDefault(GLOVE_FILTER* parameters);
+
+	const GLOVE_FILTER& GetParameters() const { return m_parameters; }
+	void SetParameters(const GLOVE_FILTER& parameters);
+
+	/*! Start over from the next sample. */
+	void Reset();
+
+	/*! \brief Filter a sample.
+	*
+	*  \param timestamp Time of the sample on the SDK clock.
+	*  \param filtered Output variable, may be the same as the input.
+	*/
+	void Apply(const GLOVE_DATA& data, uint64_t timestamp, GLOVE_DATA* filtered);
+};
@@ -0,0 +1,125 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "HandModel.h"
+#include "ManusMath.h"
+
+#include <math.h>
+#include <string.h>
+
+// Finger that drives each bone in GLOVE_SKELETAL order
+static const int g_bone_fingers[GLOVE_BONES] = {
+	-1,
+	0, 0, 0,
+	1, 1, 1, 1,
+	2, 2, 2, 2,
+	3, 3, 3, 3,
+	4, 4, 4, 4,
+};
+
+HandModel::HandModel()
+{
+	memset(m_samples, 0, sizeof(m_samples));
+}
+
+void HandModel::SetSample(int bone, int sample, const GLOVE_POSE& pose)
+{
+	GLOVE_POSE& result = m_samples[bone][sample];
+	result = pose;
+
+	// Keep neighbouring samples in the same hemisphere so they can be blended directly
+	if (sample > 0)
+	{
+		const GLOVE_QUATERNION& previous = m_samples[bone][sample - 1].orientation;
+		GLOVE_QUATERNION& q = result.orientation;
+		if (previous.w * q.w + previous.x * q.x + previous.y * q.y + previous.z * q.z < 0.0f)
+		{
+			q.w = -q.w;
+			q.x = -q.x;
+			q.y = -q.y;
+			q.z = -q.z;
+		}
+	}
+}
+
+void HandModel::Evaluate(const GLOVE_DATA& data, GLOVE_SKELETAL* model) const
+{
+	// Swap the axes of the glove like the palm in SkeletalModel, without the rotation to match Unity
+	GLOVE_QUATERNION orient;
+	orient.w = data.Quaternion.w;
+	orient.x = data.Quaternion.y;
+	orient.y = data.Quaternion.z;
+	orient.z = data.Quaternion.x;
+
+	// Position of every finger between its samples
+	int index[GLOVE_FINGERS];
+	float weight[GLOVE_FINGERS];
+	for (int i = 0; i < GLOVE_FINGERS; i++)
+	{
+		float value = data.Fingers[i];
+		if (!(value > 0.0f))
+			value = 0.0f;
+		else if (value > 1.0f)
+			value = 1.0f;
+
+		float position = value * (HAND_MODEL_SAMPLES - 1);
+		index[i] = (int)position;
+		if (index[i] > HAND_MODEL_SAMPLES - 2)
+			index[i] = HAND_MODEL_SAMPLES - 2;
+		weight[i] = position - index[i];
+	}
+
+	GLOVE_POSE* poses = (GLOVE_POSE*)model;
+	for (int bone = 1; bone < GLOVE_BONES; bone++)
+	{
+		int finger = g_bone_fingers[bone];
+		float t = weight[finger];
+		const GLOVE_POSE& a = m_samples[bone][index[finger]];
+		const GLOVE_POSE& b = m_samples[bone][index[finger] + 1];
+
+		// The samples are close together, so a normalized linear blend is as good as a slerp
+		GLOVE_QUATERNION q;
+		q.w = a.orientation.w + t * (b.orientation.w - a.orientation.w);
+		q.x = a.orientation.x + t * (b.orientation.x - a.orientation.x);
+		q.y = a.orientation.y + t * (b.orientation.y - a.orientation.y);
+		q.z = a.orientation.z + t * (b.orientation.z - a.orientation.z);
+		float norm = 1.0f / sqrtf(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+		q.w *= norm;
+		q.x *= norm;
+		q.y *= norm;
+		q.z *= norm;
+
+		float px = a.position.x + t * (b.position.x - a.position.x);
+		float py = a.position.y + t * (b.position.y - a.position.y);
+		float pz = a.position.z + t * (b.position.z - a.position.z);
+
+		// Rotate the bone by the glove: v + 2w(u x v) + 2u x (u x v), with u the vector part of orient
+		float tx = 2.0f * (orient.y * pz - orient.z * py);
+		float ty = 2.0f * (orient.z * px - orient.x * pz);
+		float tz = 2.0f * (orient.x * py - orient.y * px);
+
+		GLOVE_POSE& pose = poses[bone];
+		pose.orientation = ManusMath::QuaternionMultiply(orient, q);
+		pose.position.x = px + orient.w * tx + orient.y * tz - orient.z * ty;
+		pose.position.y = py + orient.w * ty + orient.z * tx - orient.x * tz;
+		pose.position.z = pz + orient.w * tz + orient.x * ty - orient.y * tx;
+	}
+}
@@ -0,0 +1,55 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Glove.h"
+
+// Samples of the animation of every bone, over the range of the finger values
+#define HAND_MODEL_SAMPLES 65
+
+/*
+ * A hand model baked into tables for fast evaluation.
+ *
+ * The animation of every bone is sampled over the range of its finger, so
+ * evaluating the model only interpolates between the two samples around
+ * the finger value and applies the orientation of the glove. A model is
+ * never changed once it is baked, so it can be shared between threads
+ * without locking.
+ */
+class HandModel
+{
+private:
+	// Global pose of every bone in GLOVE_SKELETAL order, the palm is left out
+	GLOVE_POSE m_samples[GLOVE_BONES][HAND_MODEL_SAMPLES];
+
+public:
+	HandModel();
+
+	/*! \brief Set a sample of a bone while baking the model.
+	*
+	*  \param bone Index of the bone in GLOVE_SKELETAL, the palm has index zero.
+	*  \param sample Index of the sample, sample i is at the finger value i / (HAND_MODEL_SAMPLES - 1).
+	*/
+	void SetSample(int bone, int sample, const GLOVE_POSE& pose);
+
+	/*! Evaluate the bones of the fingers, the palm is left unchanged. */
+	void Evaluate(const GLOVE_DATA& data, GLOVE_SKELETAL* model) const;
+};
@@ -0,0 +1,247 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "ImuCalibration.h"
+#include "matrix.h"
+
+#include <math.h>
+#include <string.h>
+
+#define DIAGONAL 0.57735027f
+
+static const float s_directions[IMU_DIRECTIONS][3] = {
+	{ 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f },
+	{ 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f },
+	{ 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f },
+	{ DIAGONAL, DIAGONAL, DIAGONAL }, { DIAGONAL, DIAGONAL, -DIAGONAL },
+	{ DIAGONAL, -DIAGONAL, DIAGONAL }, { DIAGONAL, -DIAGONAL, -DIAGONAL },
+	{ -DIAGONAL, DIAGONAL, DIAGONAL }, { -DIAGONAL, DIAGONAL, -DIAGONAL },
+	{ -DIAGONAL, -DIAGONAL, DIAGONAL }, { -DIAGONAL, -DIAGONAL, -DIAGONAL },
+};
+
+ImuCalibration::ImuCalibration()
+{
+	GetDefault(&m_correction);
+	Start();
+	Stop();
+}
+
+void ImuCalibration::GetDefault(GLOVE_IMU_CALIBRATION* correction)
+{
+	memset(correction, 0, sizeof(GLOVE_IMU_CALIBRATION));
+	for (int i = 0; i < 3; i++)
+		correction->Gain[i][i] = 1.0f;
+}
+
+void ImuCalibration::Start()
+{
+	m_collecting = true;
+	m_samples = 0;
+	memset(m_sums, 0, sizeof(m_sums));
+	memset(m_directions, 0, sizeof(m_directions));
+	m_has_previous = false;
+}
+
+void ImuCalibration::Apply(GLOVE_VECTOR* acceleration)
+{
+	if (m_collecting)
+		Add(*acceleration);
+
+	const float raw[3] = {
+		acceleration->x - m_correction.Offset.x,
+		acceleration->y - m_correction.Offset.y,
+		acceleration->z - m_correction.Offset.z,
+	};
+
+	const float (*gain)[3] = m_correction.Gain;
+	acceleration->x = gain[0][0] * raw[0] + gain[0][1] * raw[1] + gain[0][2] * raw[2];
+	acceleration->y = gain[1][0] * raw[0] + gain[1][1] * raw[1] + gain[1][2] * raw[2];
+	acceleration->z = gain[2][0] * raw[0] + gain[2][1] * raw[1] + gain[2][2] * raw[2];
+}
+
+void ImuCalibration::Add(const GLOVE_VECTOR& acceleration)
+{
+	// Only use samples where the hand is still, so the acceleration is gravity
+	bool still = false;
+	if (m_has_previous)
+	{
+		float dx = acceleration.x - m_previous.x;
+		float dy = acceleration.y - m_previous.y;
+		float dz = acceleration.z - m_previous.z;
+		still = dx * dx + dy * dy + dz * dz < IMU_STILL_THRESHOLD * IMU_STILL_THRESHOLD;
+	}
+
+	m_previous = acceleration;
+	m_has_previous = true;
+
+	if (!still)
+		return;
+
+	// Find the closest direction of gravity
+	int direction = 0;
+	float best = -1.0f;
+	for (int i = 0; i < IMU_DIRECTIONS; i++)
+	{
+		const float* d = s_directions[i];
+		float dot = d[0] * acceleration.x + d[1] * acceleration.y + d[2] * acceleration.z;
+		if (dot > best)
+		{
+			best = dot;
+			direction = i;
+		}
+	}
+
+	if (m_directions[direction] >= IMU_DIRECTION_LIMIT)
+		return;
+	m_directions[direction]++;
+
+	double x = acceleration.x, y = acceleration.y, z = acceleration.z;
+	const double terms[IMU_FIT_TERMS] = { x * x, x * y, x * z, y * y, y * z, z * z, x, y, z, 1.0 };
+
+	// Only the upper triangle is accumulated
+	for (int i = 0; i < IMU_FIT_TERMS; i++)
+	{
+		for (int j = i; j < IMU_FIT_TERMS; j++)
+			m_sums[i][j] += terms[i] * terms[j];
+	}
+
+	m_samples++;
+}
+
+bool ImuCalibration::Solve(GLOVE_IMU_CALIBRATION* fit, GLOVE_IMU_CALIBRATION_STATUS* status) const
+{
+	unsigned int covered = 0;
+	for (int i = 0; i < IMU_DIRECTIONS; i++)
+	{
+		if (m_directions[i] >= IMU_DIRECTION_SAMPLES)
+			covered++;
+	}
+
+	if (status)
+	{
+		status->Samples = m_samples;
+		status->Coverage = (float)covered / IMU_DIRECTIONS;
+		status->FitError = -1.0f;
+	}
+
+	if (covered < IMU_MIN_DIRECTIONS)
+		return false;
+
+	// The mean of the products keeps the matrix well scaled for the solver
+	float products[10][10];
+	for (int i = 0; i < IMU_FIT_TERMS; i++)
+	{
+		for (int j = i; j < IMU_FIT_TERMS; j++)
+			products[i][j] = products[j][i] = (float)(m_sums[i][j] / m_samples);
+	}
+
+	// The coefficients of the ellipsoid minimize the residual, which is the
+	// eigenvector of the smallest eigenvalue.
+	float eigval[10], eigvec[10][10];
+	eigencompute(products, eigval, eigvec, IMU_FIT_TERMS);
+
+	int smallest = 0;
+	for (int i = 1; i < IMU_FIT_TERMS; i++)
+	{
+		if (eigval[i] < eigval[smallest])
+			smallest = i;
+	}
+
+	float c[IMU_FIT_TERMS];
+	for (int i = 0; i < IMU_FIT_TERMS; i++)
+		c[i] = eigvec[i][smallest];
+
+	// x^T A x + B^T x + c = 0, with the sign chosen so A is positive
+	float A[3][3] = {
+		{ c[0], 0.5f * c[1], 0.5f * c[2] },
+		{ 0.5f * c[1], c[3], 0.5f * c[4] },
+		{ 0.5f * c[2], 0.5f * c[4], c[5] },
+	};
+	float sign = f3x3matrixDetA(A) < 0.0f ? -1.0f : 1.0f;
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+			A[i][j] *= sign;
+	}
+	const float B[3] = { sign * c[6], sign * c[7], sign * c[8] };
+
+	// The center is -A^-1 B / 2, and (x - V)^T A (x - V) = V^T A V - c
+	float inverse[3][3];
+	f3x3matrixAeqInvSymB(inverse, A);
+
+	float V[3];
+	for (int i = 0; i < 3; i++)
+		V[i] = -0.5f * (inverse[i][0] * B[0] + inverse[i][1] * B[1] + inverse[i][2] * B[2]);
+
+	float k = -sign * c[9];
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+			k += V[i] * A[i][j] * V[j];
+	}
+
+	if (!(k > 0.0f))
+		return false;
+
+	// The gain is the square root of A / k, which maps the ellipsoid to the unit sphere
+	float scaled[10][10];
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+			scaled[i][j] = A[i][j] / k;
+	}
+
+	float scaled_eigval[10], scaled_eigvec[10][10];
+	eigencompute(scaled, scaled_eigval, scaled_eigvec, 3);
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (!(scaled_eigval[i] > 0.0f))
+			return false;
+		scaled_eigval[i] = sqrtf(scaled_eigval[i]);
+	}
+
+	if (fit)
+	{
+		fit->Offset.x = V[0];
+		fit->Offset.y = V[1];
+		fit->Offset.z = V[2];
+
+		for (int i = 0; i < 3; i++)
+		{
+			for (int j = 0; j < 3; j++)
+			{
+				fit->Gain[i][j] = 0.0f;
+				for (int l = 0; l < 3; l++)
+					fit->Gain[i][j] += scaled_eigvec[i][l] * scaled_eigval[l] * scaled_eigvec[j][l];
+			}
+		}
+	}
+
+	// A relative error e of the radius gives a residual of about 2 k e
+	if (status)
+	{
+		float residual = eigval[smallest] > 0.0f ? eigval[smallest] : 0.0f;
+		status->FitError = 100.0f * sqrtf(residual) / (2.0f * k);
+	}
+
+	return true;
+}
@@ -0,0 +1,97 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Manus.h"
+
+// Terms of the ellipsoid: x^2, xy, xz, y^2, yz, z^2, x, y, z and 1
+#define IMU_FIT_TERMS 10
+
+// Directions of gravity tracked for the coverage: the axes and the diagonals
+#define IMU_DIRECTIONS 14
+
+// Samples per direction needed to count it as covered, and the most that are used
+#define IMU_DIRECTION_SAMPLES 20
+#define IMU_DIRECTION_LIMIT   200
+
+// Directions that must be covered before the fit is solved
+#define IMU_MIN_DIRECTIONS 8
+
+// Largest change in g between two samples for the hand to count as still
+#define IMU_STILL_THRESHOLD 0.05f
+
+/*
+ * Host-side calibration of the accelerometer.
+ *
+ * While the hand is slowly turned through every orientation the raw
+ * acceleration lies on an ellipsoid, which is fitted and mapped back to a
+ * sphere of 1 g. Only the sums of the products of the ten terms of the
+ * ellipsoid are kept, so every sample updates the fit in constant time
+ * and memory. Solving takes the eigenvector of the smallest eigenvalue of
+ * those sums, and the square root of the ellipsoid matrix gives the gain.
+ *
+ * Samples taken while the hand moves are rejected, and each direction of
+ * gravity contributes a limited number of samples so holding still in one
+ * orientation doesn't skew the fit.
+ */
+class ImuCalibration
+{
+private:
+	GLOVE_IMU_CALIBRATION m_correction;
+
+	bool m_collecting;
+	unsigned int m_samples;
+	double m_sums[IMU_FIT_TERMS][IMU_FIT_TERMS];
+	unsigned int m_directions[IMU_DIRECTIONS];
+	GLOVE_VECTOR m_previous;
+	bool m_has_previous;
+
+public:
+	ImuCalibration();
+
+	static void GetDefault(GLOVE_IMU_CALIBRATION* correction);
+
+	const GLOVE_IMU_CALIBRATION& GetCorrection() const { return m_correction; }
+	void SetCorrection(const GLOVE_IMU_CALIBRATION& correction) { m_correction = correction; }
+
+	/*! Start collecting samples, discarding the previous ones. */
+	void Start();
+	void Stop() { m_collecting = false; }
+	bool IsCollecting() const { return m_collecting; }
+
+	/*! \brief Correct a raw acceleration.
+	*
+	*  The raw acceleration is added to the fit while collecting.
+	*/
+	void Apply(GLOVE_VECTOR* acceleration);
+
+	/*! \brief Fit the samples collected so far.
+	*
+	*  Takes a few milliseconds, call it on a copy to leave the decoder alone.
+	*
+	*  \param status Optional output variable to receive the progress.
+	*  \return False if there aren't enough samples or they don't fit an ellipsoid.
+	*/
+	bool Solve(GLOVE_IMU_CALIBRATION* fit, GLOVE_IMU_CALIBRATION_STATUS* status) const;
+
+private:
+	void Add(const GLOVE_VECTOR& acceleration);
+};
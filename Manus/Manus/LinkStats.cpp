@@ -0,0 +1,152 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "LinkStats.h"
+
+#include <algorithm>
+#include <math.h>
+
+LinkStats::LinkStats()
+	: m_has_previous(false)
+	, m_previous_time(0)
+	, m_interval(0.0f)
+	, m_interval_count(0)
+	, m_interval_next(0)
+	, m_jitter(0.0f)
+	, m_window_start(0)
+	, m_window_packets(0)
+	, m_window_dropped(0)
+	, m_restart(false)
+	, m_packets(0)
+	, m_dropped(0)
+	, m_duplicates(0)
+	, m_read_failures(0)
+	, m_last_time(0)
+	, m_published_interval(0.0f)
+	, m_published_jitter(0.0f)
+	, m_rate(0.0f)
+	, m_loss(0.0f)
+{
+}
+
+void LinkStats::Reset()
+{
+	m_restart.store(true, std::memory_order_release);
+
+	// Nothing was received on the new connection yet
+	m_last_time.store(0, std::memory_order_relaxed);
+	m_rate.store(0.0f, std::memory_order_relaxed);
+	m_loss.store(0.0f, std::memory_order_relaxed);
+}
+
+void LinkStats::Receive(uint64_t timestamp, bool duplicate)
+{
+	// The first report after a reconnect starts a new sequence of intervals
+	if (m_restart.exchange(false, std::memory_order_acquire))
+	{
+		m_has_previous = false;
+		m_interval = 0.0f;
+		m_interval_count = 0;
+		m_interval_next = 0;
+		m_jitter = 0.0f;
+		m_window_packets = 0;
+		m_window_dropped = 0;
+	}
+
+	m_packets.fetch_add(1, std::memory_order_relaxed);
+	m_last_time.store(timestamp, std::memory_order_relaxed);
+	m_window_packets++;
+
+	if (!m_has_previous)
+	{
+		m_has_previous = true;
+		m_previous_time = timestamp;
+		m_window_start = timestamp;
+		return;
+	}
+
+	if (duplicate)
+		m_duplicates.fetch_add(1, std::memory_order_relaxed);
+
+	float interval = (float)(timestamp - m_previous_time);
+	m_previous_time = timestamp;
+
+	if (m_interval > 0.0f && interval > LINK_GAP_FACTOR * m_interval)
+	{
+		// A gap doesn't update the jitter
+		uint64_t lost = (uint64_t)floorf(interval / m_interval + 0.5f) - 1;
+		m_dropped.fetch_add(lost, std::memory_order_relaxed);
+		m_window_dropped += lost;
+	}
+	else if (m_interval > 0.0f)
+	{
+		float deviation = fabsf(interval - m_interval);
+		m_jitter += (deviation - m_jitter) / LINK_SMOOTHING;
+	}
+
+	m_intervals[m_interval_next] = interval;
+	m_interval_next = (m_interval_next + 1) % LINK_MEDIAN_WINDOW;
+	if (m_interval_count < LINK_MEDIAN_WINDOW)
+		m_interval_count++;
+
+	float sorted[LINK_MEDIAN_WINDOW];
+	std::copy(m_intervals, m_intervals + m_interval_count, sorted);
+	std::nth_element(sorted, sorted + m_interval_count / 2, sorted + m_interval_count);
+	m_interval = std::max(sorted[m_interval_count / 2], LINK_MIN_INTERVAL);
+
+	m_published_interval.store(m_interval, std::memory_order_relaxed);
+	m_published_jitter.store(m_jitter, std::memory_order_relaxed);
+
+	uint64_t elapsed = timestamp - m_window_start;
+	if (elapsed >= LINK_WINDOW)
+	{
+		uint64_t expected = m_window_packets + m_window_dropped;
+		m_rate.store(m_window_packets * 1000000.0f / elapsed, std::memory_order_relaxed);
+		m_loss.store((float)m_window_dropped / expected, std::memory_order_relaxed);
+
+		m_window_start = timestamp;
+		m_window_packets = 0;
+		m_window_dropped = 0;
+	}
+}
+
+void LinkStats::Get(uint64_t now, GLOVE_LINK_STATS* stats) const
+{
+	stats->Packets = m_packets.load(std::memory_order_relaxed);
+	stats->Dropped = m_dropped.load(std::memory_order_relaxed);
+	stats->Duplicates = m_duplicates.load(std::memory_order_relaxed);
+	stats->ReadFailures = m_read_failures.load(std::memory_order_relaxed);
+	stats->Rate = m_rate.load(std::memory_order_relaxed);
+	stats->Loss = m_loss.load(std::memory_order_relaxed);
+	stats->Interval = m_published_interval.load(std::memory_order_relaxed);
+	stats->Jitter = m_published_jitter.load(std::memory_order_relaxed);
+
+	uint64_t last = m_last_time.load(std::memory_order_relaxed);
+	stats->Age = last != 0 && now > last ? now - last : 0;
+
+	// A silent link keeps the values of its last window, take out the part of it that has passed
+	if (stats->Interval > 0.0f && stats->Age > LINK_GAP_FACTOR * stats->Interval)
+	{
+		float remaining = stats->Age < LINK_WINDOW ? 1.0f - (float)stats->Age / LINK_WINDOW : 0.0f;
+		stats->Rate *= remaining;
+		stats->Loss = 1.0f - (1.0f - stats->Loss) * remaining;
+	}
+}
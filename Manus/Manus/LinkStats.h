@@ -0,0 +1,114 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Manus.h"
+
+#include <atomic>
+#include <inttypes.h>
+
+// Smoothing of the jitter, as a power of two
+#define LINK_SMOOTHING 16
+
+// Number of intervals the expected interval is the median of
+#define LINK_MEDIAN_WINDOW 15
+
+// Lower bound of the expected interval in microseconds, reports that
+// arrive back to back in one connection event don't count as a rate
+#define LINK_MIN_INTERVAL 1000.0f
+
+// An interval this many times the expected interval is counted as a gap
+#define LINK_GAP_FACTOR 1.8f
+
+// Length of the window for the rate and loss in microseconds
+#define LINK_WINDOW 1000000
+
+/*
+ * Quality of the Bluetooth link of a glove.
+ *
+ * The report doesn't carry a sequence number of the device, so lost
+ * reports are estimated from gaps in the arrival times: an interval of
+ * about n expected intervals means n - 1 reports were lost.
+ *
+ * The expected interval is the median of the last LINK_MEDIAN_WINDOW
+ * intervals, gaps included. A few lost reports can't move it, but once the
+ * device settles on a lower rate the longer intervals become the majority
+ * and the median follows. The jitter is smoothed as in RFC 3550.
+ *
+ * Reset starts the intervals over when the glove connects or disconnects,
+ * so the time without a connection isn't counted as lost reports. The rate
+ * and loss are only computed when a report arrives, so Get ages them by
+ * the silence since the last report: after a full window without reports
+ * the rate is 0 and the loss 1.
+ *
+ * Receive is only called from the transport thread of the glove, so the
+ * state behind it is unsynchronized. Everything a reader can see is
+ * published with relaxed atomics, which keeps the receive path free of
+ * locks and a reader never holds up the glove.
+ */
+class LinkStats
+{
+private:
+	// Only touched by the transport thread
+	bool m_has_previous;
+	uint64_t m_previous_time;
+	float m_interval;
+	float m_intervals[LINK_MEDIAN_WINDOW];
+	unsigned int m_interval_count;
+	unsigned int m_interval_next;
+	float m_jitter;
+	uint64_t m_window_start;
+	uint64_t m_window_packets;
+	uint64_t m_window_dropped;
+
+	// Set by Reset from any thread, the transport thread starts over on the next report
+	std::atomic<bool> m_restart;
+
+	// Published to readers
+	std::atomic<uint64_t> m_packets;
+	std::atomic<uint64_t> m_dropped;
+	std::atomic<uint64_t> m_duplicates;
+	std::atomic<uint64_t> m_read_failures;
+	std::atomic<uint64_t> m_last_time;
+	std::atomic<float> m_published_interval;
+	std::atomic<float> m_published_jitter;
+	std::atomic<float> m_rate;
+	std::atomic<float> m_loss;
+
+public:
+	LinkStats();
+
+	/*! \brief Account for a report.
+	*
+	*  \param timestamp Time of arrival on the SDK clock.
+	*  \param duplicate The report is identical to the previous one.
+	*/
+	void Receive(uint64_t timestamp, bool duplicate);
+
+	/*! Start the intervals over after the connection changed, from any thread. */
+	void Reset();
+
+	/*! Account for a failed read of a characteristic, from any thread. */
+	void ReadFailed() { m_read_failures.fetch_add(1, std::memory_order_relaxed); }
+
+	/*! \param now Current time on the SDK clock, for the age of the last report. */
+	void Get(uint64_t now, GLOVE_LINK_STATS* stats) const;
+};
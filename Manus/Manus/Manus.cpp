@@ -22,21 +22,92 @@
 #include "Glove.h"
 #include "Devices.h"
 #include "SkeletalModel.h"
+#include "StreamServer.h"
+#include "StreamClient.h"
+#include "BrokerServer.h"
+#include "BrokerClient.h"
+#include "Recording.h"
+#include "FingerProfile.h"
+#include "FrameResampler.h"
+#include "Clock.h"
+#include "SkeletalPalette.h"
+#include "SampleRing.h"
+#include "GestureEngine.h"
+#include "Pipeline.h"
+#include "SkeletalRig.h"
+#include "PalmTracker.h"
+#include "TrackerFusion.h"
+#include "ThreadRegistry.h"
+#include "SampleCallbacks.h"
+#include "CommandQueue.h"
+#include "Trace.h"
+#include "PoseHistory.h"
+#include "AdapterScheduler.h"
+#include "LinkStats.h"
 
 #ifdef _WIN32
 #include "WinDevices.h"
 #endif
 
+#include <math.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <set>
+#include <string>
 #include <vector>
 #include <mutex>
+#include <memory>
 
 bool g_initialized = false;
 
+// Features enabled by ManusInitEx, everything is available outside of it for the functions that don't need ManusInit
+unsigned int g_features = GLOVE_FEATURE_ALL;
+
 std::vector<Glove*> g_gloves;
 std::mutex g_gloves_mutex;
 
 Devices* g_devices;
 SkeletalModel g_skeletal;
+Pipeline g_pipeline(g_skeletal);
+
+StreamServer g_stream_server;
+StreamClient g_stream_client;
+
+BrokerServer g_broker_server;
+BrokerClient g_broker_client;
+
+RecordingWriter g_recorders[2];
+
+FrameResampler g_resampler;
+
+SampleRing g_rings[2];
+GestureEngine g_gestures[2];
+TrackerFusion g_trackers[2];
+SampleCallbacks g_callbacks[2];
+PoseHistory g_histories[2];
+
+CommandQueue g_commands;
+
+// Rebalance reconnects gloves, which takes seconds, so it doesn't hold up the commands of the application
+CommandQueue g_migrations;
+
+// Gloves spread over the Bluetooth adapters, guarded by the glove list lock
+AdapterScheduler g_scheduler;
+std::vector<std::wstring> g_adapters;
+// Device path of every glove through each adapter it is paired with, by Bluetooth address
+std::map<uint64_t, std::map<int, std::wstring>> g_device_paths;
+std::map<uint64_t, Glove*> g_scheduled;
+// Gloves being reconnected by Rebalance, left alone by the hotplug thread
+std::set<Glove*> g_migrating;
+// Only worth rebalancing with more than one adapter
+std::atomic<bool> g_balancing(false);
+std::atomic<uint64_t> g_next_rebalance(0);
+
+// Compiled rigs, indexed by their identifier
+std::vector<std::shared_ptr<SkeletalRig>> g_rigs;
+std::mutex g_rigs_mutex;
 
 int GetGlove(GLOVE_HAND hand, Glove** elem)
 {
@@ -54,6 +125,154 @@ int GetGlove(GLOVE_HAND hand, Glove** elem)
 	return MANUS_DISCONNECTED;
 }
 
+// Move gloves off saturated adapters, runs on the migration thread
+static int Rebalance()
+{
+	struct MOVE
+	{
+		Glove* glove;
+		ADAPTER_MIGRATION migration;
+		std::wstring from;
+	};
+	std::vector<MOVE> moves;
+
+	std::unique_lock<std::mutex> lock(g_gloves_mutex);
+
+	uint64_t now = GetTimestamp();
+	for (std::pair<const uint64_t, Glove*>& scheduled : g_scheduled)
+	{
+		GLOVE_LINK_STATS stats;
+		scheduled.second->GetLinkStats(&stats);
+
+		// A glove that stopped sending still holds a connection, but no bandwidth
+		bool silent = !scheduled.second->IsConnected() || stats.Age > LINK_WINDOW;
+		g_scheduler.Update(scheduled.first, now, silent ? 0.0f : stats.Rate, silent ? 0.0f : stats.Loss);
+	}
+
+	std::vector<ADAPTER_MIGRATION> migrations;
+	g_scheduler.Rebalance(now, migrations);
+
+	for (const ADAPTER_MIGRATION& migration : migrations)
+	{
+		std::map<uint64_t, Glove*>::iterator glove = g_scheduled.find(migration.glove);
+		std::map<uint64_t, std::map<int, std::wstring>>::iterator paths = g_device_paths.find(migration.glove);
+		std::map<int, std::wstring>::iterator path;
+		if (glove == g_scheduled.end() || paths == g_device_paths.end() ||
+			(path = paths->second.find(migration.to)) == paths->second.end() ||
+			g_migrating.count(glove->second) > 0)
+		{
+			g_scheduler.Revert(migration);
+			continue;
+		}
+
+		MOVE move;
+		move.glove = glove->second;
+		move.migration = migration;
+		move.from = move.glove->GetDevicePath();
+		moves.push_back(move);
+
+		move.glove->SetDevicePath(path->second.c_str());
+		g_migrating.insert(move.glove);
+	}
+
+	// Reconnecting waits for the Bluetooth stack, so the other functions keep using the glove list meanwhile.
+	// ManusExit stops the migration queue, which waits for this function, before it deletes the gloves.
+	lock.unlock();
+
+	for (MOVE& move : moves)
+	{
+		move.glove->Disconnect();
+		move.glove->Connect();
+		if (move.glove->IsConnected())
+			continue;
+
+		// The other adapter couldn't reach the glove, go back to where it was
+		lock.lock();
+		g_scheduler.Revert(move.migration);
+		move.glove->SetDevicePath(move.from.c_str());
+		lock.unlock();
+
+		move.glove->Disconnect();
+		move.glove->Connect();
+	}
+
+	lock.lock();
+	for (MOVE& move : moves)
+		g_migrating.erase(move.glove);
+
+	return MANUS_SUCCESS;
+}
+
+void SampleReceived(const GLOVE_SAMPLE& sample)
+{
+	TRACE_SCOPE_ARG("SampleReceived", sample.hand);
+
+	g_stream_server.Publish(sample);
+	g_broker_server.Publish(sample);
+	g_recorders[sample.hand].Write(sample);
+	g_gestures[sample.hand].Process(sample);
+	if (g_features & GLOVE_FEATURE_FUSION)
+		g_trackers[sample.hand].Process(sample);
+	g_resampler.Push(sample);
+	g_histories[sample.hand].Push(sample);
+	g_rings[sample.hand].Write(sample, g_skeletal);
+	g_callbacks[sample.hand].Publish(sample, g_skeletal);
+
+	// Look at the load of the adapters once per period
+	if (g_balancing.load(std::memory_order_relaxed))
+	{
+		uint64_t next = g_next_rebalance.load(std::memory_order_relaxed);
+		if (sample.timestamp >= next && g_next_rebalance.compare_exchange_strong(next, sample.timestamp + SCHEDULER_PERIOD))
+			g_migrations.Post(Rebalance, nullptr, nullptr);
+	}
+}
+
+// Add a device interface of a glove, called with the glove list locked
+static void AddDevice(const wchar_t* device_path)
+{
+	uint64_t address = 0;
+	std::wstring adapter_id;
+#ifdef _WIN32
+	bool found = WinDevices::GetTopology(device_path, &address, &adapter_id);
+#else
+	bool found = false;
+#endif
+
+	// Without a known adapter the glove is opened through whatever Windows picks
+	if (!found)
+	{
+		g_gloves.push_back(new Glove(device_path, SampleReceived, &g_pipeline));
+		return;
+	}
+
+	std::vector<std::wstring>::iterator it = std::find(g_adapters.begin(), g_adapters.end(), adapter_id);
+	int adapter = (int)(it - g_adapters.begin());
+	if (it == g_adapters.end())
+	{
+		g_adapters.push_back(adapter_id);
+		g_scheduler.AddAdapter();
+	}
+	g_balancing = g_adapters.size() > 1;
+
+	g_device_paths[address][adapter] = device_path;
+	g_scheduler.AddGlove(address, adapter);
+}
+
+// Open the gloves added since the last call on the adapter with the lowest load
+static void OpenScheduled()
+{
+	for (std::pair<const uint64_t, std::map<int, std::wstring>>& paths : g_device_paths)
+	{
+		if (g_scheduled.count(paths.first) > 0)
+			continue;
+
+		int adapter = g_scheduler.Assign(paths.first);
+		Glove* glove = new Glove(paths.second[adapter].c_str(), SampleReceived, &g_pipeline);
+		g_gloves.push_back(glove);
+		g_scheduled[paths.first] = glove;
+	}
+}
+
 void DeviceConnected(const wchar_t* device_path)
 {
 	std::lock_guard<std::mutex> lock(g_gloves_mutex);
@@ -63,23 +282,65 @@ void DeviceConnected(const wchar_t* device_path)
 	{
 		if (wcscmp(device_path, glove->GetDevicePath()) == 0)
 		{
-			// The glove was previously connected, reconnect it
-			glove->Connect();
+			// The glove was previously connected, reconnect it unless Rebalance is already doing so
+			if (g_migrating.count(glove) == 0)
+				glove->Connect();
 			return;
 		}
 	}
 
-	// The glove hasn't been connected before, add it to the list of gloves
-	g_gloves.push_back(new Glove(device_path));
+	// The glove hasn't been connected before or is now also paired with another adapter
+	AddDevice(device_path);
+	OpenScheduled();
+}
+
+// Build the hand model the first time a function needs it
+static bool StartSkeletal()
+{
+	if (!(g_features & GLOVE_FEATURE_SKELETAL))
+		return false;
+
+	return g_skeletal.InitializeScene();
 }
 
 int ManusInit()
+{
+	return ManusInitEx(nullptr);
+}
+
+static void GetDefaultOptions(GLOVE_INIT_OPTIONS* options)
+{
+	options->Features = GLOVE_FEATURE_ALL;
+	options->Preload = true;
+}
+
+int ManusInitEx(const GLOVE_INIT_OPTIONS* options)
 {
 	if (g_initialized)
 		return MANUS_ERROR;
 
-	if (!g_skeletal.InitializeScene())
+	GLOVE_INIT_OPTIONS result;
+	if (options)
+		result = *options;
+	else
+		GetDefaultOptions(&result);
+
+	if (result.Features & ~GLOVE_FEATURE_ALL)
+		return MANUS_INVALID_ARGUMENT;
+
+	g_features = result.Features;
+
+	// Without preloading the hand model is built by the first function that needs it
+	if (result.Preload && (g_features & GLOVE_FEATURE_SKELETAL) && !g_skeletal.InitializeScene())
+	{
+		g_features = GLOVE_FEATURE_ALL;
 		return MANUS_ERROR;
+	}
+
+	g_pipeline.Start();
+	g_commands.Start();
+	g_migrations.Start();
+	g_skeletal.StartLoading();
 
 	std::lock_guard<std::mutex> lock(g_gloves_mutex);
 
@@ -112,7 +373,7 @@ int ManusInit()
 				if (SetupDiGetDeviceInterfaceDetail(device_info_set, &device_interface_data, device_interface_detail_data,
 					required_size, nullptr, nullptr))
 				{
-					g_gloves.push_back(new Glove(device_interface_detail_data->DevicePath));
+					AddDevice(device_interface_detail_data->DevicePath);
 				}
 
 				free(device_interface_detail_data);
@@ -124,9 +385,16 @@ int ManusInit()
 		SetupDiDestroyDeviceInfoList(device_info_set);
 	}
 
+	// Every adapter of a glove is known now, so it can be placed on the best one
+	OpenScheduled();
+
 #ifdef _WIN32
-	g_devices = new WinDevices();
-	g_devices->SetDeviceConnected(DeviceConnected);
+	// Without hotplug only the gloves that are paired right now are used
+	if (g_features & GLOVE_FEATURE_HOTPLUG)
+	{
+		g_devices = new WinDevices();
+		g_devices->SetDeviceConnected(DeviceConnected);
+	}
 #endif
 
 	g_initialized = true;
@@ -139,16 +407,51 @@ int ManusExit()
 	if (!g_initialized)
 		return MANUS_ERROR;
 
+	// Stop the stage threads first, they publish into everything below
+	g_pipeline.Stop();
+	g_commands.Stop();
+
+	// The gloves keep calling SampleReceived, which must not queue another Rebalance
+	g_balancing = false;
+	g_migrations.Stop();
+
+	g_stream_server.Stop();
+	g_stream_client.Disconnect();
+	g_broker_server.Stop();
+	g_broker_client.Detach();
+	g_recorders[GLOVE_LEFT].Close();
+	g_recorders[GLOVE_RIGHT].Close();
+	g_resampler.Clear();
+	g_histories[GLOVE_LEFT].Clear();
+	g_histories[GLOVE_RIGHT].Clear();
+	g_rings[GLOVE_LEFT].Unregister();
+	g_rings[GLOVE_RIGHT].Unregister();
+	g_skeletal.StopLoading();
+
+	{
+		std::lock_guard<std::mutex> lock(g_rigs_mutex);
+		g_rigs.clear();
+	}
+
 	std::lock_guard<std::mutex> lock(g_gloves_mutex);
 
 	for (Glove* glove : g_gloves)
 		delete glove;
 	g_gloves.clear();
 
+	g_scheduled.clear();
+	g_migrating.clear();
+	g_device_paths.clear();
+	g_adapters.clear();
+	g_scheduler.Clear();
+	g_next_rebalance = 0;
+
 #ifdef _WIN32
 	delete g_devices;
+	g_devices = nullptr;
 #endif
 
+	g_features = GLOVE_FEATURE_ALL;
 	g_initialized = false;
 
 	return MANUS_SUCCESS;
@@ -156,6 +459,15 @@ int ManusExit()
 
 int ManusGetData(GLOVE_HAND hand, GLOVE_DATA* data, unsigned int timeout)
 {
+	// Read from the broker when another process owns the gloves
+	if (g_broker_client.IsAttached())
+	{
+		if (!data || (hand != GLOVE_LEFT && hand != GLOVE_RIGHT))
+			return MANUS_INVALID_ARGUMENT;
+
+		return g_broker_client.GetData(hand, data, timeout);
+	}
+
 	// Get the glove from the list
 	Glove* elem;
 	int ret = GetGlove(hand, &elem);
@@ -170,16 +482,32 @@ int ManusGetData(GLOVE_HAND hand, GLOVE_DATA* data, unsigned int timeout)
 
 int ManusGetSkeletal(GLOVE_HAND hand, GLOVE_SKELETAL* model, unsigned int timeout)
 {
+	if (!StartSkeletal())
+		return MANUS_ERROR;
+
 	GLOVE_DATA data;
 
 	int ret = ManusGetData(hand, &data, timeout);
 	if (ret != MANUS_SUCCESS)
 		return ret;
 
-	if (g_skeletal.Simulate(data, model, hand))
+	// Use the model of the skeleton stage when the pipeline runs it
+	if (g_pipeline.GetSkeletal(hand, model))
 		return MANUS_SUCCESS;
-	else
+
+	if (!g_skeletal.Simulate(data, model, hand))
 		return MANUS_ERROR;
+
+	// Move the model to the tracked position of the palm
+	Glove* elem;
+	if (GetGlove(hand, &elem) == MANUS_SUCCESS)
+	{
+		GLOVE_VECTOR position;
+		elem->GetPalmPosition(&position);
+		PalmTracker::Translate(position, model);
+	}
+
+	return MANUS_SUCCESS;
 }
 
 int ManusSetHandedness(GLOVE_HAND hand, bool right_hand)
@@ -229,6 +557,15 @@ int ManusCalibrate(GLOVE_HAND hand, bool gyro, bool accel, bool fingers)
 }
 
 int ManusSetVibration(GLOVE_HAND hand, float power){
+	// Forward the request to the process that owns the gloves
+	if (g_broker_client.IsAttached())
+	{
+		if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+			return MANUS_INVALID_ARGUMENT;
+
+		return g_broker_client.SetVibration(hand, power);
+	}
+
 	Glove* elem;
 	int ret = GetGlove(hand, &elem);
 	
@@ -239,3 +576,1048 @@ int ManusSetVibration(GLOVE_HAND hand, float power){
 
 	return MANUS_SUCCESS;
 }
+
+int ManusStreamStart(const char* address, unsigned short port)
+{
+	if (!(g_features & GLOVE_FEATURE_STREAMING))
+		return MANUS_ERROR;
+
+	if (!address)
+		return MANUS_INVALID_ARGUMENT;
+
+	return g_stream_server.Start(address, port) ? MANUS_SUCCESS : MANUS_ERROR;
+}
+
+int ManusStreamStop()
+{
+	if (!g_stream_server.IsRunning())
+		return MANUS_ERROR;
+
+	g_stream_server.Stop();
+
+	return MANUS_SUCCESS;
+}
+
+int ManusStreamConnect(const char* address, unsigned short port)
+{
+	if (!(g_features & GLOVE_FEATURE_STREAMING))
+		return MANUS_ERROR;
+
+	if (!address)
+		return MANUS_INVALID_ARGUMENT;
+
+	return g_stream_client.Connect(address, port) ? MANUS_SUCCESS : MANUS_ERROR;
+}
+
+int ManusStreamDisconnect()
+{
+	if (!g_stream_client.IsConnected())
+		return MANUS_ERROR;
+
+	g_stream_client.Disconnect();
+
+	return MANUS_SUCCESS;
+}
+
+int ManusStreamGetData(GLOVE_HAND hand, GLOVE_DATA* data, unsigned int timeout)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!data)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!g_stream_client.IsConnected())
+		return MANUS_DISCONNECTED;
+
+	return g_stream_client.GetData(hand, data, timeout) ? MANUS_SUCCESS : MANUS_ERROR;
+}
+
+int ManusStreamGetSkeletal(GLOVE_HAND hand, GLOVE_SKELETAL* model, unsigned int timeout)
+{
+	// The skeletal model is evaluated locally
+	if (!StartSkeletal())
+		return MANUS_ERROR;
+
+	if (!model)
+		return MANUS_INVALID_ARGUMENT;
+
+	GLOVE_DATA data;
+
+	int ret = ManusStreamGetData(hand, &data, timeout);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	if (g_skeletal.Simulate(data, model, hand))
+		return MANUS_SUCCESS;
+	else
+		return MANUS_ERROR;
+}
+
+int ManusBrokerStart()
+{
+	if (!g_initialized || g_broker_client.IsAttached())
+		return MANUS_ERROR;
+
+	if (!(g_features & GLOVE_FEATURE_STREAMING))
+		return MANUS_ERROR;
+
+	auto vibration = [](GLOVE_HAND hand, float power) { ManusSetVibration(hand, power); };
+	return g_broker_server.Start(vibration) ? MANUS_SUCCESS : MANUS_ERROR;
+}
+
+int ManusBrokerStop()
+{
+	if (!g_broker_server.IsRunning())
+		return MANUS_ERROR;
+
+	g_broker_server.Stop();
+
+	return MANUS_SUCCESS;
+}
+
+int ManusBrokerAttach()
+{
+	if (g_initialized)
+		return MANUS_ERROR;
+
+	if (!g_broker_client.Attach())
+		return MANUS_DISCONNECTED;
+
+	g_initialized = true;
+
+	return MANUS_SUCCESS;
+}
+
+int ManusBrokerRead(GLOVE_HAND hand, unsigned int* cursor, GLOVE_DATA* data, unsigned int count, unsigned int* read)
+{
+	if (!g_broker_client.IsAttached())
+		return MANUS_DISCONNECTED;
+
+	if (!cursor || !data || !read || (hand != GLOVE_LEFT && hand != GLOVE_RIGHT))
+		return MANUS_INVALID_ARGUMENT;
+
+	GLOVE_SAMPLE samples[BROKER_SLOTS];
+	if (count > BROKER_SLOTS)
+		count = BROKER_SLOTS;
+
+	*read = g_broker_client.Read(hand, cursor, samples, count);
+	for (unsigned int i = 0; i < *read; i++)
+		data[i] = samples[i].data;
+
+	return MANUS_SUCCESS;
+}
+
+int ManusRecordStart(GLOVE_HAND hand, const char* path)
+{
+	if (!(g_features & GLOVE_FEATURE_RECORDING))
+		return MANUS_ERROR;
+
+	if (!path || (hand != GLOVE_LEFT && hand != GLOVE_RIGHT))
+		return MANUS_INVALID_ARGUMENT;
+
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	return g_recorders[hand].Open(path, hand, elem->GetFlags()) ? MANUS_SUCCESS : MANUS_ERROR;
+}
+
+int ManusRecordStop(GLOVE_HAND hand)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!g_recorders[hand].IsOpen())
+		return MANUS_ERROR;
+
+	g_recorders[hand].Close();
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetProfile(GLOVE_HAND hand, GLOVE_PROFILE* profile)
+{
+	// Get the glove from the list
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	if (!profile)
+		return MANUS_INVALID_ARGUMENT;
+
+	elem->GetProfile(profile);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusSetProfile(GLOVE_HAND hand, const GLOVE_PROFILE* profile)
+{
+	// Get the glove from the list
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	GLOVE_PROFILE result;
+	if (profile)
+		result = *profile;
+	else
+		FingerProfile::GetDefault(&result);
+
+	if (!FingerProfile::IsValid(result))
+		return MANUS_INVALID_ARGUMENT;
+
+	elem->SetProfile(result);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusLoadProfile(GLOVE_HAND hand, const char* path)
+{
+	if (!path)
+		return MANUS_INVALID_ARGUMENT;
+
+	GLOVE_PROFILE profile;
+	if (!FingerProfile::Load(path, &profile))
+		return MANUS_ERROR;
+
+	return ManusSetProfile(hand, &profile);
+}
+
+int ManusSaveProfile(GLOVE_HAND hand, const char* path)
+{
+	if (!path)
+		return MANUS_INVALID_ARGUMENT;
+
+	GLOVE_PROFILE profile;
+	int ret = ManusGetProfile(hand, &profile);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	return FingerProfile::Save(path, profile) ? MANUS_SUCCESS : MANUS_ERROR;
+}
+
+int ManusGetFilteredData(GLOVE_HAND hand, GLOVE_DATA* data, unsigned int timeout)
+{
+	// Get the glove from the list
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	if (!data)
+		return MANUS_INVALID_ARGUMENT;
+
+	return elem->GetData(data, timeout, true) ? MANUS_SUCCESS : MANUS_ERROR;
+}
+
+int ManusGetFilter(GLOVE_HAND hand, GLOVE_FILTER* filter)
+{
+	// Get the glove from the list
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	if (!filter)
+		return MANUS_INVALID_ARGUMENT;
+
+	elem->GetFilter(filter);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusSetFilter(GLOVE_HAND hand, const GLOVE_FILTER* filter)
+{
+	// Get the glove from the list
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	GLOVE_FILTER result;
+	if (filter)
+		result = *filter;
+	else
+		GloveFilter::GetDefault(&result);
+
+	// NaN fails no comparison, check for it explicitly or it would reach the filter state
+	if (!isfinite(result.FingerMinCutoff) || !isfinite(result.FingerBeta) ||
+		!isfinite(result.OrientationMinCutoff) || !isfinite(result.OrientationBeta))
+		return MANUS_INVALID_ARGUMENT;
+
+	if (result.FingerMinCutoff <= 0.0f || result.FingerBeta < 0.0f ||
+		result.OrientationMinCutoff <= 0.0f || result.OrientationBeta < 0.0f)
+		return MANUS_INVALID_ARGUMENT;
+
+	elem->SetFilter(result);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetTime(unsigned long long* time)
+{
+	if (!time)
+		return MANUS_INVALID_ARGUMENT;
+
+	*time = GetTimestamp();
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetFrame(unsigned long long time, GLOVE_FRAME* frame, unsigned int timeout)
+{
+	if (!frame)
+		return MANUS_INVALID_ARGUMENT;
+
+	g_resampler.GetFrame(time, frame, timeout);
+
+	return frame->ValidHands != 0 ? MANUS_SUCCESS : MANUS_DISCONNECTED;
+}
+
+int ManusGetPalette(GLOVE_HAND hand, const GLOVE_PALETTE_LAYOUT* layout, float* palette, unsigned int timeout)
+{
+	if (!layout || !palette || !SkeletalPalette::IsValid(*layout))
+		return MANUS_INVALID_ARGUMENT;
+
+	GLOVE_SKELETAL model;
+	int ret = ManusGetSkeletal(hand, &model, timeout);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	SkeletalPalette::Write(model, *layout, palette);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusRegisterRing(GLOVE_HAND hand, GLOVE_RING_ENTRY* entries, unsigned int capacity,
+	unsigned long long* counter, unsigned int contents)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if ((contents & GLOVE_RING_SKELETAL) && !StartSkeletal())
+		return MANUS_ERROR;
+
+	if (!g_rings[hand].Register(entries, capacity, counter, contents))
+		return MANUS_INVALID_ARGUMENT;
+
+	return MANUS_SUCCESS;
+}
+
+int ManusUnregisterRing(GLOVE_HAND hand)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	g_rings[hand].Unregister();
+
+	return MANUS_SUCCESS;
+}
+
+int ManusAddGesture(GLOVE_HAND hand, const GLOVE_GESTURE* gesture)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!gesture || !g_gestures[hand].Add(*gesture))
+		return MANUS_INVALID_ARGUMENT;
+
+	return MANUS_SUCCESS;
+}
+
+int ManusRemoveGesture(GLOVE_HAND hand, unsigned int id)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	g_gestures[hand].Remove(id);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetGesture(GLOVE_HAND hand, unsigned int* id)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!id)
+		return MANUS_INVALID_ARGUMENT;
+
+	*id = g_gestures[hand].GetActive();
+
+	return MANUS_SUCCESS;
+}
+
+int ManusPollGesture(GLOVE_HAND hand, GLOVE_GESTURE_EVENT* event)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!event)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!g_gestures[hand].Poll(event))
+		return MANUS_ERROR;
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetPipeline(GLOVE_PIPELINE* pipeline)
+{
+	if (!pipeline)
+		return MANUS_INVALID_ARGUMENT;
+
+	g_pipeline.GetConfig(pipeline);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusSetPipeline(const GLOVE_PIPELINE* pipeline)
+{
+	if (g_initialized)
+		return MANUS_ERROR;
+
+	GLOVE_PIPELINE result;
+	if (pipeline)
+		result = *pipeline;
+	else
+		Pipeline::GetDefault(&result);
+
+	if (!Pipeline::IsValid(result))
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!g_pipeline.Configure(result))
+		return MANUS_ERROR;
+
+	return MANUS_SUCCESS;
+}
+
+int ManusPumpPipeline(unsigned int* processed)
+{
+	unsigned int count = g_pipeline.Pump();
+
+	if (processed)
+		*processed = count;
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetStageStats(GLOVE_STAGE stage, GLOVE_STAGE_STATS* stats)
+{
+	if (stage < GLOVE_STAGE_TRANSPORT || stage > GLOVE_STAGE_PUBLISH)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!stats)
+		return MANUS_INVALID_ARGUMENT;
+
+	g_pipeline.GetStats(stage, stats);
+
+	return MANUS_SUCCESS;
+}
+
+// Compile a rig for the hand model that is in use right now
+static int CompileRig(GLOVE_HAND hand, const GLOVE_RIG& rig, std::shared_ptr<SkeletalRig>* compiled)
+{
+	// Read the generation first, a model swapped in while compiling
+	// only causes the rig to be compiled once more
+	GLOVE_MODEL_STATUS status;
+	g_skeletal.GetStatus(hand, &status);
+
+	GLOVE_DATA data = {};
+	data.Quaternion.w = 1.0f;
+
+	GLOVE_SKELETAL rest;
+	if (!g_skeletal.Simulate(data, &rest, hand))
+		return MANUS_ERROR;
+
+	std::shared_ptr<SkeletalRig> result = std::make_shared<SkeletalRig>();
+	if (!result->Compile(hand, rig, rest, status.Generation))
+		return MANUS_INVALID_ARGUMENT;
+
+	*compiled = result;
+	return MANUS_SUCCESS;
+}
+
+int ManusRegisterRig(GLOVE_HAND hand, const GLOVE_RIG* rig, unsigned int* id)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!rig || !id)
+		return MANUS_INVALID_ARGUMENT;
+
+	// The rest pose of the model is needed to compile the rig
+	if (!StartSkeletal())
+		return MANUS_ERROR;
+
+	std::shared_ptr<SkeletalRig> compiled;
+	int ret = CompileRig(hand, *rig, &compiled);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	std::lock_guard<std::mutex> lock(g_rigs_mutex);
+
+	// Reuse the slot of a removed rig
+	size_t slot = 0;
+	while (slot < g_rigs.size() && g_rigs[slot])
+		slot++;
+
+	if (slot == g_rigs.size())
+		g_rigs.push_back(compiled);
+	else
+		g_rigs[slot] = compiled;
+
+	*id = (unsigned int)slot;
+
+	return MANUS_SUCCESS;
+}
+
+int ManusUnregisterRig(unsigned int id)
+{
+	std::lock_guard<std::mutex> lock(g_rigs_mutex);
+
+	if (id >= g_rigs.size() || !g_rigs[id])
+		return MANUS_INVALID_ARGUMENT;
+
+	g_rigs[id].reset();
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetRigPose(unsigned int id, GLOVE_POSE* poses, unsigned int timeout)
+{
+	if (!poses)
+		return MANUS_INVALID_ARGUMENT;
+
+	// Keep the rig alive while it is evaluated without the lock
+	std::shared_ptr<SkeletalRig> rig;
+	{
+		std::lock_guard<std::mutex> lock(g_rigs_mutex);
+		if (id < g_rigs.size())
+			rig = g_rigs[id];
+	}
+
+	if (!rig)
+		return MANUS_INVALID_ARGUMENT;
+
+	// The rest poses folded into the rig are stale once another hand model is swapped in
+	GLOVE_MODEL_STATUS status;
+	g_skeletal.GetStatus(rig->GetHand(), &status);
+	if (status.Generation != rig->GetGeneration())
+	{
+		std::shared_ptr<SkeletalRig> recompiled;
+		int ret = CompileRig(rig->GetHand(), rig->GetRig(), &recompiled);
+		if (ret != MANUS_SUCCESS)
+			return ret;
+
+		// Unless the rig was removed or replaced in the meantime
+		std::lock_guard<std::mutex> lock(g_rigs_mutex);
+		if (id < g_rigs.size() && g_rigs[id] == rig)
+			g_rigs[id] = recompiled;
+		rig = recompiled;
+	}
+
+	GLOVE_SKELETAL model;
+	int ret = ManusGetSkeletal(rig->GetHand(), &model, timeout);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	rig->Evaluate(model, poses);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusStartImuCalibration(GLOVE_HAND hand)
+{
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	elem->StartImuCalibration();
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetImuCalibrationStatus(GLOVE_HAND hand, GLOVE_IMU_CALIBRATION_STATUS* status, GLOVE_IMU_CALIBRATION* fit)
+{
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	if (!status)
+		return MANUS_INVALID_ARGUMENT;
+
+	elem->SolveImuCalibration(status, fit);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusStopImuCalibration(GLOVE_HAND hand, bool apply)
+{
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	elem->StopImuCalibration();
+
+	if (!apply)
+		return MANUS_SUCCESS;
+
+	GLOVE_IMU_CALIBRATION fit;
+	if (!elem->SolveImuCalibration(nullptr, &fit))
+		return MANUS_ERROR;
+
+	elem->SetImuCalibration(fit);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetImuCalibration(GLOVE_HAND hand, GLOVE_IMU_CALIBRATION* calibration)
+{
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	if (!calibration)
+		return MANUS_INVALID_ARGUMENT;
+
+	elem->GetImuCalibration(calibration);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusSetImuCalibration(GLOVE_HAND hand, const GLOVE_IMU_CALIBRATION* calibration)
+{
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	GLOVE_IMU_CALIBRATION result;
+	if (calibration)
+		result = *calibration;
+	else
+		ImuCalibration::GetDefault(&result);
+
+	elem->SetImuCalibration(result);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetLinkStats(GLOVE_HAND hand, GLOVE_LINK_STATS* stats)
+{
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	if (!stats)
+		return MANUS_INVALID_ARGUMENT;
+
+	elem->GetLinkStats(stats);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetPalmTracking(GLOVE_HAND hand, GLOVE_PALM_TRACKING* tracking)
+{
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	if (!tracking)
+		return MANUS_INVALID_ARGUMENT;
+
+	elem->GetPalmTracking(tracking);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusSetPalmTracking(GLOVE_HAND hand, const GLOVE_PALM_TRACKING* tracking)
+{
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	GLOVE_PALM_TRACKING result;
+	if (tracking)
+		result = *tracking;
+	else
+		PalmTracker::GetDefault(&result);
+
+	if (!PalmTracker::IsValid(result))
+		return MANUS_INVALID_ARGUMENT;
+
+	elem->SetPalmTracking(result);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetPalmPosition(GLOVE_HAND hand, GLOVE_VECTOR* position)
+{
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	if (!position)
+		return MANUS_INVALID_ARGUMENT;
+
+	elem->GetPalmPosition(position);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusResetPalmPosition(GLOVE_HAND hand)
+{
+	Glove* elem;
+	int ret = GetGlove(hand, &elem);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	elem->ResetPalmPosition();
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetTracker(GLOVE_HAND hand, GLOVE_TRACKER* tracker)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!tracker)
+		return MANUS_INVALID_ARGUMENT;
+
+	g_trackers[hand].GetConfig(tracker);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusSetTracker(GLOVE_HAND hand, const GLOVE_TRACKER* tracker)
+{
+	if (!(g_features & GLOVE_FEATURE_FUSION))
+		return MANUS_ERROR;
+
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	GLOVE_TRACKER result;
+	if (tracker)
+		result = *tracker;
+	else
+		TrackerFusion::GetDefault(&result);
+
+	if (!TrackerFusion::IsValid(result))
+		return MANUS_INVALID_ARGUMENT;
+
+	g_trackers[hand].Configure(result);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusPushTrackerPose(GLOVE_HAND hand, unsigned long long time, const GLOVE_POSE* pose)
+{
+	if (!(g_features & GLOVE_FEATURE_FUSION))
+		return MANUS_ERROR;
+
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!pose || !g_trackers[hand].Push(time, *pose))
+		return MANUS_INVALID_ARGUMENT;
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetWorldSkeletal(GLOVE_HAND hand, GLOVE_SKELETAL* model, unsigned int timeout)
+{
+	if (!(g_features & GLOVE_FEATURE_FUSION))
+		return MANUS_ERROR;
+
+	if (!model)
+		return MANUS_INVALID_ARGUMENT;
+
+	int ret = ManusGetSkeletal(hand, model, timeout);
+	if (ret != MANUS_SUCCESS)
+		return ret;
+
+	if (!g_trackers[hand].Transform(model))
+		return MANUS_ERROR;
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetThreadConfig(GLOVE_THREAD_ROLE role, GLOVE_THREAD_CONFIG* config)
+{
+	if (role < GLOVE_THREAD_DEVICES || role > GLOVE_THREAD_COMMANDS)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!config)
+		return MANUS_INVALID_ARGUMENT;
+
+	ThreadRegistry::Instance().GetConfig(role, config);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusSetThreadConfig(GLOVE_THREAD_ROLE role, const GLOVE_THREAD_CONFIG* config)
+{
+	if (role < GLOVE_THREAD_DEVICES || role > GLOVE_THREAD_COMMANDS)
+		return MANUS_INVALID_ARGUMENT;
+
+	GLOVE_THREAD_CONFIG result;
+	if (config)
+		result = *config;
+	else
+		ThreadRegistry::GetDefault(role, &result);
+
+	if (!ThreadRegistry::IsValid(role, result))
+		return MANUS_INVALID_ARGUMENT;
+
+	ThreadRegistry::Instance().Configure(role, result);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetThreads(GLOVE_THREAD_INFO* threads, unsigned int count, unsigned int* total)
+{
+	if ((!threads && count > 0) || !total)
+		return MANUS_INVALID_ARGUMENT;
+
+	*total = ThreadRegistry::Instance().GetThreads(threads, count);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusLoadHandModel(GLOVE_HAND hand, const char* path)
+{
+	if (!g_initialized || !(g_features & GLOVE_FEATURE_SKELETAL))
+		return MANUS_ERROR;
+
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!path)
+		return MANUS_INVALID_ARGUMENT;
+
+	g_skeletal.Load(hand, path, nullptr, 0);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusLoadHandModelFromMemory(GLOVE_HAND hand, const void* data, unsigned int size)
+{
+	if (!g_initialized || !(g_features & GLOVE_FEATURE_SKELETAL))
+		return MANUS_ERROR;
+
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!data || size == 0)
+		return MANUS_INVALID_ARGUMENT;
+
+	g_skeletal.Load(hand, nullptr, data, size);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusResetHandModel(GLOVE_HAND hand)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	g_skeletal.Reset(hand);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetHandModelStatus(GLOVE_HAND hand, GLOVE_MODEL_STATUS* status)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!status)
+		return MANUS_INVALID_ARGUMENT;
+
+	g_skeletal.GetStatus(hand, status);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusRegisterSampleCallback(GLOVE_HAND hand, GLOVE_SAMPLE_CALLBACK callback, void* context,
+	unsigned int contents, unsigned int* id)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!id)
+		return MANUS_INVALID_ARGUMENT;
+
+	if ((contents & GLOVE_RING_SKELETAL) && !StartSkeletal())
+		return MANUS_ERROR;
+
+	*id = g_callbacks[hand].Register(callback, context, contents);
+	if (*id == 0)
+		return MANUS_INVALID_ARGUMENT;
+
+	return MANUS_SUCCESS;
+}
+
+int ManusUnregisterSampleCallback(unsigned int id)
+{
+	if (!g_callbacks[GLOVE_LEFT].Unregister(id) && !g_callbacks[GLOVE_RIGHT].Unregister(id))
+		return MANUS_INVALID_ARGUMENT;
+
+	return MANUS_SUCCESS;
+}
+
+int ManusSetVibrationAsync(GLOVE_HAND hand, float power, GLOVE_COMPLETION_CALLBACK callback, void* context)
+{
+	if (!g_initialized)
+		return MANUS_ERROR;
+
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	g_commands.Post([=] { return ManusSetVibration(hand, power); }, callback, context);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusCalibrateAsync(GLOVE_HAND hand, bool gyro, bool accel, bool fingers,
+	GLOVE_COMPLETION_CALLBACK callback, void* context)
+{
+	if (!g_initialized)
+		return MANUS_ERROR;
+
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	g_commands.Post([=] { return ManusCalibrate(hand, gyro, accel, fingers); }, callback, context);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusSetTracing(bool enabled)
+{
+#if MANUS_TRACING
+	Tracer::SetEnabled(enabled);
+	return MANUS_SUCCESS;
+#else
+	return MANUS_ERROR;
+#endif
+}
+
+int ManusClearTrace()
+{
+	Tracer::Instance().Clear();
+	return MANUS_SUCCESS;
+}
+
+int ManusWriteTrace(const char* path)
+{
+	if (!path)
+		return MANUS_INVALID_ARGUMENT;
+
+	return Tracer::Instance().Write(path) ? MANUS_SUCCESS : MANUS_ERROR;
+}
+
+int ManusSetHistory(GLOVE_HAND hand, unsigned int retention)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (retention > HISTORY_MAX_RETENTION)
+		return MANUS_INVALID_ARGUMENT;
+
+	g_histories[hand].SetRetention(retention);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetHistoryRange(GLOVE_HAND hand, unsigned long long* oldest, unsigned long long* newest)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!oldest || !newest)
+		return MANUS_INVALID_ARGUMENT;
+
+	uint64_t first, last;
+	if (!g_histories[hand].GetRange(&first, &last))
+		return MANUS_ERROR;
+
+	*oldest = first;
+	*newest = last;
+
+	return MANUS_SUCCESS;
+}
+
+int ManusGetDataAt(GLOVE_HAND hand, unsigned long long time, GLOVE_DATA* data)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!data)
+		return MANUS_INVALID_ARGUMENT;
+
+	return g_histories[hand].GetData(time, data) ? MANUS_SUCCESS : MANUS_ERROR;
+}
+
+int ManusGetSkeletalAt(GLOVE_HAND hand, unsigned long long time, GLOVE_SKELETAL* model)
+{
+	if (hand != GLOVE_LEFT && hand != GLOVE_RIGHT)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!model)
+		return MANUS_INVALID_ARGUMENT;
+
+	if (!StartSkeletal())
+		return MANUS_ERROR;
+
+	return g_histories[hand].GetSkeletal(time, g_skeletal, hand, model) ? MANUS_SUCCESS : MANUS_ERROR;
+}
+
+int ManusGetAdapters(GLOVE_ADAPTER_INFO* adapters, unsigned int count, unsigned int* total)
+{
+	if ((!adapters && count > 0) || !total)
+		return MANUS_INVALID_ARGUMENT;
+
+	std::lock_guard<std::mutex> lock(g_gloves_mutex);
+
+	*total = (unsigned int)g_scheduler.GetAdapterCount();
+	for (unsigned int i = 0; i < count && i < *total; i++)
+		g_scheduler.GetInfo(i, &adapters[i]);
+
+	return MANUS_SUCCESS;
+}
+
+int ManusSetAdapterCapacity(unsigned int adapter, const GLOVE_ADAPTER_CAPACITY* capacity)
+{
+	if (capacity && (capacity->Connections == 0 || !(capacity->Bandwidth > 0.0f)))
+		return MANUS_INVALID_ARGUMENT;
+
+	std::lock_guard<std::mutex> lock(g_gloves_mutex);
+
+	if (adapter >= g_scheduler.GetAdapterCount())
+		return MANUS_INVALID_ARGUMENT;
+
+	GLOVE_ADAPTER_CAPACITY result;
+	if (capacity)
+		result = *capacity;
+	else
+		AdapterScheduler::GetDefaultCapacity(&result);
+	g_scheduler.SetCapacity(adapter, result);
+
+	return MANUS_SUCCESS;
+}
@@ -76,6 +76,396 @@ typedef struct {
 		ring, pinky;
 } GLOVE_SKELETAL;
 
+#define GLOVE_PROFILE_POINTS 9
+
+/*! Calibration of the finger sensors for a single user. */
+typedef struct {
+	//! Raw bend value of each finger, ranging from 0 to 1, when the finger is fully extended.
+	float Minimum[5];
+	//! Raw bend value of each finger when the finger is fully bent.
+	float Maximum[5];
+	//! Response curve sampled evenly over the calibrated range, a straight line from 0 to 1 is linear.
+	float Curve[GLOVE_PROFILE_POINTS];
+} GLOVE_PROFILE;
+
+/*! Parameters of the adaptive filter, the cutoff frequencies are in Hz. */
+typedef struct {
+	//! Cutoff of the fingers when they are still, lower removes more jitter.
+	float FingerMinCutoff;
+	//! Increase of the cutoff with the speed of the fingers, higher reduces the lag of fast movements.
+	float FingerBeta;
+	//! Cutoff of the orientation when the hand is still.
+	float OrientationMinCutoff;
+	//! Increase of the cutoff with the angular speed in radians per second.
+	float OrientationBeta;
+} GLOVE_FILTER;
+
+/*! Both hands resampled to the same point in time. */
+typedef struct {
+	//! Time of the frame on the SDK clock in microseconds.
+	unsigned long long Time;
+	//! Data of each hand, indexed by GLOVE_HAND.
+	GLOVE_DATA Hands[2];
+	//! Bit mask of the hands that have data, bit (1 << GLOVE_HAND) is set for a valid hand.
+	unsigned int ValidHands;
+} GLOVE_FRAME;
+
+// Number of bones in the skeletal model, the palm followed by the bones of each finger
+#define GLOVE_BONES 20
+#define GLOVE_PALETTE_MAX_BONES 32
+
+/*! Layout of each matrix in a bone palette. */
+typedef enum {
+	//! Three rows of four floats, the translation is in the last column.
+	GLOVE_PALETTE_3X4 = 0,
+	//! Four rows of four floats, the translation is in the last column.
+	GLOVE_PALETTE_4X4_ROWS,
+	//! Four columns of four floats, the translation is in the last column.
+	GLOVE_PALETTE_4X4_COLUMNS,
+} GLOVE_PALETTE_FORMAT;
+
+/*! Describes the bone palette expected by a renderer. */
+typedef struct {
+	//! Layout of the matrices.
+	GLOVE_PALETTE_FORMAT Format;
+	//! Source axis of each output axis, 1 for x, 2 for y and 3 for z, negated to flip the axis.
+	int Axes[3];
+	//! Number of matrices in the palette.
+	unsigned int BoneCount;
+	//! Bone of each matrix, indexed like the poses in GLOVE_SKELETAL: 0 is the palm, 1 to 3 the thumb and 4 to 19 the fingers.
+	unsigned int Bones[GLOVE_PALETTE_MAX_BONES];
+} GLOVE_PALETTE_LAYOUT;
+
+#define GLOVE_RING_DATA     0x1
+#define GLOVE_RING_SKELETAL 0x2
+
+/*! A sample written by the SDK into a ring registered with ManusRegisterRing. */
+typedef struct {
+	//! Odd while the SDK writes the entry, otherwise twice the number of samples written up to and including this one.
+	unsigned long long Sequence;
+	//! Time of arrival on the SDK clock in microseconds.
+	unsigned long long Timestamp;
+	//! Data of the glove, written when the ring contains GLOVE_RING_DATA.
+	GLOVE_DATA Data;
+	//! Skeletal model of the hand, written when the ring contains GLOVE_RING_SKELETAL.
+	GLOVE_SKELETAL Skeletal;
+} GLOVE_RING_ENTRY;
+
+#define GLOVE_GESTURE_NONE 0xFFFFFFFF
+
+/*! Template of a hand pose that is recognized as a gesture. */
+typedef struct {
+	//! Identifier of the gesture, several templates with the same identifier act as examples of one gesture.
+	unsigned int Id;
+	//! Bend value of each finger in the template.
+	float Fingers[5];
+	//! Allowed deviation of each finger, the pose matches when the deviations scaled by these add up to at most one.
+	float Tolerance[5];
+	//! Axis in the frame of the glove that is constrained, a zero axis ignores the orientation.
+	GLOVE_VECTOR Axis;
+	//! Direction the axis should point to in the world.
+	GLOVE_VECTOR Direction;
+	//! Largest allowed angle between the axis and the direction in radians.
+	float MaxAngle;
+} GLOVE_GESTURE;
+
+typedef enum {
+	GLOVE_GESTURE_BEGIN = 0,
+	GLOVE_GESTURE_END,
+} GLOVE_GESTURE_EVENT_TYPE;
+
+/*! A gesture that started or ended. */
+typedef struct {
+	//! Identifier of the gesture.
+	unsigned int Id;
+	GLOVE_GESTURE_EVENT_TYPE Type;
+	//! Sequence number of the data packet that started or ended the gesture.
+	unsigned int PacketNumber;
+	//! Time of arrival of that packet on the SDK clock in microseconds.
+	unsigned long long Timestamp;
+} GLOVE_GESTURE_EVENT;
+
+#define GLOVE_STAGES 5
+
+/*! Stages every packet from a glove passes through, in order. */
+typedef enum {
+	//! Reading the packet in the Bluetooth callback.
+	GLOVE_STAGE_TRANSPORT = 0,
+	//! Decoding the packet into glove data.
+	GLOVE_STAGE_DECODE,
+	//! Adaptive filtering of the glove data.
+	GLOVE_STAGE_FILTER,
+	//! Simulating the skeletal model.
+	GLOVE_STAGE_SKELETON,
+	//! Publishing the sample to readers, streams and recordings.
+	GLOVE_STAGE_PUBLISH,
+} GLOVE_STAGE;
+
+/*! Thread a pipeline stage runs on. */
+typedef enum {
+	//! On the thread of the previous stage.
+	GLOVE_PLACEMENT_INLINE = 0,
+	//! On a dedicated thread shared by all gloves.
+	GLOVE_PLACEMENT_THREAD,
+	//! On the thread that calls ManusPumpPipeline.
+	GLOVE_PLACEMENT_CALLER,
+	//! Not run at all, only allowed for the skeleton stage.
+	GLOVE_PLACEMENT_SKIP,
+} GLOVE_PLACEMENT;
+
+/*! Configuration of the sample processing pipeline. */
+typedef struct {
+	//! Placement of each stage, indexed by GLOVE_STAGE. The transport stage is always inline.
+	GLOVE_PLACEMENT Placement[GLOVE_STAGES];
+	//! Number of packets that can be queued per glove in front of a stage that isn't inline.
+	unsigned int QueueSize;
+} GLOVE_PIPELINE;
+
+/*! Timing counters of a pipeline stage, the times are in nanoseconds. */
+typedef struct {
+	//! Number of packets processed by the stage.
+	unsigned long long Count;
+	//! Total time spent in the stage.
+	unsigned long long TotalTime;
+	//! Longest time spent on a single packet.
+	unsigned long long MaxTime;
+	//! Number of packets dropped because the queue in front of the stage was full.
+	unsigned long long Dropped;
+	//! Largest number of packets that were waiting in front of the stage.
+	unsigned int MaxQueueDepth;
+} GLOVE_STAGE_STATS;
+
+#define GLOVE_RIG_MAX_BONES 64
+
+/*! Space of the poses written for a rig. */
+typedef enum {
+	//! Relative to the parent bone, the root is relative to the rig.
+	GLOVE_RIG_LOCAL = 0,
+	//! Relative to the rig.
+	GLOVE_RIG_GLOBAL,
+} GLOVE_RIG_SPACE;
+
+/*! Describes a bone of a rig. */
+typedef struct {
+	//! Parent bone in the rig, or -1 for a root. A parent must come before its children.
+	int Parent;
+	//! Bone of the skeletal model that drives this bone, indexed like the poses in GLOVE_SKELETAL, or -1 to keep the rest pose relative to the parent.
+	int Source;
+	//! Rest pose relative to the parent, in the axes of the rig, matching the hand with a neutral orientation and open fingers.
+	GLOVE_POSE Rest;
+} GLOVE_RIG_BONE;
+
+/*! Describes a rig that the skeletal model is retargeted to. */
+typedef struct {
+	//! Source axis of each rig axis, 1 for x, 2 for y and 3 for z, negated to flip the axis.
+	int Axes[3];
+	//! Scale from the units of the skeletal model to the units of the rig, applied to the movement of a root bone.
+	float Scale;
+	//! Space of the poses written by ManusGetRigPose.
+	GLOVE_RIG_SPACE Space;
+	//! Number of bones in the rig.
+	unsigned int BoneCount;
+	//! The bones of the rig.
+	GLOVE_RIG_BONE Bones[GLOVE_RIG_MAX_BONES];
+} GLOVE_RIG;
+
+/*! Correction of the accelerometer, applied as Gain * (acceleration - Offset). */
+typedef struct {
+	//! Offset of the accelerometer in g.
+	GLOVE_VECTOR Offset;
+	//! Rows of the gain matrix, which also corrects the misalignment of the axes.
+	float Gain[3][3];
+} GLOVE_IMU_CALIBRATION;
+
+/*! Progress of a host-side calibration. */
+typedef struct {
+	//! Number of samples used by the fit.
+	unsigned int Samples;
+	//! Fraction of the directions of gravity covered so far, from 0 to 1.
+	float Coverage;
+	//! Root mean square error of the fit in percent of gravity, negative when there is no fit yet.
+	float FitError;
+} GLOVE_IMU_CALIBRATION_STATUS;
+
+/*! Quality of the Bluetooth link of a glove. */
+typedef struct {
+	//! Number of reports received.
+	unsigned long long Packets;
+	//! Estimated number of reports lost, from gaps in the arrival times.
+	unsigned long long Dropped;
+	//! Number of reports identical to the previous one.
+	unsigned long long Duplicates;
+	//! Number of failed reads of a characteristic of the glove.
+	unsigned long long ReadFailures;
+	//! Reports per second over the last second.
+	float Rate;
+	//! Fraction of the reports lost over the last second.
+	float Loss;
+	//! Smoothed time between reports in microseconds.
+	float Interval;
+	//! Smoothed deviation of the time between reports in microseconds.
+	float Jitter;
+	//! Microseconds since the last report.
+	unsigned long long Age;
+} GLOVE_LINK_STATS;
+
+/*! Parameters of the palm position tracking, the times are in seconds. */
+typedef struct {
+	//! Track the position of the palm from the acceleration, disabled by default.
+	bool Enabled;
+	//! Largest linear acceleration in g while the hand is still.
+	float StillAcceleration;
+	//! Largest angular speed in radians per second while the hand is still.
+	float StillRotation;
+	//! Time the hand must be still before its velocity is reset to zero.
+	float StillTime;
+	//! Time constant of the high-pass filter on the velocity, lower removes more drift.
+	float VelocityTimeConstant;
+	//! Time constant of the high-pass filter that pulls the position back to the origin.
+	float PositionTimeConstant;
+} GLOVE_PALM_TRACKING;
+
+/*! Configuration of an external tracker mounted on the wrist. */
+typedef struct {
+	//! Pose of the palm relative to the tracker, the position is in the units of the tracker.
+	GLOVE_POSE Mount;
+	//! Units of the tracker per unit of the skeletal model, which is in millimeters.
+	float Scale;
+	//! Microseconds added to the time of a glove sample to find the matching tracker pose.
+	int TimeOffset;
+	//! Weight of the tracker in the orientation at every glove sample, one follows the tracker and lower values let the glove fill in between tracker poses.
+	float OrientationGain;
+	//! Microseconds between a glove sample and the nearest tracker pose before the tracker is considered lost.
+	unsigned int Timeout;
+} GLOVE_TRACKER;
+
+#define GLOVE_THREAD_ROLES 11
+#define GLOVE_THREAD_NAME 32
+
+/*! The threads the SDK runs its work on. */
+typedef enum {
+	//! Watches for gloves being connected and removed.
+	GLOVE_THREAD_DEVICES = 0,
+	//! Bluetooth callbacks that deliver the packets, these threads belong to Windows and are only reported.
+	GLOVE_THREAD_BLUETOOTH,
+	//! Runs the decode stage when it is placed on a dedicated thread.
+	GLOVE_THREAD_DECODE,
+	//! Runs the filter stage when it is placed on a dedicated thread.
+	GLOVE_THREAD_FILTER,
+	//! Runs the skeleton stage when it is placed on a dedicated thread.
+	GLOVE_THREAD_SKELETON,
+	//! Runs the publish stage when it is placed on a dedicated thread.
+	GLOVE_THREAD_PUBLISH,
+	//! Writes recordings to disk.
+	GLOVE_THREAD_RECORDER,
+	//! Receives samples from a stream.
+	GLOVE_THREAD_STREAM,
+	//! Answers the commands of broker readers.
+	GLOVE_THREAD_BROKER,
+	//! Loads hand models in the background.
+	GLOVE_THREAD_LOADER,
+	//! Runs the asynchronous commands such as vibration.
+	GLOVE_THREAD_COMMANDS,
+} GLOVE_THREAD_ROLE;
+
+/*! Scheduling priority of a thread. */
+typedef enum {
+	//! Leave the priority as it is.
+	GLOVE_PRIORITY_DEFAULT = 0,
+	GLOVE_PRIORITY_IDLE,
+	GLOVE_PRIORITY_LOWEST,
+	GLOVE_PRIORITY_BELOW_NORMAL,
+	GLOVE_PRIORITY_NORMAL,
+	GLOVE_PRIORITY_ABOVE_NORMAL,
+	GLOVE_PRIORITY_HIGHEST,
+	GLOVE_PRIORITY_TIME_CRITICAL,
+} GLOVE_THREAD_PRIORITY;
+
+/*! Configuration of the threads with the same role. */
+typedef struct {
+	//! Processors the threads may run on as a bit mask, zero leaves the affinity as it is.
+	unsigned long long Affinity;
+	//! Scheduling priority of the threads.
+	GLOVE_THREAD_PRIORITY Priority;
+	//! Name shown in debuggers and profilers, empty for the default name.
+	char Name[GLOVE_THREAD_NAME];
+} GLOVE_THREAD_CONFIG;
+
+/*! A thread the SDK runs its work on. */
+typedef struct {
+	GLOVE_THREAD_ROLE Role;
+	//! Identifier of the thread in the operating system.
+	unsigned int Id;
+	//! Processors the thread may run on as a bit mask.
+	unsigned long long Affinity;
+	//! Current scheduling priority of the thread.
+	GLOVE_THREAD_PRIORITY Priority;
+	//! Processor time used by the thread so far in microseconds.
+	unsigned long long CpuTime;
+	//! Name of the thread, empty if it has none.
+	char Name[GLOVE_THREAD_NAME];
+} GLOVE_THREAD_INFO;
+
+/*! State of the hand model of a glove. */
+typedef enum {
+	//! The embedded hand model is used.
+	GLOVE_MODEL_DEFAULT = 0,
+	//! A hand model is being loaded in the background.
+	GLOVE_MODEL_LOADING,
+	//! The last hand model that was loaded is used.
+	GLOVE_MODEL_LOADED,
+	//! The last hand model couldn't be loaded, the previous model is still used.
+	GLOVE_MODEL_FAILED,
+} GLOVE_MODEL_STATE;
+
+/*! Status of the hand model of a glove. */
+typedef struct {
+	GLOVE_MODEL_STATE State;
+	//! Incremented every time the hand model is replaced.
+	unsigned int Generation;
+} GLOVE_MODEL_STATUS;
+
+/*! Subsystems that can be enabled with ManusInitEx. */
+#define GLOVE_FEATURE_SKELETAL  0x01
+#define GLOVE_FEATURE_FUSION    0x02
+#define GLOVE_FEATURE_RECORDING 0x04
+#define GLOVE_FEATURE_STREAMING 0x08
+#define GLOVE_FEATURE_HOTPLUG   0x10
+#define GLOVE_FEATURE_ALL       0x1F
+
+/*! Options for initializing the SDK. */
+typedef struct {
+	//! Combination of GLOVE_FEATURE flags, the functions of the other features fail with MANUS_ERROR.
+	unsigned int Features;
+	//! Start the enabled subsystems during initialization instead of the first time they are used.
+	bool Preload;
+} GLOVE_INIT_OPTIONS;
+
+/*! Capacity of a Bluetooth adapter, the gloves are balanced over the adapters within it. */
+typedef struct {
+	//! Number of gloves the adapter can keep connected.
+	unsigned int Connections;
+	//! Reports per second the adapter can deliver over all of its connections.
+	float Bandwidth;
+} GLOVE_ADAPTER_CAPACITY;
+
+/*! Load of a Bluetooth adapter. */
+typedef struct {
+	GLOVE_ADAPTER_CAPACITY Capacity;
+	//! Number of gloves connected through the adapter.
+	unsigned int Gloves;
+	//! Reports per second the gloves send, including the ones that are lost.
+	float Demand;
+	//! Fraction of the reports of the gloves that is lost.
+	float Loss;
+	//! The larger of the fractions of the connections and the bandwidth in use.
+	float Load;
+	//! The adapter is over its capacity or loses too many reports.
+	bool Saturated;
+	//! Number of gloves moved to another adapter to relieve this one.
+	unsigned int Migrations;
+} GLOVE_ADAPTER_INFO;
+
 /*! Indicates which hand is being queried for.  */
 typedef enum {
 	GLOVE_LEFT = 0,
@@ -102,6 +492,27 @@ extern "C" {
 	*/
 	MANUS_API int ManusInit();
 
+	/*! \brief Initialize the Manus SDK with a selection of features.
+	*
+	*  Applications that only need part of the SDK can leave out the other
+	*  features, which saves their startup time and memory. Without
+	*  preloading every subsystem is started the first time it is used,
+	*  the hand model for example is built by the first call that needs a
+	*  skeletal model.
+	*
+	*  GLOVE_FEATURE_SKELETAL: skeletal models, rigs and hand models.
+	*  GLOVE_FEATURE_FUSION: external trackers.
+	*  GLOVE_FEATURE_RECORDING: recording samples to a file.
+	*  GLOVE_FEATURE_STREAMING: streaming over the network and the broker.
+	*  GLOVE_FEATURE_HOTPLUG: picking up gloves paired after initialization.
+	*
+	*  Can be called instead of ManusInit, which enables every feature and
+	*  preloads them.
+	*
+	*  \param options The options, or nullptr for the behavior of ManusInit.
+	*/
+	MANUS_API int ManusInitEx(const GLOVE_INIT_OPTIONS* options);
+
 	/*! \brief Shutdown the Manus SDK.
 	*
 	*  Must be called when the SDK is no longer
@@ -177,4 +588,963 @@ extern "C" {
 
 /**@}*/
 
+/**
+* \defgroup Streaming Network Streaming
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Start streaming the gloves over the network.
+	*
+	*  Every sample of every glove connected to this machine is sent
+	*  as a UDP packet as soon as it is received. The address can be a
+	*  unicast, loopback or multicast IPv4 address.
+	*
+	*  \param address The address to send the samples to (ex. "239.0.0.1").
+	*  \param port The UDP port to send the samples to.
+	*/
+	MANUS_API int ManusStreamStart(const char* address, unsigned short port);
+
+	/*! \brief Stop streaming the gloves over the network.
+	*/
+	MANUS_API int ManusStreamStop();
+
+	/*! \brief Start receiving gloves streamed by another machine.
+	*
+	*  This does not require ManusInit to be called.
+	*
+	*  \param address The multicast group to join or the local address to listen on.
+	*  \param port The UDP port the samples are sent to.
+	*/
+	MANUS_API int ManusStreamConnect(const char* address, unsigned short port);
+
+	/*! \brief Stop receiving gloves from the network.
+	*/
+	MANUS_API int ManusStreamDisconnect();
+
+	/*! \brief Get the state of a glove on the network.
+	*
+	*  Works like ManusGetData for the gloves received with ManusStreamConnect.
+	*
+	*  \param hand The left or right hand index.
+	*  \param data Output variable to receive the data.
+	*  \param timeout Milliseconds to wait until the glove returns a value.
+	*/
+	MANUS_API int ManusStreamGetData(GLOVE_HAND hand, GLOVE_DATA* data, unsigned int timeout = 0);
+
+	/*! \brief Get a skeletal model for a glove on the network.
+	*
+	*  Works like ManusGetSkeletal for the gloves received with ManusStreamConnect.
+	*
+	*  \param hand The left or right hand index.
+	*  \param model The glove skeletal model.
+	*/
+	MANUS_API int ManusStreamGetSkeletal(GLOVE_HAND hand, GLOVE_SKELETAL* model, unsigned int timeout = 0);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Broker Multi-process Broker
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Share the gloves of this process with other processes.
+	*
+	*  Every sample is published into a shared memory region which other
+	*  processes on this machine can read with ManusBrokerAttach. Only one
+	*  process can be the broker at a time.
+	*
+	*  Must be called after ManusInit.
+	*/
+	MANUS_API int ManusBrokerStart();
+
+	/*! \brief Stop sharing the gloves with other processes.
+	*/
+	MANUS_API int ManusBrokerStop();
+
+	/*! \brief Initialize the Manus SDK as a client of a broker.
+	*
+	*  Use this instead of ManusInit in processes that don't own the gloves.
+	*  ManusGetData and ManusGetSkeletal then read from the broker without
+	*  taking locks, and ManusSetVibration is forwarded to the broker.
+	*  Changing the handedness or calibrating is only possible in the broker.
+	*
+	*  ManusExit must be called when the SDK is no longer needed.
+	*/
+	MANUS_API int ManusBrokerAttach();
+
+	/*! \brief Read every sample published since the last call.
+	*
+	*  Intended for consumers such as recorders that must not miss samples.
+	*  Only the most recent samples are kept by the broker, so a reader that
+	*  falls too far behind skips the oldest ones.
+	*
+	*  \param hand The left or right hand index.
+	*  \param cursor Position in the stream, initialize to zero and pass it back unchanged.
+	*  \param data Array to receive the samples.
+	*  \param count Size of the array.
+	*  \param read Output variable to receive the number of samples read.
+	*/
+	MANUS_API int ManusBrokerRead(GLOVE_HAND hand, unsigned int* cursor, GLOVE_DATA* data, unsigned int count, unsigned int* read);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Recording Recording
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Record the raw reports of a glove to a file.
+	*
+	*  The reports are stored losslessly in compressed blocks that can be
+	*  decoded independently. Recording continues until ManusRecordStop
+	*  or ManusExit is called.
+	*
+	*  \param hand The left or right hand index.
+	*  \param path Path of the file to write, an existing file is overwritten.
+	*/
+	MANUS_API int ManusRecordStart(GLOVE_HAND hand, const char* path);
+
+	/*! \brief Stop recording a glove and close the file.
+	*
+	*  \param hand The left or right hand index.
+	*/
+	MANUS_API int ManusRecordStop(GLOVE_HAND hand);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Profile Finger Calibration Profiles
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Get the finger calibration profile of a glove.
+	*
+	*  A glove uses a linear response over the whole sensor range until a
+	*  profile is set. Use this to get a profile to modify.
+	*
+	*  \param hand The left or right hand index.
+	*  \param profile Output variable to receive the profile.
+	*/
+	MANUS_API int ManusGetProfile(GLOVE_HAND hand, GLOVE_PROFILE* profile);
+
+	/*! \brief Set the finger calibration profile of a glove.
+	*
+	*  The profile is applied to every sample from then on, at no extra
+	*  cost per sample.
+	*
+	*  \param hand The left or right hand index.
+	*  \param profile The profile, or nullptr to restore the default.
+	*/
+	MANUS_API int ManusSetProfile(GLOVE_HAND hand, const GLOVE_PROFILE* profile);
+
+	/*! \brief Load a finger calibration profile from a file and set it on a glove.
+	*
+	*  \param hand The left or right hand index.
+	*  \param path Path of a profile saved with ManusSaveProfile.
+	*/
+	MANUS_API int ManusLoadProfile(GLOVE_HAND hand, const char* path);
+
+	/*! \brief Save the finger calibration profile of a glove to a file.
+	*
+	*  \param hand The left or right hand index.
+	*  \param path Path of the file to write, an existing file is overwritten.
+	*/
+	MANUS_API int ManusSaveProfile(GLOVE_HAND hand, const char* path);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Filter Adaptive Filter
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Get the filtered state of a glove.
+	*
+	*  Same as ManusGetData, but the fingers and orientation are smoothed by
+	*  an adaptive filter which removes jitter without adding lag to fast
+	*  movements. The acceleration is not filtered.
+	*
+	*  \param hand The left or right hand index.
+	*  \param data Output variable to receive the data.
+	*  \param timeout Milliseconds to wait until the glove returns a value.
+	*/
+	MANUS_API int ManusGetFilteredData(GLOVE_HAND hand, GLOVE_DATA* data, unsigned int timeout = 0);
+
+	/*! \brief Get the parameters of the adaptive filter of a glove.
+	*
+	*  \param hand The left or right hand index.
+	*  \param filter Output variable to receive the parameters.
+	*/
+	MANUS_API int ManusGetFilter(GLOVE_HAND hand, GLOVE_FILTER* filter);
+
+	/*! \brief Set the parameters of the adaptive filter of a glove.
+	*
+	*  \param hand The left or right hand index.
+	*  \param filter The parameters, or nullptr to restore the defaults.
+	*  \return MANUS_INVALID_ARGUMENT if a parameter is out of range, NaN or infinite.
+	*/
+	MANUS_API int ManusSetFilter(GLOVE_HAND hand, const GLOVE_FILTER* filter);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Frames Time-aligned Frames
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Get the current time of the SDK clock.
+	*
+	*  All timestamps in the SDK use this clock.
+	*
+	*  \param time Output variable to receive the time in microseconds.
+	*/
+	MANUS_API int ManusGetTime(unsigned long long* time);
+
+	/*! \brief Get the data of both hands at a point in time.
+	*
+	*  The samples of each glove are interpolated to the requested time,
+	*  with a slerp for the orientation. Calling this with evenly spaced
+	*  times resamples both hands to a fixed rate. Recent samples are kept
+	*  for a few seconds, and the newest sample is returned when the time
+	*  is ahead of the glove.
+	*
+	*  \param time Time of the frame on the SDK clock, see ManusGetTime.
+	*  \param frame Output variable to receive the frame.
+	*  \param timeout Milliseconds to wait until every connected hand has a sample after the time.
+	*/
+	MANUS_API int ManusGetFrame(unsigned long long time, GLOVE_FRAME* frame, unsigned int timeout = 0);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Palette Bone Palette
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Get the skeletal model as a palette of bone matrices.
+	*
+	*  Writes one matrix per bone in the layout, in the order of the layout
+	*  and converted to its axis convention, so the palette can be uploaded
+	*  for skinning as is. Flipping an odd number of axes converts between
+	*  left- and right-handed coordinates. The matrices are stored one after
+	*  another, so a 16-byte aligned palette has every matrix aligned.
+	*
+	*  This function is thread-safe.
+	*
+	*  \param hand The left or right hand index.
+	*  \param layout The layout of the palette.
+	*  \param palette Output buffer of 12 or 16 floats per bone depending on the format.
+	*/
+	MANUS_API int ManusGetPalette(GLOVE_HAND hand, const GLOVE_PALETTE_LAYOUT* layout, float* palette, unsigned int timeout = 0);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Ring Shared Sample Ring
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Let the SDK write every sample of a glove directly into a buffer of the caller.
+	*
+	*  The SDK writes sample n, counting from 1, into entries[(n - 1) % capacity]
+	*  as soon as it arrives and then stores n in the counter. To read the
+	*  newest sample, read the counter, copy the entry and check that its
+	*  sequence equals twice the number of the sample both before and after
+	*  copying. A different sequence means the entry was overwritten while
+	*  it was read.
+	*
+	*  This lets managed code pin a buffer once and read any number of
+	*  samples without a call into the SDK. The buffers must stay valid
+	*  until ManusUnregisterRing or ManusExit returns. Registering a new
+	*  ring replaces the previous one and restarts the counter.
+	*
+	*  \param hand The left or right hand index.
+	*  \param entries Buffer of capacity entries.
+	*  \param capacity Number of entries in the buffer.
+	*  \param counter Receives the number of samples written.
+	*  \param contents Combination of GLOVE_RING_DATA and GLOVE_RING_SKELETAL.
+	*/
+	MANUS_API int ManusRegisterRing(GLOVE_HAND hand, GLOVE_RING_ENTRY* entries, unsigned int capacity,
+		unsigned long long* counter, unsigned int contents = GLOVE_RING_DATA | GLOVE_RING_SKELETAL);
+
+	/*! \brief Stop writing into the ring of a glove.
+	*
+	*  The SDK no longer touches the buffers once this function returns.
+	*
+	*  \param hand The left or right hand index.
+	*/
+	MANUS_API int ManusUnregisterRing(GLOVE_HAND hand);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Gestures Gesture Recognition
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Add a gesture template to a glove.
+	*
+	*  Every packet from the glove is matched against the templates as soon
+	*  as it is decoded. The nearest matching template starts its gesture,
+	*  which lasts until the hand moves clearly away from it, so events are
+	*  timed to the packet that caused them.
+	*
+	*  \param hand The left or right hand index.
+	*  \param gesture The template to add.
+	*/
+	MANUS_API int ManusAddGesture(GLOVE_HAND hand, const GLOVE_GESTURE* gesture);
+
+	/*! \brief Remove every template of a gesture.
+	*
+	*  \param hand The left or right hand index.
+	*  \param id Identifier of the gesture, or GLOVE_GESTURE_NONE to remove all gestures.
+	*/
+	MANUS_API int ManusRemoveGesture(GLOVE_HAND hand, unsigned int id);
+
+	/*! \brief Get the gesture that is currently active.
+	*
+	*  \param hand The left or right hand index.
+	*  \param id Output variable to receive the identifier, GLOVE_GESTURE_NONE when no gesture is active.
+	*/
+	MANUS_API int ManusGetGesture(GLOVE_HAND hand, unsigned int* id);
+
+	/*! \brief Take the oldest gesture event from the queue of a glove.
+	*
+	*  The queue keeps the most recent events, so it should be polled
+	*  regularly. Returns MANUS_ERROR when the queue is empty.
+	*
+	*  \param hand The left or right hand index.
+	*  \param event Output variable to receive the event.
+	*/
+	MANUS_API int ManusPollGesture(GLOVE_HAND hand, GLOVE_GESTURE_EVENT* event);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Pipeline Sample Pipeline
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Get the configuration of the sample pipeline.
+	*
+	*  \param pipeline Output variable to receive the configuration.
+	*/
+	MANUS_API int ManusGetPipeline(GLOVE_PIPELINE* pipeline);
+
+	/*! \brief Configure the sample pipeline.
+	*
+	*  Every packet passes through the stages in GLOVE_STAGE. Stages that
+	*  aren't inline are fed by a bounded lock-free queue per glove, which
+	*  keeps the Bluetooth callback short and lets the stages of many
+	*  gloves overlap on different cores. By default every stage runs
+	*  inline and the skeleton is skipped, in which case ManusGetSkeletal
+	*  simulates the model on the calling thread.
+	*
+	*  Must be called before ManusInit.
+	*
+	*  \param pipeline The configuration, or nullptr to restore the default.
+	*/
+	MANUS_API int ManusSetPipeline(const GLOVE_PIPELINE* pipeline);
+
+	/*! \brief Run the stages placed on the caller thread.
+	*
+	*  Processes every packet queued in front of those stages.
+	*
+	*  \param processed Optional output variable to receive the number of packets processed.
+	*/
+	MANUS_API int ManusPumpPipeline(unsigned int* processed = nullptr);
+
+	/*! \brief Get the timing counters of a pipeline stage.
+	*
+	*  The counters accumulate over all gloves since ManusInit.
+	*
+	*  \param stage The pipeline stage.
+	*  \param stats Output variable to receive the counters.
+	*/
+	MANUS_API int ManusGetStageStats(GLOVE_STAGE stage, GLOVE_STAGE_STATS* stats);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Retargeting Rig Retargeting
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Register a rig to retarget the skeletal model of a hand to.
+	*
+	*  The mapping from the skeletal model to the rig is computed once from
+	*  the rest poses, including the change of axes and the fixed rotations
+	*  of the model, so every pose of the rig is a single rotation of a
+	*  bone of the model. Bones that aren't driven follow their parent.
+	*
+	*  Must be called after ManusInit.
+	*
+	*  \param hand The left or right hand index.
+	*  \param rig Description of the rig.
+	*  \param id Output variable to receive the identifier of the rig.
+	*/
+	MANUS_API int ManusRegisterRig(GLOVE_HAND hand, const GLOVE_RIG* rig, unsigned int* id);
+
+	/*! \brief Remove a rig registered with ManusRegisterRig.
+	*
+	*  \param id The identifier of the rig.
+	*/
+	MANUS_API int ManusUnregisterRig(unsigned int id);
+
+	/*! \brief Get the skeletal model of the hand of a rig as poses of the rig.
+	*
+	*  This function is thread-safe.
+	*
+	*  \param id The identifier of the rig.
+	*  \param poses Output buffer of one pose per bone of the rig, in the order of the rig.
+	*/
+	MANUS_API int ManusGetRigPose(unsigned int id, GLOVE_POSE* poses, unsigned int timeout = 0);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup ImuCalibration Accelerometer Calibration
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Start a host-side calibration of the accelerometer.
+	*
+	*  Slowly turn the hand through as many orientations as possible,
+	*  pausing briefly in each. Every still sample updates the fit, the
+	*  samples themselves aren't kept. The current correction stays in
+	*  effect until the calibration is stopped.
+	*
+	*  \param hand The left or right hand index.
+	*/
+	MANUS_API int ManusStartImuCalibration(GLOVE_HAND hand);
+
+	/*! \brief Get the progress of the calibration and the fit so far.
+	*
+	*  Solving the fit takes a few milliseconds and doesn't hold up the
+	*  glove, so it can be called every frame to guide the user.
+	*
+	*  \param hand The left or right hand index.
+	*  \param status Output variable to receive the progress.
+	*  \param fit Optional output variable to receive the fit, only written when there is one.
+	*/
+	MANUS_API int ManusGetImuCalibrationStatus(GLOVE_HAND hand, GLOVE_IMU_CALIBRATION_STATUS* status, GLOVE_IMU_CALIBRATION* fit = nullptr);
+
+	/*! \brief Stop the calibration of the accelerometer.
+	*
+	*  \param hand The left or right hand index.
+	*  \param apply Apply the fit to the acceleration, fails when there is no fit yet.
+	*/
+	MANUS_API int ManusStopImuCalibration(GLOVE_HAND hand, bool apply);
+
+	/*! \brief Get the correction applied to the accelerometer.
+	*
+	*  \param hand The left or right hand index.
+	*  \param calibration Output variable to receive the correction.
+	*/
+	MANUS_API int ManusGetImuCalibration(GLOVE_HAND hand, GLOVE_IMU_CALIBRATION* calibration);
+
+	/*! \brief Set the correction applied to the accelerometer.
+	*
+	*  \param hand The left or right hand index.
+	*  \param calibration The correction, or nullptr to remove it.
+	*/
+	MANUS_API int ManusSetImuCalibration(GLOVE_HAND hand, const GLOVE_IMU_CALIBRATION* calibration);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Link Link Quality
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Get the quality of the Bluetooth link of a glove.
+	*
+	*  The counters accumulate since the glove was found. Reading them
+	*  only loads a few counters, so it can be polled every frame.
+	*
+	*  \param hand The left or right hand index.
+	*  \param stats Output variable to receive the statistics.
+	*/
+	MANUS_API int ManusGetLinkStats(GLOVE_HAND hand, GLOVE_LINK_STATS* stats);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Palm Palm Position Tracking
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Get the parameters of the palm position tracking of a glove.
+	*
+	*  \param hand The left or right hand index.
+	*  \param tracking Output variable to receive the parameters.
+	*/
+	MANUS_API int ManusGetPalmTracking(GLOVE_HAND hand, GLOVE_PALM_TRACKING* tracking);
+
+	/*! \brief Set the parameters of the palm position tracking of a glove.
+	*
+	*  The position of the palm is estimated by integrating the linear
+	*  acceleration, which follows short movements of the hand. Drift is
+	*  kept in check by stopping the hand whenever it is held still, and
+	*  the position slowly returns to the origin. When enabled, the
+	*  skeletal model is moved by the position of the palm.
+	*
+	*  \param hand The left or right hand index.
+	*  \param tracking The parameters, or nullptr to restore the defaults.
+	*/
+	MANUS_API int ManusSetPalmTracking(GLOVE_HAND hand, const GLOVE_PALM_TRACKING* tracking);
+
+	/*! \brief Get the position of the palm.
+	*
+	*  \param hand The left or right hand index.
+	*  \param position Output variable to receive the position in meters, in the world axes of the orientation.
+	*/
+	MANUS_API int ManusGetPalmPosition(GLOVE_HAND hand, GLOVE_VECTOR* position);
+
+	/*! \brief Move the palm back to the origin.
+	*
+	*  \param hand The left or right hand index.
+	*/
+	MANUS_API int ManusResetPalmPosition(GLOVE_HAND hand);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Tracker External Tracker
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Get the configuration of the external tracker of a glove.
+	*
+	*  \param hand The left or right hand index.
+	*  \param tracker Output variable to receive the configuration.
+	*/
+	MANUS_API int ManusGetTracker(GLOVE_HAND hand, GLOVE_TRACKER* tracker);
+
+	/*! \brief Set the configuration of the external tracker of a glove.
+	*
+	*  Changing the configuration forgets the poses pushed so far.
+	*
+	*  \param hand The left or right hand index.
+	*  \param tracker The configuration, or nullptr to restore the defaults.
+	*/
+	MANUS_API int ManusSetTracker(GLOVE_HAND hand, const GLOVE_TRACKER* tracker);
+
+	/*! \brief Push a pose of the external tracker on the wrist.
+	*
+	*  Every glove sample is matched with the tracker pose at the same time,
+	*  interpolated between the pushed poses, so poses may arrive at any
+	*  rate. Poses older than the newest pushed pose are ignored.
+	*
+	*  \param hand The left or right hand index.
+	*  \param time Time the pose was measured on the SDK clock, see ManusGetTime.
+	*  \param pose The pose of the tracker in the world, in the axes of the skeletal model.
+	*/
+	MANUS_API int ManusPushTrackerPose(GLOVE_HAND hand, unsigned long long time, const GLOVE_POSE* pose);
+
+	/*! \brief Get the skeletal model of a glove in the world of the tracker.
+	*
+	*  The palm is placed on the tracker, and its orientation fuses the
+	*  tracker with the orientation of the glove. The glove corrects the
+	*  orientation between tracker poses, while the tracker corrects the
+	*  drift of the glove.
+	*
+	*  \param hand The left or right hand index.
+	*  \param model The model to receive the poses in the world of the tracker.
+	*  \param timeout Milliseconds to wait until the glove data is available.
+	*  \return MANUS_ERROR when no tracker pose is close to the glove sample.
+	*/
+	MANUS_API int ManusGetWorldSkeletal(GLOVE_HAND hand, GLOVE_SKELETAL* model, unsigned int timeout = 0);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Threads Threads
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Get the configuration of the threads with a role.
+	*
+	*  \param role The role of the threads.
+	*  \param config Output variable to receive the configuration.
+	*/
+	MANUS_API int ManusGetThreadConfig(GLOVE_THREAD_ROLE role, GLOVE_THREAD_CONFIG* config);
+
+	/*! \brief Set the configuration of the threads with a role.
+	*
+	*  The configuration is applied to the running threads right away and
+	*  to every thread with the role that starts later, so it may be set
+	*  before ManusInit. The Bluetooth threads belong to Windows, which runs
+	*  other work on them as well, so they only accept the default and are
+	*  never changed. To keep the other work off these threads, place the
+	*  pipeline stages on dedicated threads.
+	*
+	*  \param role The role of the threads.
+	*  \param config The configuration, or nullptr to restore the defaults.
+	*  \return MANUS_INVALID_ARGUMENT if the affinity includes processors the process may not run on, or if the Bluetooth threads are given anything but the default.
+	*/
+	MANUS_API int ManusSetThreadConfig(GLOVE_THREAD_ROLE role, const GLOVE_THREAD_CONFIG* config);
+
+	/*! \brief Get the threads the SDK runs its work on.
+	*
+	*  \param threads Array to receive the threads.
+	*  \param count Size of the array.
+	*  \param total Output variable to receive the number of threads, which may exceed the size of the array.
+	*/
+	MANUS_API int ManusGetThreads(GLOVE_THREAD_INFO* threads, unsigned int count, unsigned int* total);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Models Hand Models
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Load a hand model from a file in the background.
+	*
+	*  The model replaces the current model of the hand once it is loaded,
+	*  without interrupting the skeletal models being simulated meanwhile.
+	*  The file has to be in a format the FBX SDK imports, such as FBX,
+	*  and contain the bones and finger animations of the embedded model
+	*  under the same names. Use ManusGetHandModelStatus to see when the
+	*  model is in use.
+	*
+	*  \param hand The left or right hand index.
+	*  \param path Path of the hand model.
+	*/
+	MANUS_API int ManusLoadHandModel(GLOVE_HAND hand, const char* path);
+
+	/*! \brief Load a hand model from an FBX file in memory in the background.
+	*
+	*  \param hand The left or right hand index.
+	*  \param data Contents of the FBX file, copied before this returns.
+	*  \param size Size of the contents in bytes.
+	*/
+	MANUS_API int ManusLoadHandModelFromMemory(GLOVE_HAND hand, const void* data, unsigned int size);
+
+	/*! \brief Switch back to the embedded hand model.
+	*
+	*  Loads of the hand that haven't finished are cancelled.
+	*
+	*  \param hand The left or right hand index.
+	*/
+	MANUS_API int ManusResetHandModel(GLOVE_HAND hand);
+
+	/*! \brief Get the status of the hand model of a glove.
+	*
+	*  \param hand The left or right hand index.
+	*  \param status Output variable to receive the status.
+	*/
+	MANUS_API int ManusGetHandModelStatus(GLOVE_HAND hand, GLOVE_MODEL_STATUS* status);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Async Asynchronous Access
+* @{
+*/
+
+/*! \brief Called with every new sample of a glove.
+*
+*  \param sample The sample, only valid during the call. Its sequence counts the samples delivered to the callbacks of the hand.
+*  \param context The context given when the callback was registered.
+*/
+typedef void(*GLOVE_SAMPLE_CALLBACK)(GLOVE_HAND hand, const GLOVE_RING_ENTRY* sample, void* context);
+
+/*! \brief Called when an asynchronous command is done.
+*
+*  \param result The value the synchronous function would have returned.
+*  \param context The context given with the command.
+*/
+typedef void(*GLOVE_COMPLETION_CALLBACK)(int result, void* context);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Register a callback that is called with every new sample of a glove.
+	*
+	*  The callback runs on the thread that publishes the samples, right
+	*  after they are decoded, so it must return quickly. Together with
+	*  the asynchronous commands this lets event loops and coroutines use
+	*  the gloves without blocking a thread, see ManusAsync.h.
+	*
+	*  \param hand The left or right hand index.
+	*  \param callback The function to call.
+	*  \param context Passed to the callback unchanged.
+	*  \param contents Combination of GLOVE_RING_DATA and GLOVE_RING_SKELETAL, the skeletal model is only simulated when asked for.
+	*  \param id Output variable to receive the identifier of the callback.
+	*/
+	MANUS_API int ManusRegisterSampleCallback(GLOVE_HAND hand, GLOVE_SAMPLE_CALLBACK callback, void* context,
+		unsigned int contents, unsigned int* id);
+
+	/*! \brief Unregister a sample callback.
+	*
+	*  Once this returns the callback is no longer running and won't be
+	*  called again, unless this is called from the callback itself.
+	*
+	*  \param id The identifier of the callback.
+	*/
+	MANUS_API int ManusUnregisterSampleCallback(unsigned int id);
+
+	/*! \brief Set the output power of the vibration motor without waiting for the glove.
+	*
+	*  \param hand The left or right hand index.
+	*  \param power The power of the vibration motor ranging from 0 to 1.
+	*  \param callback Called on a background thread when the glove was written, may be nullptr.
+	*  \param context Passed to the callback unchanged.
+	*/
+	MANUS_API int ManusSetVibrationAsync(GLOVE_HAND hand, float power,
+		GLOVE_COMPLETION_CALLBACK callback = nullptr, void* context = nullptr);
+
+	/*! \brief Calibrate the IMU on the glove without waiting for the glove.
+	*
+	*  See ManusCalibrate.
+	*
+	*  \param hand The left or right hand index.
+	*  \param callback Called on a background thread when the glove was written, may be nullptr.
+	*  \param context Passed to the callback unchanged.
+	*/
+	MANUS_API int ManusCalibrateAsync(GLOVE_HAND hand, bool gyro, bool accel, bool fingers,
+		GLOVE_COMPLETION_CALLBACK callback = nullptr, void* context = nullptr);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Tracing Tracing
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Enable or disable recording trace events.
+	*
+	*  The SDK records an event for the Bluetooth notifications, the reads
+	*  of the characteristics, every stage of the pipeline, waiting for the
+	*  data of a glove and the simulation of the skeletal model. Each thread
+	*  keeps its most recent events, so a trace can be written right after
+	*  a hitch. Recording an event takes tens of nanoseconds, while tracing
+	*  is disabled it costs next to nothing.
+	*
+	*  \param enabled True to record trace events.
+	*  \return MANUS_ERROR when the SDK was built without tracing.
+	*/
+	MANUS_API int ManusSetTracing(bool enabled);
+
+	/*! \brief Leave the events recorded so far out of the next trace that is written. */
+	MANUS_API int ManusClearTrace();
+
+	/*! \brief Write the recorded trace events to a file.
+	*
+	*  The file is in the Chrome trace event format, which can be opened in
+	*  chrome://tracing or the Perfetto UI. Recording continues while the
+	*  trace is written.
+	*
+	*  \param path Path of the file to write.
+	*/
+	MANUS_API int ManusWriteTrace(const char* path);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup History Pose History
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Keep the poses of a glove for looking them up later.
+	*
+	*  Meant for server code that needs to know where a hand was in the
+	*  past, for example to validate hits or roll back a networked
+	*  simulation. The history takes memory for the samples of the whole
+	*  retention, changing it clears the history. No history is kept by
+	*  default.
+	*
+	*  \param hand The left or right hand index.
+	*  \param retention Milliseconds of samples to keep up to a minute, zero to stop keeping them.
+	*/
+	MANUS_API int ManusSetHistory(GLOVE_HAND hand, unsigned int retention);
+
+	/*! \brief Get the time span covered by the history of a glove.
+	*
+	*  \param hand The left or right hand index.
+	*  \param oldest Output variable to receive the time of the oldest sample, see ManusGetTime.
+	*  \param newest Output variable to receive the time of the newest sample.
+	*  \return MANUS_ERROR when the history is empty.
+	*/
+	MANUS_API int ManusGetHistoryRange(GLOVE_HAND hand, unsigned long long* oldest, unsigned long long* newest);
+
+	/*! \brief Get the state of a glove at a point in the past.
+	*
+	*  The samples around the time are interpolated, with a slerp for the
+	*  orientation. Times after the newest sample return the newest sample.
+	*
+	*  \param hand The left or right hand index.
+	*  \param time Time on the SDK clock, see ManusGetTime.
+	*  \param data Output variable to receive the data.
+	*  \return MANUS_ERROR when the time is before the oldest sample in the history.
+	*/
+	MANUS_API int ManusGetDataAt(GLOVE_HAND hand, unsigned long long time, GLOVE_DATA* data);
+
+	/*! \brief Get the skeletal model of a glove at a point in the past.
+	*
+	*  The model is simulated from the interpolated data of the glove with
+	*  the current hand model, and moved to the tracked position of the palm.
+	*
+	*  \param hand The left or right hand index.
+	*  \param time Time on the SDK clock, see ManusGetTime.
+	*  \param model Output variable to receive the skeletal model.
+	*  \return MANUS_ERROR when the time is before the oldest sample in the history.
+	*/
+	MANUS_API int ManusGetSkeletalAt(GLOVE_HAND hand, unsigned long long time, GLOVE_SKELETAL* model);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+/**
+* \defgroup Adapters Bluetooth Adapters
+* @{
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+	/*! \brief Get the Bluetooth adapters the gloves are connected through.
+	*
+	*  A glove that is paired with several adapters is connected through
+	*  one of them, chosen by the load of the adapters. While the SDK runs,
+	*  a glove is moved to another adapter when its adapter saturates.
+	*
+	*  \param adapters Array to receive the adapters.
+	*  \param count Size of the array.
+	*  \param total Output variable to receive the number of adapters, which may exceed the size of the array.
+	*/
+	MANUS_API int ManusGetAdapters(GLOVE_ADAPTER_INFO* adapters, unsigned int count, unsigned int* total);
+
+	/*! \brief Set the capacity of a Bluetooth adapter.
+	*
+	*  The default capacity suits a typical adapter, set it when an
+	*  adapter is known to handle more or fewer gloves.
+	*
+	*  \param adapter Index of the adapter as returned by ManusGetAdapters.
+	*  \param capacity The capacity, or nullptr to restore the default.
+	*/
+	MANUS_API int ManusSetAdapterCapacity(unsigned int adapter, const GLOVE_ADAPTER_CAPACITY* capacity);
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
 #endif
@@ -0,0 +1,412 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Manus.h"
+
+#include <mutex>
+#include <vector>
+#include <string.h>
+
+// C++20 coroutines, or the Coroutines TS with /await on Visual Studio 2015 and 2017
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#define MANUS_COROUTINE std
+#elif defined(__cpp_coroutines) || defined(_RESUMABLE_FUNCTIONS_SUPPORTED)
+#if defined(_MSC_VER) && _MSC_VER < 1910
+#include <experimental/resumable>
+#else
+#include <experimental/coroutine>
+#endif
+#define MANUS_COROUTINE std::experimental
+#else
+#error ManusAsync.h needs coroutine support, compile with /await or /std:c++latest
+#endif
+
+/*
+ * Coroutine access to the gloves.
+ *
+ * A Glove registers a sample callback with the SDK and resumes the
+ * coroutines waiting for it straight from that callback, so waiting for
+ * a sample doesn't block a thread:
+ *
+ *   manus::Glove glove(GLOVE_RIGHT);
+ *   manus::Sample sample = co_await glove.NextSample();
+ *
+ * A SampleStream buffers the samples in between, so a coroutine that
+ * reads a stream in a loop sees every sample even when it is busy when
+ * one arrives:
+ *
+ *   manus::SampleStream stream(glove, 64);
+ *   while (co_await stream.Next())
+ *       Process(stream.GetSample());
+ *
+ * Coroutines are resumed on the thread that publishes the samples, which
+ * delays the next sample until they suspend again. Long work should be
+ * moved to a thread of the application first.
+ */
+namespace manus
+{
+	typedef MANUS_COROUTINE::coroutine_handle<> CoroutineHandle;
+
+	/*! A sample of a glove, see GLOVE_RING_ENTRY. */
+	struct Sample
+	{
+		// False if the glove was closed while waiting for the sample
+		bool Valid;
+		GLOVE_HAND Hand;
+		unsigned long long Sequence;
+		unsigned long long Timestamp;
+		GLOVE_DATA Data;
+		// Only simulated when the glove was opened with GLOVE_RING_SKELETAL
+		GLOVE_SKELETAL Skeletal;
+	};
+
+	class SampleStream;
+
+	/*! A glove that coroutines can wait on, must outlive every coroutine waiting on it. */
+	class Glove
+	{
+	public:
+		class SampleAwaiter
+		{
+		private:
+			friend class Glove;
+			Glove& m_glove;
+			CoroutineHandle m_handle;
+			SampleAwaiter* m_next;
+			Sample m_sample;
+
+		public:
+			SampleAwaiter(Glove& glove) : m_glove(glove), m_next(nullptr) { m_sample.Valid = false; }
+
+			bool await_ready() const { return false; }
+
+			bool await_suspend(CoroutineHandle handle)
+			{
+				std::lock_guard<std::mutex> lock(m_glove.m_mutex);
+				if (m_glove.m_closed)
+					return false;
+
+				m_handle = handle;
+				m_next = m_glove.m_waiting;
+				m_glove.m_waiting = this;
+				return true;
+			}
+
+			Sample await_resume() const { return m_sample; }
+		};
+
+		/*! Awaits an asynchronous command, the result is the value the synchronous function returns. */
+		class CommandAwaiter
+		{
+		private:
+			GLOVE_HAND m_hand;
+			bool m_vibration;
+			float m_power;
+			bool m_gyro, m_accel, m_fingers;
+			CoroutineHandle m_handle;
+			int m_result;
+
+			static void Complete(int result, void* context)
+			{
+				CommandAwaiter* awaiter = (CommandAwaiter*)context;
+				awaiter->m_result = result;
+				awaiter->m_handle.resume();
+			}
+
+		public:
+			CommandAwaiter(GLOVE_HAND hand, float power)
+				: m_hand(hand), m_vibration(true), m_power(power), m_gyro(false), m_accel(false), m_fingers(false), m_result(MANUS_ERROR) {}
+			CommandAwaiter(GLOVE_HAND hand, bool gyro, bool accel, bool fingers)
+				: m_hand(hand), m_vibration(false), m_power(0.0f), m_gyro(gyro), m_accel(accel), m_fingers(fingers), m_result(MANUS_ERROR) {}
+
+			bool await_ready() const { return false; }
+
+			bool await_suspend(CoroutineHandle handle)
+			{
+				m_handle = handle;
+
+				// The command may complete before this returns, so the result is stored by the callback
+				int ret = m_vibration ?
+					ManusSetVibrationAsync(m_hand, m_power, &CommandAwaiter::Complete, this) :
+					ManusCalibrateAsync(m_hand, m_gyro, m_accel, m_fingers, &CommandAwaiter::Complete, this);
+				if (ret == MANUS_SUCCESS)
+					return true;
+
+				// Not queued, continue right away with the error
+				m_result = ret;
+				return false;
+			}
+
+			int await_resume() const { return m_result; }
+		};
+
+	private:
+		friend class SampleStream;
+
+		GLOVE_HAND m_hand;
+		unsigned int m_id;
+		bool m_closed;
+		SampleAwaiter* m_waiting;
+		SampleStream* m_streams;
+		std::mutex m_mutex;
+
+		static void OnSample(GLOVE_HAND hand, const GLOVE_RING_ENTRY* entry, void* context);
+		void Close();
+
+	public:
+		/*! \brief Open a glove.
+		*
+		*  \param contents Combination of GLOVE_RING_DATA and GLOVE_RING_SKELETAL, leave out the skeletal model when it isn't used.
+		*/
+		explicit Glove(GLOVE_HAND hand, unsigned int contents = GLOVE_RING_DATA | GLOVE_RING_SKELETAL)
+			: m_hand(hand), m_id(0), m_closed(true), m_waiting(nullptr), m_streams(nullptr)
+		{
+			if (ManusRegisterSampleCallback(hand, &Glove::OnSample, this, contents, &m_id) == MANUS_SUCCESS)
+				m_closed = false;
+		}
+
+		/*! Waiting coroutines are resumed with an invalid sample. */
+		~Glove() { Close(); }
+
+		Glove(const Glove&) = delete;
+		Glove& operator=(const Glove&) = delete;
+
+		GLOVE_HAND GetHand() const { return m_hand; }
+
+		/*! False if the callback couldn't be registered. */
+		bool IsOpen() const { return !m_closed; }
+
+		/*! Wait for the next sample of the glove. */
+		SampleAwaiter NextSample() { return SampleAwaiter(*this); }
+
+		/*! Set the output power of the vibration motor, see ManusSetVibrationAsync. */
+		CommandAwaiter SetVibration(float power) { return CommandAwaiter(m_hand, power); }
+
+		/*! Calibrate the IMU on the glove, see ManusCalibrateAsync. */
+		CommandAwaiter Calibrate(bool gyro = true, bool accel = true, bool fingers = false) { return CommandAwaiter(m_hand, gyro, accel, fingers); }
+	};
+
+	/*
+	 * Buffers the samples of a glove for a single coroutine.
+	 *
+	 * When the buffer is full the oldest sample is dropped, GetDropped
+	 * counts them. Reading the skeletal models of a stream needs a glove
+	 * opened with GLOVE_RING_SKELETAL.
+	 */
+	class SampleStream
+	{
+	public:
+		class NextAwaiter
+		{
+		private:
+			SampleStream& m_stream;
+
+		public:
+			NextAwaiter(SampleStream& stream) : m_stream(stream) {}
+
+			bool await_ready() const { return false; }
+
+			bool await_suspend(CoroutineHandle handle)
+			{
+				std::lock_guard<std::mutex> lock(m_stream.m_glove.m_mutex);
+
+				// Take a buffered sample without suspending
+				if (m_stream.m_count > 0 || m_stream.m_glove.m_closed)
+				{
+					m_stream.Pop();
+					return false;
+				}
+
+				m_stream.m_handle = handle;
+				return true;
+			}
+
+			/*! False once the glove is closed and the buffer is empty. */
+			bool await_resume() const { return m_stream.m_current.Valid; }
+		};
+
+	private:
+		friend class Glove;
+
+		Glove& m_glove;
+		Sample* m_buffer;
+		unsigned int m_capacity;
+		unsigned int m_first;
+		unsigned int m_count;
+		unsigned long long m_dropped;
+		Sample m_current;
+		CoroutineHandle m_handle;
+		SampleStream* m_next;
+
+		// Called with the mutex of the glove held
+		void Push(const Sample& sample)
+		{
+			if (m_count == m_capacity)
+			{
+				m_first = (m_first + 1) % m_capacity;
+				m_count--;
+				m_dropped++;
+			}
+			m_buffer[(m_first + m_count) % m_capacity] = sample;
+			m_count++;
+		}
+
+		void Pop()
+		{
+			if (m_count == 0)
+			{
+				m_current.Valid = false;
+				return;
+			}
+			m_current = m_buffer[m_first];
+			m_first = (m_first + 1) % m_capacity;
+			m_count--;
+		}
+
+	public:
+		/*! \param capacity Number of samples buffered between two reads. */
+		SampleStream(Glove& glove, unsigned int capacity)
+			: m_glove(glove), m_capacity(capacity > 0 ? capacity : 1), m_first(0), m_count(0), m_dropped(0), m_next(nullptr)
+		{
+			m_buffer = new Sample[m_capacity];
+			m_current.Valid = false;
+
+			std::lock_guard<std::mutex> lock(m_glove.m_mutex);
+			m_next = m_glove.m_streams;
+			m_glove.m_streams = this;
+		}
+
+		/*! Must not be destroyed while a coroutine waits on it. */
+		~SampleStream()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_glove.m_mutex);
+				for (SampleStream** stream = &m_glove.m_streams; *stream; stream = &(*stream)->m_next)
+				{
+					if (*stream == this)
+					{
+						*stream = m_next;
+						break;
+					}
+				}
+			}
+			delete[] m_buffer;
+		}
+
+		SampleStream(const SampleStream&) = delete;
+		SampleStream& operator=(const SampleStream&) = delete;
+
+		/*! Wait for the next sample, false once the glove is closed. */
+		NextAwaiter Next() { return NextAwaiter(*this); }
+
+		/*! The sample read by the last call to Next. */
+		const Sample& GetSample() const { return m_current; }
+
+		/*! The skeletal model read by the last call to Next. */
+		const GLOVE_SKELETAL& GetSkeletal() const { return m_current.Skeletal; }
+
+		unsigned long long GetDropped() const { return m_dropped; }
+	};
+
+	inline void Glove::OnSample(GLOVE_HAND hand, const GLOVE_RING_ENTRY* entry, void* context)
+	{
+		Glove* glove = (Glove*)context;
+
+		Sample sample;
+		sample.Valid = true;
+		sample.Hand = hand;
+		sample.Sequence = entry->Sequence;
+		sample.Timestamp = entry->Timestamp;
+		sample.Data = entry->Data;
+		sample.Skeletal = entry->Skeletal;
+
+		// Collect the coroutines to resume, they are resumed outside the lock so they can wait again
+		SampleAwaiter* waiting;
+		std::vector<CoroutineHandle> streams;
+		{
+			std::lock_guard<std::mutex> lock(glove->m_mutex);
+
+			waiting = glove->m_waiting;
+			glove->m_waiting = nullptr;
+
+			for (SampleStream* stream = glove->m_streams; stream; stream = stream->m_next)
+			{
+				stream->Push(sample);
+				if (stream->m_handle)
+				{
+					stream->Pop();
+					streams.push_back(stream->m_handle);
+					stream->m_handle = nullptr;
+				}
+			}
+		}
+
+		while (waiting)
+		{
+			SampleAwaiter* next = waiting->m_next;
+			waiting->m_sample = sample;
+			waiting->m_handle.resume();
+			waiting = next;
+		}
+
+		for (CoroutineHandle handle : streams)
+			handle.resume();
+	}
+
+	inline void Glove::Close()
+	{
+		if (!m_closed)
+			ManusUnregisterSampleCallback(m_id);
+
+		// No callback runs anymore, wake up everyone still waiting
+		SampleAwaiter* waiting;
+		std::vector<CoroutineHandle> streams;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_closed = true;
+			waiting = m_waiting;
+			m_waiting = nullptr;
+
+			for (SampleStream* stream = m_streams; stream; stream = stream->m_next)
+			{
+				if (stream->m_handle)
+				{
+					stream->Pop();
+					streams.push_back(stream->m_handle);
+					stream->m_handle = nullptr;
+				}
+			}
+		}
+
+		while (waiting)
+		{
+			SampleAwaiter* next = waiting->m_next;
+			waiting->m_sample.Valid = false;
+			waiting->m_handle.resume();
+			waiting = next;
+		}
+
+		for (CoroutineHandle handle : streams)
+			handle.resume();
+	}
+}
@@ -63,4 +63,44 @@ GLOVE_QUATERNION ManusMath::QuaternionMultiply(GLOVE_QUATERNION q1, GLOVE_QUATER
 	return result;
 }
 
+GLOVE_QUATERNION ManusMath::QuaternionSlerp(GLOVE_QUATERNION q1, GLOVE_QUATERNION q2, float t) {
+	float cos_theta = q1.w * q2.w + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z;
 
+	// q and -q are the same rotation, take the shortest path
+	float sign = 1.0f;
+	if (cos_theta < 0.0f)
+	{
+		cos_theta = -cos_theta;
+		sign = -1.0f;
+	}
+
+	float w1 = 1.0f - t, w2 = t;
+
+	// Fall back to a linear interpolation when the angle is too small for sin()
+	if (cos_theta < 0.9995f)
+	{
+		float theta = acosf(cos_theta);
+		float sin_theta = sinf(theta);
+		w1 = sinf(w1 * theta) / sin_theta;
+		w2 = sinf(w2 * theta) / sin_theta;
+	}
+	w2 *= sign;
+
+	GLOVE_QUATERNION result;
+	result.w = w1 * q1.w + w2 * q2.w;
+	result.x = w1 * q1.x + w2 * q2.x;
+	result.y = w1 * q1.y + w2 * q2.y;
+	result.z = w1 * q1.z + w2 * q2.z;
+
+	// Only the linear path changes the length
+	float norm = sqrtf(result.w * result.w + result.x * result.x + result.y * result.y + result.z * result.z);
+	if (norm > 0.0f)
+	{
+		result.w /= norm;
+		result.x /= norm;
+		result.y /= norm;
+		result.z /= norm;
+	}
+
+	return result;
+}
@@ -34,6 +34,14 @@ public:
 
 	static GLOVE_QUATERNION QuaternionMultiply(GLOVE_QUATERNION q1, GLOVE_QUATERNION q2);
 
+	/*! \brief Spherical linear interpolation between two quaternions.
+	*
+	*  Takes the shortest path, so q2 may be negated.
+	*
+	*  \param t Interpolation factor, zero returns q1 and one returns q2.
+	*/
+	static GLOVE_QUATERNION QuaternionSlerp(GLOVE_QUATERNION q1, GLOVE_QUATERNION q2, float t);
+
 private:
 	ManusMath();
 };
@@ -0,0 +1,152 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "PalmTracker.h"
+#include "ManusMath.h"
+
+#include <math.h>
+#include <string.h>
+
+PalmTracker::PalmTracker()
+{
+	GetDefault(&m_parameters);
+	Reset();
+}
+
+void PalmTracker::GetDefault(GLOVE_PALM_TRACKING* parameters)
+{
+	parameters->Enabled = false;
+	parameters->StillAcceleration = 0.05f;
+	parameters->StillRotation = 0.5f;
+	parameters->StillTime = 0.1f;
+	parameters->VelocityTimeConstant = 2.0f;
+	parameters->PositionTimeConstant = 5.0f;
+}
+
+bool PalmTracker::IsValid(const GLOVE_PALM_TRACKING& parameters)
+{
+	return parameters.StillAcceleration >= 0.0f && parameters.StillRotation >= 0.0f &&
+		parameters.StillTime >= 0.0f && parameters.VelocityTimeConstant > 0.0f &&
+		parameters.PositionTimeConstant > 0.0f;
+}
+
+void PalmTracker::SetParameters(const GLOVE_PALM_TRACKING& parameters)
+{
+	// Start from the origin when tracking is turned on
+	if (parameters.Enabled && !m_parameters.Enabled)
+		Reset();
+
+	m_parameters = parameters;
+}
+
+void PalmTracker::Reset()
+{
+	m_initialized = false;
+	m_timestamp = 0;
+	m_orientation = { 1.0f, 0.0f, 0.0f, 0.0f };
+	memset(m_acceleration, 0, sizeof(m_acceleration));
+	memset(m_velocity, 0, sizeof(m_velocity));
+	memset(m_position, 0, sizeof(m_position));
+	m_still_time = 0.0f;
+}
+
+void PalmTracker::Update(const GLOVE_DATA& data, uint64_t timestamp, GLOVE_VECTOR* position)
+{
+	if (!m_parameters.Enabled)
+	{
+		memset(position, 0, sizeof(GLOVE_VECTOR));
+		return;
+	}
+
+	float interval = m_initialized && timestamp > m_timestamp ? (timestamp - m_timestamp) / 1000000.0f : 0.0f;
+	m_timestamp = timestamp;
+
+	const GLOVE_QUATERNION& q = data.Quaternion;
+	const GLOVE_QUATERNION previous = m_orientation;
+	m_orientation = q;
+
+	// Nothing to integrate over, keep the position but stop the hand
+	if (!m_initialized || interval <= 0.0f || interval > PALM_MAX_INTERVAL)
+	{
+		m_initialized = true;
+		memset(m_acceleration, 0, sizeof(m_acceleration));
+		memset(m_velocity, 0, sizeof(m_velocity));
+		m_still_time = 0.0f;
+		*position = { m_position[0], m_position[1], m_position[2] };
+		return;
+	}
+
+	// Linear acceleration of the glove, rotated from the glove to the world
+	GLOVE_VECTOR gravity, linear;
+	ManusMath::GetGravity(&gravity, &q);
+	ManusMath::GetLinearAcceleration(&linear, &data.Acceleration, &gravity);
+
+	float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+	float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+	float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+	float acceleration[3] = {
+		PALM_GRAVITY * ((1.0f - 2.0f * (yy + zz)) * linear.x + 2.0f * (xy - wz) * linear.y + 2.0f * (xz + wy) * linear.z),
+		PALM_GRAVITY * (2.0f * (xy + wz) * linear.x + (1.0f - 2.0f * (xx + zz)) * linear.y + 2.0f * (yz - wx) * linear.z),
+		PALM_GRAVITY * (2.0f * (xz - wy) * linear.x + 2.0f * (yz + wx) * linear.y + (1.0f - 2.0f * (xx + yy)) * linear.z),
+	};
+
+	// The hand is still when there is almost no linear acceleration and rotation
+	float magnitude = linear.x * linear.x + linear.y * linear.y + linear.z * linear.z;
+	float dot = fabsf(q.w * previous.w + q.x * previous.x + q.y * previous.y + q.z * previous.z);
+	bool still = magnitude <= m_parameters.StillAcceleration * m_parameters.StillAcceleration &&
+		dot >= cosf(0.5f * m_parameters.StillRotation * interval);
+
+	m_still_time = still ? m_still_time + interval : 0.0f;
+
+	// First-order high-pass filters, pulling towards zero with the time constants
+	float velocity_decay = 1.0f / (1.0f + interval / m_parameters.VelocityTimeConstant);
+	float position_decay = 1.0f / (1.0f + interval / m_parameters.PositionTimeConstant);
+
+	for (int i = 0; i < 3; i++)
+	{
+		// A hand that has been still for a moment has no velocity
+		if (m_still_time >= m_parameters.StillTime)
+			m_velocity[i] = 0.0f;
+		else
+			m_velocity[i] = velocity_decay * (m_velocity[i] + 0.5f * (acceleration[i] + m_acceleration[i]) * interval);
+
+		m_position[i] = position_decay * (m_position[i] + m_velocity[i] * interval);
+		m_acceleration[i] = acceleration[i];
+	}
+
+	*position = { m_position[0], m_position[1], m_position[2] };
+}
+
+void PalmTracker::Translate(const GLOVE_VECTOR& position, GLOVE_SKELETAL* model)
+{
+	// The model swaps the axes of the glove like the orientation in SkeletalModel
+	float x = PALM_MODEL_SCALE * position.y;
+	float y = PALM_MODEL_SCALE * position.z;
+	float z = PALM_MODEL_SCALE * position.x;
+
+	GLOVE_POSE* poses = (GLOVE_POSE*)model;
+	for (int i = 0; i < GLOVE_BONES; i++)
+	{
+		poses[i].position.x += x;
+		poses[i].position.y += y;
+		poses[i].position.z += z;
+	}
+}
@@ -0,0 +1,83 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Manus.h"
+
+#include <inttypes.h>
+
+// Longest interval in seconds that is integrated, a longer gap stops the hand
+#define PALM_MAX_INTERVAL 0.1f
+
+// Standard gravity in meters per second squared
+#define PALM_GRAVITY 9.80665f
+
+// Units of the skeletal model per meter, the model is in millimeters
+#define PALM_MODEL_SCALE 1000.0f
+
+/*
+ * Estimates the position of the palm by dead reckoning.
+ *
+ * Gravity is removed from the acceleration using the orientation of the
+ * glove, and the remaining linear acceleration is rotated to the world
+ * and integrated twice. Integration drifts quickly, so the velocity is
+ * reset whenever the hand has been still for a moment, and both the
+ * velocity and the position pass through a first-order high-pass filter
+ * that slowly pulls them back to zero. The position therefore follows
+ * short movements of the hand around a resting point.
+ *
+ * The position is in meters, in the world axes of the glove orientation.
+ */
+class PalmTracker
+{
+private:
+	GLOVE_PALM_TRACKING m_parameters;
+	bool m_initialized;
+	uint64_t m_timestamp;
+
+	GLOVE_QUATERNION m_orientation;
+	float m_acceleration[3];
+	float m_velocity[3];
+	float m_position[3];
+	float m_still_time;
+
+public:
+	PalmTracker();
+
+	static void GetDefault(GLOVE_PALM_TRACKING* parameters);
+	static bool IsValid(const GLOVE_PALM_TRACKING& parameters);
+
+	const GLOVE_PALM_TRACKING& GetParameters() const { return m_parameters; }
+	void SetParameters(const GLOVE_PALM_TRACKING& parameters);
+
+	/*! Move the palm back to the origin and stop it. */
+	void Reset();
+
+	/*! \brief Update the position with a decoded sample.
+	*
+	*  \param timestamp Time of the sample on the SDK clock.
+	*  \param position Output variable to receive the position, zero when tracking is disabled.
+	*/
+	void Update(const GLOVE_DATA& data, uint64_t timestamp, GLOVE_VECTOR* position);
+
+	/*! Move every bone of a skeletal model by the position of the palm. */
+	static void Translate(const GLOVE_VECTOR& position, GLOVE_SKELETAL* model);
+};
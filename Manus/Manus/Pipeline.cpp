@@ -0,0 +1,413 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "Pipeline.h"
+#include "Clock.h"
+#include "PalmTracker.h"
+#include "ThreadRegistry.h"
+#include "Trace.h"
+
+#include <chrono>
+
+Pipeline::Pipeline(SkeletalModel& model)
+	: m_model(model)
+	, m_running(false)
+	, m_stop(false)
+{
+	GetDefault(&m_config);
+	ResetStats();
+
+	for (int i = 0; i < GLOVE_STAGES; i++)
+		m_pending[i] = false;
+
+	m_has_skeletal[GLOVE_LEFT] = false;
+	m_has_skeletal[GLOVE_RIGHT] = false;
+}
+
+Pipeline::~Pipeline()
+{
+	Stop();
+}
+
+void Pipeline::GetDefault(GLOVE_PIPELINE* config)
+{
+	for (int i = 0; i < GLOVE_STAGES; i++)
+		config->Placement[i] = GLOVE_PLACEMENT_INLINE;
+
+	// Simulating every packet is expensive, by default the model is simulated when it is requested
+	config->Placement[GLOVE_STAGE_SKELETON] = GLOVE_PLACEMENT_SKIP;
+	config->QueueSize = PIPELINE_QUEUE_SIZE;
+}
+
+bool Pipeline::IsValid(const GLOVE_PIPELINE& config)
+{
+	if (config.Placement[GLOVE_STAGE_TRANSPORT] != GLOVE_PLACEMENT_INLINE)
+		return false;
+
+	for (int i = 0; i < GLOVE_STAGES; i++)
+	{
+		GLOVE_PLACEMENT placement = config.Placement[i];
+		if (placement != GLOVE_PLACEMENT_INLINE && placement != GLOVE_PLACEMENT_THREAD &&
+			placement != GLOVE_PLACEMENT_CALLER && placement != GLOVE_PLACEMENT_SKIP)
+			return false;
+
+		if (placement == GLOVE_PLACEMENT_SKIP && i != GLOVE_STAGE_SKELETON)
+			return false;
+	}
+
+	return config.QueueSize > 0;
+}
+
+static bool IsQueued(GLOVE_PLACEMENT placement)
+{
+	return placement == GLOVE_PLACEMENT_THREAD || placement == GLOVE_PLACEMENT_CALLER;
+}
+
+bool Pipeline::Configure(const GLOVE_PIPELINE& config)
+{
+	if (m_running)
+		return false;
+
+	// Pump may still be draining the queues that are replaced
+	std::lock_guard<std::mutex> pump_lock(m_pump_mutex);
+	std::unique_lock<std::shared_timed_mutex> lock(m_channels_mutex);
+
+	m_config = config;
+
+	// Give existing channels the queues of the new configuration
+	for (auto& channel : m_channels)
+	{
+		for (int i = 0; i < GLOVE_STAGES; i++)
+			channel->queues[i].reset(IsQueued(config.Placement[i]) ? new SpscQueue<PIPELINE_ITEM>(config.QueueSize) : nullptr);
+	}
+
+	return true;
+}
+
+void Pipeline::Start()
+{
+	if (m_running)
+		return;
+
+	ResetStats();
+
+	m_has_skeletal[GLOVE_LEFT] = false;
+	m_has_skeletal[GLOVE_RIGHT] = false;
+
+	m_stop = false;
+	for (int i = 0; i < GLOVE_STAGES; i++)
+	{
+		if (m_config.Placement[i] == GLOVE_PLACEMENT_THREAD)
+			m_threads[i] = std::thread(&Pipeline::StageThread, this, i);
+	}
+
+	m_running = true;
+}
+
+void Pipeline::Stop()
+{
+	if (!m_running)
+		return;
+
+	m_stop = true;
+	for (int i = 0; i < GLOVE_STAGES; i++)
+	{
+		if (m_threads[i].joinable())
+		{
+			Wake(i);
+			m_threads[i].join();
+		}
+	}
+
+	// Nothing drains the queues anymore, so the packets left in them are dropped
+	std::lock_guard<std::mutex> pump_lock(m_pump_mutex);
+	std::shared_lock<std::shared_timed_mutex> lock(m_channels_mutex);
+
+	PIPELINE_ITEM item;
+	for (auto& channel : m_channels)
+	{
+		for (int i = 0; i < GLOVE_STAGES; i++)
+		{
+			while (channel->queues[i] && channel->queues[i]->Pop(item));
+		}
+	}
+
+	m_running = false;
+}
+
+PipelineChannel* Pipeline::Attach(Glove* glove)
+{
+	std::shared_ptr<PipelineChannel> channel = std::make_shared<PipelineChannel>();
+	channel->glove = glove;
+	channel->retired = false;
+	channel->users = 0;
+
+	std::unique_lock<std::shared_timed_mutex> lock(m_channels_mutex);
+
+	for (int i = 0; i < GLOVE_STAGES; i++)
+	{
+		if (IsQueued(m_config.Placement[i]))
+			channel->queues[i].reset(new SpscQueue<PIPELINE_ITEM>(m_config.QueueSize));
+	}
+
+	m_channels.push_back(channel);
+
+	return channel.get();
+}
+
+void Pipeline::Detach(PipelineChannel* channel)
+{
+	// No stage starts on the channel anymore, one that drains a copy of the list skips it
+	channel->retired = true;
+
+	// The copies of the list keep the channel alive until the stages are done with it
+	std::shared_ptr<PipelineChannel> retired;
+	{
+		std::unique_lock<std::shared_timed_mutex> lock(m_channels_mutex);
+
+		for (auto it = m_channels.begin(); it != m_channels.end(); ++it)
+		{
+			if (it->get() == channel)
+			{
+				retired = *it;
+				m_channels.erase(it);
+				break;
+			}
+		}
+	}
+
+	// Wait for a stage that is running a packet of the glove, the ones after it are skipped
+	while (channel->users > 0)
+		std::this_thread::yield();
+}
+
+void Pipeline::Submit(PipelineChannel& channel, const GLOVE_REPORT& report, uint64_t timestamp)
+{
+	PIPELINE_ITEM item;
+	item.glove = channel.glove;
+	item.sample.hand = GLOVE_LEFT;
+	item.sample.report = report;
+	item.sample.timestamp = timestamp;
+
+	// The transport stage covers the time since the packet arrived, which includes reading it
+	uint64_t now = GetTimestamp();
+	Record(GLOVE_STAGE_TRANSPORT, now > timestamp ? (now - timestamp) * 1000 : 0);
+
+	Run(channel, GLOVE_STAGE_DECODE, item, false);
+}
+
+void Pipeline::Run(PipelineChannel& channel, int stage, PIPELINE_ITEM& item, bool dequeued)
+{
+	for (int i = stage; i < GLOVE_STAGES; i++)
+	{
+		GLOVE_PLACEMENT placement = m_config.Placement[i];
+
+		// Hand the packet over to the thread of the stage
+		if (IsQueued(placement) && !(dequeued && i == stage))
+		{
+			SpscQueue<PIPELINE_ITEM>& queue = *channel.queues[i];
+			if (!queue.Push(item))
+			{
+				m_counters[i].dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			unsigned int depth = (unsigned int)queue.GetSize();
+			unsigned int max_depth = m_counters[i].max_depth.load(std::memory_order_relaxed);
+			while (depth > max_depth && !m_counters[i].max_depth.compare_exchange_weak(max_depth, depth, std::memory_order_relaxed));
+
+			if (placement == GLOVE_PLACEMENT_THREAD)
+				Wake(i);
+			return;
+		}
+
+		if (placement == GLOVE_PLACEMENT_SKIP)
+			continue;
+
+		uint64_t start = GetTimestampNs();
+		Execute(i, item);
+		Record(i, GetTimestampNs() - start);
+	}
+}
+
+// Trace event names indexed by GLOVE_STAGE
+static const char* g_stage_names[GLOVE_STAGES] = {
+	"Pipeline::Transport",
+	"Pipeline::Decode",
+	"Pipeline::Filter",
+	"Pipeline::Skeleton",
+	"Pipeline::Publish",
+};
+
+void Pipeline::Execute(int stage, PIPELINE_ITEM& item)
+{
+	TRACE_SCOPE_ARG(g_stage_names[stage], item.sample.hand);
+
+	switch (stage)
+	{
+	case GLOVE_STAGE_DECODE:
+		item.glove->Decode(item.sample);
+		break;
+	case GLOVE_STAGE_FILTER:
+		item.glove->Filter(item.sample);
+		break;
+	case GLOVE_STAGE_SKELETON:
+	{
+		GLOVE_SKELETAL model;
+		if (m_model.Simulate(item.sample.data, &model, item.sample.hand))
+		{
+			PalmTracker::Translate(item.sample.position, &model);
+
+			std::lock_guard<std::mutex> lock(m_skeletal_mutex);
+			m_skeletal[item.sample.hand] = model;
+			m_has_skeletal[item.sample.hand] = true;
+		}
+		break;
+	}
+	case GLOVE_STAGE_PUBLISH:
+		item.glove->Publish(item.sample);
+		break;
+	}
+}
+
+void Pipeline::Record(int stage, uint64_t duration)
+{
+	STAGE_COUNTERS& counters = m_counters[stage];
+
+	counters.count.fetch_add(1, std::memory_order_relaxed);
+	counters.total.fetch_add(duration, std::memory_order_relaxed);
+
+	uint64_t max = counters.max.load(std::memory_order_relaxed);
+	while (duration > max && !counters.max.compare_exchange_weak(max, duration, std::memory_order_relaxed));
+}
+
+unsigned int Pipeline::Drain(int stage)
+{
+	// The later stages call into the application, which may add or remove gloves meanwhile
+	std::vector<std::shared_ptr<PipelineChannel>>& channels = m_drained[stage];
+	{
+		std::shared_lock<std::shared_timed_mutex> lock(m_channels_mutex);
+		channels = m_channels;
+	}
+
+	unsigned int processed = 0;
+	for (auto& channel : channels)
+	{
+		channel->users++;
+
+		SpscQueue<PIPELINE_ITEM>* queue = channel->queues[stage].get();
+		if (queue)
+		{
+			// Take at most one queue worth of packets so one glove can't starve the others
+			PIPELINE_ITEM item;
+			for (size_t i = 0; i < queue->GetCapacity() && !channel->retired && queue->Pop(item); i++)
+			{
+				Run(*channel, stage, item, true);
+				processed++;
+			}
+		}
+
+		channel->users--;
+	}
+
+	// Release the channels that were detached meanwhile
+	channels.clear();
+
+	return processed;
+}
+
+void Pipeline::Wake(int stage)
+{
+	m_pending[stage] = true;
+
+	// Taking the lock ensures the thread is either waiting or will see the flag
+	{
+		std::lock_guard<std::mutex> lock(m_wake_mutex[stage]);
+	}
+	m_wake[stage].notify_one();
+}
+
+void Pipeline::StageThread(int stage)
+{
+	// The transport stage always runs inline, so the stage threads start at the decode stage
+	ThreadScope thread_scope((GLOVE_THREAD_ROLE)(GLOVE_THREAD_DECODE + stage - GLOVE_STAGE_DECODE));
+
+	while (!m_stop)
+	{
+		m_pending[stage] = false;
+		if (Drain(stage) > 0)
+			continue;
+
+		std::unique_lock<std::mutex> lock(m_wake_mutex[stage]);
+		m_wake[stage].wait_for(lock, std::chrono::milliseconds(PIPELINE_IDLE_MS),
+			[this, stage] { return m_pending[stage] || m_stop; });
+	}
+}
+
+unsigned int Pipeline::Pump()
+{
+	std::lock_guard<std::mutex> lock(m_pump_mutex);
+
+	unsigned int processed = 0;
+	for (int i = 0; i < GLOVE_STAGES; i++)
+	{
+		if (m_config.Placement[i] == GLOVE_PLACEMENT_CALLER)
+			processed += Drain(i);
+	}
+
+	return processed;
+}
+
+void Pipeline::GetStats(GLOVE_STAGE stage, GLOVE_STAGE_STATS* stats)
+{
+	const STAGE_COUNTERS& counters = m_counters[stage];
+
+	stats->Count = counters.count.load(std::memory_order_relaxed);
+	stats->TotalTime = counters.total.load(std::memory_order_relaxed);
+	stats->MaxTime = counters.max.load(std::memory_order_relaxed);
+	stats->Dropped = counters.dropped.load(std::memory_order_relaxed);
+	stats->MaxQueueDepth = counters.max_depth.load(std::memory_order_relaxed);
+}
+
+void Pipeline::ResetStats()
+{
+	for (int i = 0; i < GLOVE_STAGES; i++)
+	{
+		m_counters[i].count = 0;
+		m_counters[i].total = 0;
+		m_counters[i].max = 0;
+		m_counters[i].dropped = 0;
+		m_counters[i].max_depth = 0;
+	}
+}
+
+bool Pipeline::GetSkeletal(GLOVE_HAND hand, GLOVE_SKELETAL* model)
+{
+	if (m_config.Placement[GLOVE_STAGE_SKELETON] == GLOVE_PLACEMENT_SKIP)
+		return false;
+
+	std::lock_guard<std::mutex> lock(m_skeletal_mutex);
+
+	if (!m_has_skeletal[hand])
+		return false;
+
+	*model = m_skeletal[hand];
+	return true;
+}
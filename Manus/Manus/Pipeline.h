@@ -0,0 +1,153 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Glove.h"
+#include "SkeletalModel.h"
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#define PIPELINE_QUEUE_SIZE 64
+
+// Upper bound on the time a stage thread sleeps before checking its queues again
+#define PIPELINE_IDLE_MS 10
+
+/*! A packet on its way through the pipeline. */
+typedef struct
+{
+	Glove* glove;
+	GLOVE_SAMPLE sample;
+} PIPELINE_ITEM;
+
+/*! The queues in front of each stage for a single glove. */
+struct PipelineChannel
+{
+	Glove* glove;
+	std::unique_ptr<SpscQueue<PIPELINE_ITEM>> queues[GLOVE_STAGES];
+	//! Set by Detach, a stage doesn't start on the channel afterwards.
+	std::atomic<bool> retired;
+	//! Stages working on the channel.
+	std::atomic<unsigned int> users;
+};
+
+/*
+ * Runs the packets of every glove through the stages of GLOVE_STAGE.
+ *
+ * Each glove has its own channel with a single-producer single-consumer
+ * queue in front of every stage that doesn't run inline. The producer is
+ * the transport callback of that glove or the thread of an earlier stage,
+ * and the consumer is the thread of the stage, so no queue ever has more
+ * than one thread on either end. A stage thread serves the channels of all
+ * gloves, which keeps the number of threads independent of the gloves.
+ *
+ * The stages run without any lock of the pipeline, since the glove list can
+ * change from inside a callback of the publish stage. A stage works on a copy
+ * of the channel list and Detach only waits for the stages that are on the
+ * channel of its glove.
+ */
+class Pipeline
+{
+private:
+	struct STAGE_COUNTERS
+	{
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> total;
+		std::atomic<uint64_t> max;
+		std::atomic<uint64_t> dropped;
+		std::atomic<unsigned int> max_depth;
+	};
+
+	GLOVE_PIPELINE m_config;
+	SkeletalModel& m_model;
+	std::atomic<bool> m_running;
+
+	std::vector<std::shared_ptr<PipelineChannel>> m_channels;
+	std::shared_timed_mutex m_channels_mutex;
+
+	// Copy of the channels each stage drains, only touched by the thread of the stage or by Pump
+	std::vector<std::shared_ptr<PipelineChannel>> m_drained[GLOVE_STAGES];
+
+	STAGE_COUNTERS m_counters[GLOVE_STAGES];
+
+	std::thread m_threads[GLOVE_STAGES];
+	std::atomic<bool> m_stop;
+	std::atomic<bool> m_pending[GLOVE_STAGES];
+	std::mutex m_wake_mutex[GLOVE_STAGES];
+	std::condition_variable m_wake[GLOVE_STAGES];
+	std::mutex m_pump_mutex;
+
+	// Newest skeletal model of each hand when the skeleton stage runs
+	GLOVE_SKELETAL m_skeletal[2];
+	bool m_has_skeletal[2];
+	std::mutex m_skeletal_mutex;
+
+public:
+	Pipeline(SkeletalModel& model);
+	~Pipeline();
+
+	static void GetDefault(GLOVE_PIPELINE* config);
+	static bool IsValid(const GLOVE_PIPELINE& config);
+
+	void GetConfig(GLOVE_PIPELINE* config) const { *config = m_config; }
+
+	/*! \return False while the pipeline is running. */
+	bool Configure(const GLOVE_PIPELINE& config);
+
+	void Start();
+	void Stop();
+	bool IsRunning() const { return m_running; }
+
+	/*! Create the channel of a glove, must be called before it receives packets. */
+	PipelineChannel* Attach(Glove* glove);
+
+	/*! \brief Remove the channel of a glove, no stage touches it once this returns.
+	*
+	*  Waits for a stage that is running a packet of the glove, so it must not be
+	*  called from a stage or with a lock that the callbacks of the glove take.
+	*/
+	void Detach(PipelineChannel* channel);
+
+	/*! Entry point of the transport stage, never blocks. */
+	void Submit(PipelineChannel& channel, const GLOVE_REPORT& report, uint64_t timestamp);
+
+	/*! Run the stages placed on the caller thread, returns the number of packets processed. */
+	unsigned int Pump();
+
+	void GetStats(GLOVE_STAGE stage, GLOVE_STAGE_STATS* stats);
+	void ResetStats();
+
+	/*! Get the newest skeletal model, false if the skeleton stage is skipped or has no result yet. */
+	bool GetSkeletal(GLOVE_HAND hand, GLOVE_SKELETAL* model);
+
+private:
+	void Run(PipelineChannel& channel, int stage, PIPELINE_ITEM& item, bool dequeued);
+	void Execute(int stage, PIPELINE_ITEM& item);
+	void Record(int stage, uint64_t duration);
+	unsigned int Drain(int stage);
+	void Wake(int stage);
+	void StageThread(int stage);
+};
@@ -0,0 +1,104 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "PoseHistory.h"
+#include "PalmTracker.h"
+
+#include <algorithm>
+
+PoseHistory::PoseHistory()
+	: m_max_capacity(1)
+	, m_retention(0)
+{
+}
+
+void PoseHistory::SetRetention(unsigned int retention)
+{
+	std::unique_lock<std::shared_timed_mutex> lock(m_mutex);
+
+	// Size the ring for the usual rate, the retention decides which samples are dropped
+	m_history.SetCapacity((size_t)retention * HISTORY_RATE / 1000 + 1);
+	m_max_capacity = (size_t)retention * HISTORY_MAX_RATE / 1000 + 1;
+	m_retention.store((uint64_t)retention * 1000, std::memory_order_relaxed);
+}
+
+void PoseHistory::Push(const GLOVE_SAMPLE& sample)
+{
+	// Recording is off by default, so a glove without a history doesn't take the lock
+	uint64_t retention = m_retention.load(std::memory_order_relaxed);
+	if (retention == 0)
+		return;
+
+	std::unique_lock<std::shared_timed_mutex> lock(m_mutex);
+
+	if (sample.timestamp > retention)
+		m_history.Trim(sample.timestamp - retention);
+
+	// Still full after the trim, the link is faster than the ring was sized for
+	if (m_history.IsFull() && m_history.GetCapacity() < m_max_capacity)
+		m_history.Grow(std::min(m_history.GetCapacity() * 2, m_max_capacity));
+
+	m_history.Push(sample.timestamp, sample.data, sample.position);
+}
+
+void PoseHistory::Clear()
+{
+	std::unique_lock<std::shared_timed_mutex> lock(m_mutex);
+	m_history.Clear();
+}
+
+bool PoseHistory::GetRange(uint64_t* oldest, uint64_t* newest) const
+{
+	std::shared_lock<std::shared_timed_mutex> lock(m_mutex);
+
+	if (m_history.IsEmpty())
+		return false;
+
+	*oldest = m_history.GetOldest().timestamp;
+	*newest = m_history.GetNewest().timestamp;
+
+	return true;
+}
+
+bool PoseHistory::GetData(uint64_t timestamp, GLOVE_DATA* data) const
+{
+	std::shared_lock<std::shared_timed_mutex> lock(m_mutex);
+	return m_history.Sample(timestamp, data);
+}
+
+bool PoseHistory::GetSkeletal(uint64_t timestamp, SkeletalModel& skeletal, GLOVE_HAND hand, GLOVE_SKELETAL* model) const
+{
+	GLOVE_DATA data;
+	GLOVE_VECTOR position;
+	{
+		std::shared_lock<std::shared_timed_mutex> lock(m_mutex);
+		if (!m_history.Sample(timestamp, &data, &position))
+			return false;
+	}
+
+	// Simulate outside the lock, samples keep arriving meanwhile
+	if (!skeletal.Simulate(data, model, hand))
+		return false;
+
+	PalmTracker::Translate(position, model);
+
+	return true;
+}
@@ -0,0 +1,83 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Glove.h"
+#include "SampleHistory.h"
+#include "SkeletalModel.h"
+
+#include <atomic>
+#include <shared_mutex>
+
+// Samples per second the history makes room for up front, above the rate of the gloves
+#define HISTORY_RATE 200
+
+// Samples per second the history grows to for a faster link, bounds its memory
+#define HISTORY_MAX_RATE 2000
+
+// Longest retention that can be configured in milliseconds
+#define HISTORY_MAX_RETENTION 60000
+
+/*
+ * Keeps the poses of a glove for a configurable amount of time.
+ *
+ * Meant for looking up where a hand was in the past, for example to
+ * validate hits or roll back a networked simulation. Lookups take a
+ * shared lock and a binary search, so many threads can query the history
+ * while samples keep arriving. Skeletal models are simulated from the
+ * interpolated data when they are looked up, which keeps the entries
+ * small and the cost of recording a sample the same with or without them.
+ *
+ * The ring starts out sized for HISTORY_RATE. A link that delivers more
+ * samples fills it before the oldest sample has expired, in which case it
+ * doubles, up to HISTORY_MAX_RATE, rather than dropping samples that are
+ * still within the retention.
+ */
+class PoseHistory
+{
+private:
+	SampleHistory m_history;
+	size_t m_max_capacity;
+	std::atomic<uint64_t> m_retention;
+	mutable std::shared_timed_mutex m_mutex;
+
+public:
+	PoseHistory();
+
+	/*! \brief Change how long samples are kept, which clears the history.
+	*
+	*  \param retention Milliseconds, zero stops recording.
+	*/
+	void SetRetention(unsigned int retention);
+	unsigned int GetRetention() const { return (unsigned int)(m_retention.load(std::memory_order_relaxed) / 1000); }
+
+	void Push(const GLOVE_SAMPLE& sample);
+	void Clear();
+
+	/*! \return False if the history is empty. */
+	bool GetRange(uint64_t* oldest, uint64_t* newest) const;
+
+	/*! Get the data at a point in time, see SampleHistory::Sample. */
+	bool GetData(uint64_t timestamp, GLOVE_DATA* data) const;
+
+	/*! Get the skeletal model at a point in time, moved to the tracked position of the palm. */
+	bool GetSkeletal(uint64_t timestamp, SkeletalModel& skeletal, GLOVE_HAND hand, GLOVE_SKELETAL* model) const;
+};
@@ -0,0 +1,226 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "Recording.h"
+#include "ThreadRegistry.h"
+
+#define HEADER_SIZE 8
+
+// Same as the header size of a block in GloveCodec
+#define BLOCK_HEADER_SIZE 12
+
+RecordingWriter::RecordingWriter()
+	: m_file(nullptr)
+	, m_running(false)
+{
+}
+
+RecordingWriter::~RecordingWriter()
+{
+	Close();
+}
+
+bool RecordingWriter::Open(const char* path, GLOVE_HAND hand, uint8_t flags)
+{
+	if (m_file)
+		return false;
+
+	m_file = fopen(path, "wb");
+	if (!m_file)
+		return false;
+
+	uint8_t header[HEADER_SIZE] = {
+		(uint8_t)RECORDING_MAGIC, (uint8_t)(RECORDING_MAGIC >> 8),
+		(uint8_t)(RECORDING_MAGIC >> 16), (uint8_t)(RECORDING_MAGIC >> 24),
+		RECORDING_VERSION, (uint8_t)hand, flags, 0
+	};
+	fwrite(header, sizeof(header), 1, m_file);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_pending.reserve(CODEC_BLOCK_SAMPLES);
+	m_running = true;
+	m_thread = std::thread(&RecordingWriter::WriterThread, this);
+
+	return true;
+}
+
+void RecordingWriter::Close()
+{
+	if (!m_file)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// Write out the partial block as well
+		if (!m_pending.empty())
+			m_full.push_back(std::move(m_pending));
+		m_pending.clear();
+		m_running = false;
+	}
+	m_block.notify_all();
+	m_thread.join();
+
+	fclose(m_file);
+	m_file = nullptr;
+}
+
+void RecordingWriter::Write(const GLOVE_SAMPLE& sample)
+{
+	GLOVE_RECORD record;
+	record.timestamp = sample.timestamp;
+	record.report = sample.report;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if (!m_running)
+		return;
+
+	m_pending.push_back(record);
+	if (m_pending.size() < CODEC_BLOCK_SAMPLES)
+		return;
+
+	m_full.push_back(std::move(m_pending));
+	m_pending.clear();
+	m_pending.reserve(CODEC_BLOCK_SAMPLES);
+
+	lock.unlock();
+	m_block.notify_all();
+}
+
+void RecordingWriter::WriterThread()
+{
+	ThreadScope thread_scope(GLOVE_THREAD_RECORDER);
+
+	std::vector<uint8_t> encoded;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_running || !m_full.empty())
+	{
+		m_block.wait(lock, [this] { return !m_running || !m_full.empty(); });
+		if (m_full.empty())
+			continue;
+
+		std::vector<GLOVE_RECORD> records = std::move(m_full.front());
+		m_full.pop_front();
+
+		// Don't hold up the notification threads while encoding
+		lock.unlock();
+
+		encoded.clear();
+		GloveCodec::EncodeBlock(records.data(), records.size(), encoded);
+		fwrite(encoded.data(), 1, encoded.size(), m_file);
+		fflush(m_file);
+
+		lock.lock();
+	}
+}
+
+RecordingReader::RecordingReader()
+	: m_file(nullptr)
+	, m_length(0)
+	, m_hand(GLOVE_LEFT)
+	, m_flags(0)
+{
+}
+
+RecordingReader::~RecordingReader()
+{
+	Close();
+}
+
+bool RecordingReader::Open(const char* path)
+{
+	if (m_file)
+		return false;
+
+	m_file = fopen(path, "rb");
+	if (!m_file)
+		return false;
+
+	// The length bounds the size of the blocks
+	_fseeki64(m_file, 0, SEEK_END);
+	m_length = _ftelli64(m_file);
+	_fseeki64(m_file, 0, SEEK_SET);
+
+	uint8_t header[HEADER_SIZE];
+	if (fread(header, sizeof(header), 1, m_file) != 1 ||
+		(header[0] | (header[1] << 8) | (header[2] << 16) | ((uint32_t)header[3] << 24)) != RECORDING_MAGIC ||
+		header[4] != RECORDING_VERSION)
+	{
+		Close();
+		return false;
+	}
+
+	m_hand = header[5] ? GLOVE_RIGHT : GLOVE_LEFT;
+	m_flags = header[6];
+
+	return true;
+}
+
+void RecordingReader::Close()
+{
+	if (m_file)
+		fclose(m_file);
+	m_file = nullptr;
+}
+
+RECORDING_READ RecordingReader::ReadBlock(std::vector<uint8_t>& block)
+{
+	if (!m_file)
+		return RECORDING_CORRUPT;
+
+	// Only running out of file right at a block boundary is the end of the recording
+	block.resize(BLOCK_HEADER_SIZE);
+	size_t read = fread(block.data(), 1, BLOCK_HEADER_SIZE, m_file);
+	if (read == 0 && feof(m_file))
+		return RECORDING_END;
+	if (read != BLOCK_HEADER_SIZE)
+		return RECORDING_CORRUPT;
+
+	// The header holds the size of the rest of the block, don't trust it
+	// with an allocation before it is known to fit in the file
+	size_t size = block[8] | (block[9] << 8) | (block[10] << 16) | ((size_t)block[11] << 24);
+	int64_t remaining = m_length - _ftelli64(m_file);
+	if (BLOCK_HEADER_SIZE + size > CODEC_MAX_BLOCK_SIZE || (int64_t)size > remaining)
+		return RECORDING_CORRUPT;
+
+	block.resize(BLOCK_HEADER_SIZE + size);
+	if (size > 0 && fread(block.data() + BLOCK_HEADER_SIZE, size, 1, m_file) != 1)
+		return RECORDING_CORRUPT;
+
+	if (GloveCodec::GetBlockSize(block.data(), block.size()) != block.size())
+		return RECORDING_CORRUPT;
+
+	return RECORDING_BLOCK;
+}
+
+RECORDING_READ RecordingReader::ReadRecords(std::vector<GLOVE_RECORD>& records)
+{
+	std::vector<uint8_t> block;
+	RECORDING_READ result = ReadBlock(block);
+	if (result != RECORDING_BLOCK)
+		return result;
+
+	if (!GloveCodec::DecodeBlock(block.data(), block.size(), records))
+		return RECORDING_CORRUPT;
+
+	return RECORDING_BLOCK;
+}
@@ -0,0 +1,109 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "GloveCodec.h"
+
+#include <stdio.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#define RECORDING_MAGIC   0x434E524D // "MRNC"
+#define RECORDING_VERSION 1
+
+/*
+ * A recording is a small header followed by blocks from GloveCodec:
+ *
+ *   uint32  magic
+ *   uint8   version
+ *   uint8   hand
+ *   uint8   glove flags at the start of the recording
+ *   uint8   reserved
+ */
+
+/*! Result of reading a block of a recording. */
+typedef enum
+{
+	RECORDING_BLOCK,
+	//! The file ends cleanly after the last block.
+	RECORDING_END,
+	//! The block is damaged or cut off, or no recording is open.
+	RECORDING_CORRUPT
+} RECORDING_READ;
+
+class RecordingWriter
+{
+private:
+	FILE* m_file;
+	bool m_running;
+	std::thread m_thread;
+
+	std::vector<GLOVE_RECORD> m_pending;
+	std::deque<std::vector<GLOVE_RECORD>> m_full;
+	std::mutex m_mutex;
+	std::condition_variable m_block;
+
+public:
+	RecordingWriter();
+	~RecordingWriter();
+
+	bool Open(const char* path, GLOVE_HAND hand, uint8_t flags);
+	void Close();
+	bool IsOpen() const { return m_file != nullptr; }
+
+	/*! \brief Add a sample to the recording.
+	*
+	*  Encoding and writing is done on a separate thread once a block is full.
+	*/
+	void Write(const GLOVE_SAMPLE& sample);
+
+private:
+	void WriterThread();
+};
+
+class RecordingReader
+{
+private:
+	FILE* m_file;
+	int64_t m_length;
+	GLOVE_HAND m_hand;
+	uint8_t m_flags;
+
+public:
+	RecordingReader();
+	~RecordingReader();
+
+	bool Open(const char* path);
+	void Close();
+
+	GLOVE_HAND GetHand() const { return m_hand; }
+	uint8_t GetFlags() const { return m_flags; }
+
+	/*! \brief Read the next encoded block without decoding it.
+	*
+	*  Lets the caller decode blocks in parallel with GloveCodec::DecodeBlock.
+	*/
+	RECORDING_READ ReadBlock(std::vector<uint8_t>& block);
+
+	/*! Read and decode the next block, appending the records to the output. */
+	RECORDING_READ ReadRecords(std::vector<GLOVE_RECORD>& records);
+};
@@ -0,0 +1,269 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Glove.h"
+#include "Recording.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Number of recording blocks played together by one thread
+#define RECORDING_CHUNK_BLOCKS 2
+
+// Chunks in flight per thread, bounds the memory in use
+#define RECORDING_CHUNKS_PER_THREAD 2
+
+/*
+ * Plays the reports of a recording through the same decoder as a live glove.
+ */
+class RecordingPlayer
+{
+private:
+	Glove m_glove;
+
+public:
+	RecordingPlayer(GLOVE_HAND hand, uint8_t flags, const GLOVE_PROFILE& profile)
+		: m_glove(hand)
+	{
+		m_glove.SetFlags(flags);
+		m_glove.SetProfile(profile);
+	}
+
+	void Play(const GLOVE_RECORD& record, GLOVE_DATA* data)
+	{
+		m_glove.ProcessReport(record.report, record.timestamp);
+		m_glove.GetData(data, 0);
+	}
+};
+
+/*
+ * Plays a recording in chunks of blocks on several threads.
+ *
+ * Every thread has its own RecordingPlayer. A chunk is decoded and played on
+ * one thread and handed to Process there, which turns it into an output of
+ * type T. Consume then receives the outputs on the calling thread in the
+ * order of the recording. Only the chunks in flight are kept in memory, so
+ * memory use doesn't depend on the length of the recording.
+ */
+template <typename T>
+class RecordingWalker
+{
+private:
+	struct CHUNK
+	{
+		std::vector<std::vector<uint8_t>> blocks;
+		T output;
+		bool failed;
+		bool done;
+	};
+
+	unsigned int m_threads;
+
+public:
+	RecordingWalker(unsigned int threads) : m_threads(threads > 0 ? threads : 1) {}
+	virtual ~RecordingWalker() {}
+
+	unsigned int GetThreads() const { return m_threads; }
+
+	/*! \brief Play the whole recording.
+	*
+	*  \return False if a block is damaged or cut off, or one of the callbacks failed.
+	*/
+	bool Walk(RecordingReader& reader, const GLOVE_PROFILE& profile);
+
+protected:
+	/*! Called on the calling thread with the first sample, before any chunk is processed. */
+	virtual bool Begin(const GLOVE_RECORD& record, const GLOVE_DATA& data) { return true; }
+
+	/*! Called once on every thread before it processes its first chunk. */
+	virtual bool Start(unsigned int thread) { return true; }
+
+	/*! Turn the samples of a chunk into its output, may be called from several threads at once. */
+	virtual bool Process(unsigned int thread, const GLOVE_RECORD* records, const GLOVE_DATA* data,
+		size_t count, T& output) = 0;
+
+	/*! Called on the calling thread with the output of every chunk in order. */
+	virtual bool Consume(T& output) = 0;
+};
+
+template <typename T>
+bool RecordingWalker<T>::Walk(RecordingReader& reader, const GLOVE_PROFILE& profile)
+{
+	GLOVE_HAND hand = reader.GetHand();
+	uint8_t flags = reader.GetFlags();
+
+	// The first block is decoded here so Begin sees the first sample
+	std::vector<uint8_t> first_block;
+	RECORDING_READ first_read = reader.ReadBlock(first_block);
+	if (first_read != RECORDING_BLOCK)
+		return first_read == RECORDING_END;
+
+	std::vector<GLOVE_RECORD> first_records;
+	if (!GloveCodec::DecodeBlock(first_block.data(), first_block.size(), first_records) || first_records.empty())
+		return false;
+
+	RecordingPlayer first_player(hand, flags, profile);
+	GLOVE_DATA first;
+	first_player.Play(first_records[0], &first);
+	if (!Begin(first_records[0], first))
+		return false;
+
+	std::mutex mutex;
+	std::condition_variable work_ready;
+	std::condition_variable chunk_done;
+	std::deque<CHUNK*> work;
+	bool finished = false;
+	bool failed = false;
+
+	std::vector<std::thread> workers;
+	for (unsigned int t = 0; t < m_threads; t++)
+	{
+		workers.push_back(std::thread([&, t] {
+			RecordingPlayer player(hand, flags, profile);
+			bool started = Start(t);
+
+			std::vector<GLOVE_RECORD> records;
+			std::vector<GLOVE_DATA> data;
+
+			while (true)
+			{
+				CHUNK* chunk;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					work_ready.wait(lock, [&] { return finished || !work.empty(); });
+					if (work.empty())
+						return;
+
+					chunk = work.front();
+					work.pop_front();
+				}
+
+				records.clear();
+
+				chunk->failed = !started;
+				for (const std::vector<uint8_t>& block : chunk->blocks)
+				{
+					if (!GloveCodec::DecodeBlock(block.data(), block.size(), records))
+						chunk->failed = true;
+				}
+
+				if (!chunk->failed)
+				{
+					data.resize(records.size());
+					for (size_t i = 0; i < records.size(); i++)
+						player.Play(records[i], &data[i]);
+
+					chunk->failed = !Process(t, records.data(), data.data(), records.size(), chunk->output);
+				}
+
+				// The encoded blocks are no longer needed
+				chunk->blocks.clear();
+
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					chunk->done = true;
+				}
+				chunk_done.notify_all();
+			}
+		}));
+	}
+
+	// Read chunks while there is room and consume the completed chunks in order
+	std::deque<CHUNK*> in_flight;
+	bool end_of_file = false;
+	bool have_first = true;
+
+	while (!failed)
+	{
+		while (!end_of_file && in_flight.size() < m_threads * RECORDING_CHUNKS_PER_THREAD)
+		{
+			CHUNK* chunk = new CHUNK();
+			chunk->failed = false;
+			chunk->done = false;
+
+			for (int b = 0; b < RECORDING_CHUNK_BLOCKS; b++)
+			{
+				std::vector<uint8_t> block;
+				if (have_first)
+				{
+					block.swap(first_block);
+					have_first = false;
+				}
+				else
+				{
+					// A damaged block fails the walk instead of passing for the end of the recording
+					RECORDING_READ read = reader.ReadBlock(block);
+					if (read == RECORDING_CORRUPT)
+						failed = true;
+					if (read != RECORDING_BLOCK)
+					{
+						end_of_file = true;
+						break;
+					}
+				}
+				chunk->blocks.push_back(std::move(block));
+			}
+
+			if (chunk->blocks.empty() || failed)
+			{
+				delete chunk;
+				break;
+			}
+
+			in_flight.push_back(chunk);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				work.push_back(chunk);
+			}
+			work_ready.notify_one();
+		}
+
+		if (failed || in_flight.empty())
+			break;
+
+		CHUNK* chunk = in_flight.front();
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			chunk_done.wait(lock, [&] { return chunk->done; });
+		}
+		in_flight.pop_front();
+
+		failed = chunk->failed || !Consume(chunk->output);
+		delete chunk;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		finished = true;
+		work.clear();
+	}
+	work_ready.notify_all();
+	for (std::thread& worker : workers)
+		worker.join();
+
+	for (CHUNK* chunk : in_flight)
+		delete chunk;
+
+	return !failed;
+}
@@ -0,0 +1,128 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "SampleCallbacks.h"
+#include "PalmTracker.h"
+
+#include <string.h>
+
+std::atomic<unsigned int> SampleCallbacks::s_next_id(1);
+
+// Callback running on this thread, whose mutex the thread already holds
+static thread_local const void* t_current = nullptr;
+
+SampleCallbacks::SampleCallbacks()
+	: m_list(std::make_shared<CALLBACK_LIST>())
+	, m_published(0)
+{
+}
+
+unsigned int SampleCallbacks::Register(GLOVE_SAMPLE_CALLBACK callback, void* context, unsigned int contents)
+{
+	if (!callback)
+		return 0;
+
+	if (contents == 0 || (contents & ~(GLOVE_RING_DATA | GLOVE_RING_SKELETAL)) != 0)
+		return 0;
+
+	std::shared_ptr<CALLBACK_ENTRY> entry = std::make_shared<CALLBACK_ENTRY>();
+	entry->id = s_next_id++;
+	entry->callback = callback;
+	entry->context = context;
+	entry->contents = contents;
+	entry->removed = false;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::shared_ptr<CALLBACK_LIST> list = std::make_shared<CALLBACK_LIST>(*m_list);
+	list->push_back(entry);
+	std::atomic_store(&m_list, std::shared_ptr<const CALLBACK_LIST>(list));
+
+	return entry->id;
+}
+
+bool SampleCallbacks::Unregister(unsigned int id)
+{
+	std::shared_ptr<CALLBACK_ENTRY> entry;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		std::shared_ptr<CALLBACK_LIST> list = std::make_shared<CALLBACK_LIST>();
+		for (const std::shared_ptr<CALLBACK_ENTRY>& other : *m_list)
+		{
+			if (other->id == id)
+				entry = other;
+			else
+				list->push_back(other);
+		}
+
+		if (!entry)
+			return false;
+
+		std::atomic_store(&m_list, std::shared_ptr<const CALLBACK_LIST>(list));
+	}
+
+	// A sample may still be delivered from the old list, wait for the callback to finish
+	if (t_current == entry.get())
+	{
+		entry->removed = true;
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock(entry->mutex);
+		entry->removed = true;
+	}
+
+	return true;
+}
+
+void SampleCallbacks::Publish(const GLOVE_SAMPLE& sample, SkeletalModel& skeletal)
+{
+	std::shared_ptr<const CALLBACK_LIST> list = std::atomic_load(&m_list);
+	if (list->empty())
+		return;
+
+	unsigned int contents = 0;
+	for (const std::shared_ptr<CALLBACK_ENTRY>& entry : *list)
+		contents |= entry->contents;
+
+	// Same layout as a ring entry, the samples of a glove are published one at a time
+	GLOVE_RING_ENTRY result;
+	result.Sequence = ++m_published * 2;
+	result.Timestamp = sample.timestamp;
+	result.Data = sample.data;
+	if (!(contents & GLOVE_RING_SKELETAL) || !skeletal.Simulate(sample.data, &result.Skeletal, sample.hand))
+		memset(&result.Skeletal, 0, sizeof(result.Skeletal));
+	else
+		PalmTracker::Translate(sample.position, &result.Skeletal);
+
+	for (const std::shared_ptr<CALLBACK_ENTRY>& entry : *list)
+	{
+		std::lock_guard<std::mutex> lock(entry->mutex);
+		if (entry->removed)
+			continue;
+
+		t_current = entry.get();
+		entry->callback(sample.hand, &result, entry->context);
+		t_current = nullptr;
+	}
+}
@@ -0,0 +1,73 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Glove.h"
+#include "SkeletalModel.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+ * Calls the sample callbacks registered for a glove.
+ *
+ * The list of callbacks is copied on every change and published with an
+ * atomic store of a shared pointer, so delivering a sample never waits
+ * for a callback being registered. Each callback has its own mutex that
+ * is held while it runs, which lets unregistering wait until the callback
+ * is done without holding up the other callbacks. A callback may register
+ * and unregister callbacks, including itself.
+ */
+class SampleCallbacks
+{
+private:
+	struct CALLBACK_ENTRY
+	{
+		unsigned int id;
+		GLOVE_SAMPLE_CALLBACK callback;
+		void* context;
+		unsigned int contents;
+		bool removed;
+		std::mutex mutex;
+	};
+
+	typedef std::vector<std::shared_ptr<CALLBACK_ENTRY>> CALLBACK_LIST;
+
+	std::shared_ptr<const CALLBACK_LIST> m_list;
+	std::mutex m_mutex;
+	unsigned long long m_published;
+
+	static std::atomic<unsigned int> s_next_id;
+
+public:
+	SampleCallbacks();
+
+	/*! \return Zero if the arguments are invalid, otherwise the identifier of the callback. */
+	unsigned int Register(GLOVE_SAMPLE_CALLBACK callback, void* context, unsigned int contents);
+
+	/*! \return False if the callback isn't registered for this glove. */
+	bool Unregister(unsigned int id);
+
+	/*! Call every callback with a sample, the skeletal model is only simulated when a callback asks for it. */
+	void Publish(const GLOVE_SAMPLE& sample, SkeletalModel& skeletal);
+};
@@ -0,0 +1,139 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "SampleHistory.h"
+#include "Glove.h"
+#include "ManusMath.h"
+
+SampleHistory::SampleHistory(size_t capacity)
+	: m_entries(capacity > 0 ? capacity : 1)
+	, m_first(0)
+	, m_count(0)
+{
+}
+
+void SampleHistory::SetCapacity(size_t capacity)
+{
+	m_entries.resize(capacity > 0 ? capacity : 1);
+	Clear();
+}
+
+void SampleHistory::Grow(size_t capacity)
+{
+	if (capacity <= m_entries.size())
+		return;
+
+	// Unwrap the ring into the new entries, oldest first
+	std::vector<HISTORY_ENTRY> entries(capacity);
+	for (size_t i = 0; i < m_count; i++)
+		entries[i] = GetEntry(i);
+
+	m_entries.swap(entries);
+	m_first = 0;
+}
+
+void SampleHistory::Clear()
+{
+	m_first = 0;
+	m_count = 0;
+}
+
+void SampleHistory::Push(uint64_t timestamp, const GLOVE_DATA& data, const GLOVE_VECTOR& position)
+{
+	// Keep the history ordered, a sample from the past would break the search
+	if (m_count > 0 && timestamp < GetNewest().timestamp)
+		return;
+
+	HISTORY_ENTRY& entry = m_entries[(m_first + m_count) % m_entries.size()];
+	entry.timestamp = timestamp;
+	entry.data = data;
+	entry.position = position;
+
+	// Overwrite the oldest entry once the history is full
+	if (m_count < m_entries.size())
+		m_count++;
+	else
+		m_first = (m_first + 1) % m_entries.size();
+}
+
+void SampleHistory::Trim(uint64_t timestamp)
+{
+	while (m_count > 0 && GetOldest().timestamp < timestamp)
+	{
+		m_first = (m_first + 1) % m_entries.size();
+		m_count--;
+	}
+}
+
+size_t SampleHistory::UpperBound(uint64_t timestamp) const
+{
+	size_t low = 0, high = m_count;
+	while (low < high)
+	{
+		size_t middle = low + (high - low) / 2;
+		if (GetEntry(middle).timestamp <= timestamp)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low;
+}
+
+bool SampleHistory::Sample(uint64_t timestamp, GLOVE_DATA* data, GLOVE_VECTOR* position) const
+{
+	size_t next = UpperBound(timestamp);
+	if (next == 0)
+		return false;
+
+	const HISTORY_ENTRY& a = GetEntry(next - 1);
+	if (next == m_count || a.timestamp == timestamp)
+	{
+		*data = a.data;
+		if (position)
+			*position = a.position;
+		return true;
+	}
+
+	const HISTORY_ENTRY& b = GetEntry(next);
+	float t = (float)(timestamp - a.timestamp) / (float)(b.timestamp - a.timestamp);
+
+	// The packet number of the last sample that was available at that time
+	*data = a.data;
+
+	for (int i = 0; i < GLOVE_FINGERS; i++)
+		data->Fingers[i] = a.data.Fingers[i] + (b.data.Fingers[i] - a.data.Fingers[i]) * t;
+
+	data->Acceleration.x = a.data.Acceleration.x + (b.data.Acceleration.x - a.data.Acceleration.x) * t;
+	data->Acceleration.y = a.data.Acceleration.y + (b.data.Acceleration.y - a.data.Acceleration.y) * t;
+	data->Acceleration.z = a.data.Acceleration.z + (b.data.Acceleration.z - a.data.Acceleration.z) * t;
+
+	data->Quaternion = ManusMath::QuaternionSlerp(a.data.Quaternion, b.data.Quaternion, t);
+	ManusMath::GetEuler(&data->Euler, &data->Quaternion);
+
+	if (position)
+	{
+		position->x = a.position.x + (b.position.x - a.position.x) * t;
+		position->y = a.position.y + (b.position.y - a.position.y) * t;
+		position->z = a.position.z + (b.position.z - a.position.z) * t;
+	}
+
+	return true;
+}
@@ -0,0 +1,89 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Manus.h"
+
+#include <inttypes.h>
+#include <vector>
+
+/*! A sample in the history together with its time of arrival. */
+typedef struct
+{
+	uint64_t timestamp;
+	GLOVE_DATA data;
+	// Position of the palm, zero when it isn't tracked
+	GLOVE_VECTOR position;
+} HISTORY_ENTRY;
+
+/*
+ * Bounded history of the samples of a single glove, ordered by time.
+ *
+ * Samples can be looked up at any point in time covered by the history,
+ * in which case the surrounding samples are interpolated. The history is
+ * not thread-safe, the owner is expected to lock it.
+ */
+class SampleHistory
+{
+private:
+	std::vector<HISTORY_ENTRY> m_entries;
+	size_t m_first;
+	size_t m_count;
+
+public:
+	SampleHistory(size_t capacity = 1);
+
+	/*! Change the number of samples that are kept, which clears the history. */
+	void SetCapacity(size_t capacity);
+	size_t GetCapacity() const { return m_entries.size(); }
+
+	/*! Make room for more samples, keeping the ones in the history. */
+	void Grow(size_t capacity);
+	bool IsFull() const { return m_count == m_entries.size(); }
+
+	void Clear();
+	void Push(uint64_t timestamp, const GLOVE_DATA& data, const GLOVE_VECTOR& position);
+
+	/*! Drop the entries from before a point in time. */
+	void Trim(uint64_t timestamp);
+
+	size_t GetCount() const { return m_count; }
+	bool IsEmpty() const { return m_count == 0; }
+
+	/*! Get an entry by age, zero being the oldest one. */
+	const HISTORY_ENTRY& GetEntry(size_t index) const { return m_entries[(m_first + index) % m_entries.size()]; }
+	const HISTORY_ENTRY& GetOldest() const { return GetEntry(0); }
+	const HISTORY_ENTRY& GetNewest() const { return GetEntry(m_count - 1); }
+
+	/*! \brief Get the data at a point in time.
+	*
+	*  Fingers, acceleration and position are interpolated linearly and the
+	*  orientation with a slerp. Times after the newest sample return the
+	*  newest sample.
+	*
+	*  \param position Optional output variable to receive the position of the palm.
+	*  \return False if the time is before the oldest sample or the history is empty.
+	*/
+	bool Sample(uint64_t timestamp, GLOVE_DATA* data, GLOVE_VECTOR* position = nullptr) const;
+
+private:
+	/*! Index of the first entry newer than the timestamp, found with a binary search. */
+	size_t UpperBound(uint64_t timestamp) const;
+};
@@ -0,0 +1,106 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "SampleRing.h"
+#include "PalmTracker.h"
+
+#include <atomic>
+#include <string.h>
+
+SampleRing::SampleRing()
+	: m_entries(nullptr), m_capacity(0), m_counter(nullptr), m_written(0), m_contents(0)
+{
+}
+
+bool SampleRing::Register(GLOVE_RING_ENTRY* entries, unsigned int capacity, unsigned long long* counter, unsigned int contents)
+{
+	if (!entries || capacity == 0 || !counter)
+		return false;
+
+	if (contents == 0 || (contents & ~(GLOVE_RING_DATA | GLOVE_RING_SKELETAL)) != 0)
+		return false;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// Clear the sequence numbers so no stale entry looks valid
+	for (unsigned int i = 0; i < capacity; i++)
+		entries[i].Sequence = 0;
+	*counter = 0;
+
+	m_entries = entries;
+	m_capacity = capacity;
+	m_counter = counter;
+	m_written = 0;
+	m_contents.store(contents, std::memory_order_relaxed);
+
+	return true;
+}
+
+void SampleRing::Unregister()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_entries = nullptr;
+	m_capacity = 0;
+	m_counter = nullptr;
+	m_contents.store(0, std::memory_order_relaxed);
+}
+
+void SampleRing::Write(const GLOVE_SAMPLE& sample, SkeletalModel& skeletal)
+{
+	unsigned int contents = m_contents.load(std::memory_order_relaxed);
+	if (contents == 0)
+		return;
+
+	// Simulate before taking the lock, the Bluetooth callback shouldn't hold it
+	// for the length of a simulation or keep an entry torn for readers meanwhile
+	GLOVE_SKELETAL model;
+	bool has_model = (contents & GLOVE_RING_SKELETAL) && skeletal.Simulate(sample.data, &model, sample.hand);
+	if (has_model)
+		PalmTracker::Translate(sample.position, &model);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// The ring may have been replaced while simulating, write what the current one asks for
+	if (!m_entries)
+		return;
+	contents = m_contents.load(std::memory_order_relaxed);
+
+	unsigned long long number = m_written + 1;
+	GLOVE_RING_ENTRY* entry = &m_entries[m_written % m_capacity];
+	volatile unsigned long long* sequence = &entry->Sequence;
+
+	*sequence = number * 2 - 1;
+	std::atomic_thread_fence(std::memory_order_release);
+
+	entry->Timestamp = sample.timestamp;
+	if (contents & GLOVE_RING_DATA)
+		entry->Data = sample.data;
+	if (has_model && (contents & GLOVE_RING_SKELETAL))
+		entry->Skeletal = model;
+	else if (contents & GLOVE_RING_SKELETAL)
+		memset(&entry->Skeletal, 0, sizeof(entry->Skeletal));
+
+	std::atomic_thread_fence(std::memory_order_release);
+	*sequence = number * 2;
+	*m_counter = number;
+
+	m_written = number;
+}
@@ -0,0 +1,61 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Glove.h"
+#include "SkeletalModel.h"
+
+#include <atomic>
+#include <mutex>
+
+/*
+ * Writes samples into a ring buffer owned by the application.
+ *
+ * Every entry is guarded by its sequence number like a seqlock, so the
+ * application can read the ring without locking or calling into the SDK.
+ */
+class SampleRing
+{
+private:
+	GLOVE_RING_ENTRY* m_entries;
+	unsigned int m_capacity;
+	volatile unsigned long long* m_counter;
+	unsigned long long m_written;
+
+	// Read without the lock so Write can simulate before taking it, 0 without a ring
+	std::atomic<unsigned int> m_contents;
+
+	std::mutex m_mutex;
+
+public:
+	SampleRing();
+
+	bool Register(GLOVE_RING_ENTRY* entries, unsigned int capacity, unsigned long long* counter, unsigned int contents);
+
+	/*! Stop writing, the buffers are no longer touched once this returns. */
+	void Unregister();
+
+	/*! \brief Write a sample into the ring if one is registered.
+	*
+	*  The skeletal model is only simulated when the ring asks for it, and
+	*  outside the lock so Register and Unregister don't wait for it.
+	*/
+	void Write(const GLOVE_SAMPLE& sample, SkeletalModel& skeletal);
+};
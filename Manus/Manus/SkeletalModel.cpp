@@ -3,6 +3,8 @@
 #include "FbxMemStream.h"
 #include "resource.h"
 #include "ManusMath.h"
+#include "ThreadRegistry.h"
+#include "Trace.h"
 
 const char* s_bone_names[GLOVE_FINGERS][3] = {
 	{ "ThumbFingerBone004", "ThumbFingerBone005", "ThumbFingerBone003" },
@@ -12,55 +14,24 @@ const char* s_bone_names[GLOVE_FINGERS][3] = {
 	{ "PinkFingerBone004", "PinkFingerBone005", "PinkFingerBone003" }
 };
 
-GLOVE_POSE SkeletalModel::ToGlovePose(FbxAMatrix mat)
-{
-	GLOVE_POSE pose;
-
-	// Apply the orientation of the hand to the transformation matrix
-	FbxQuaternion orient;
-
-	/*
-	if (temp_hand == GLOVE_RIGHT)
-		//orient = FbxQuaternion(-temp_data.Quaternion.y, temp_data.Quaternion.z, -temp_data.Quaternion.x, temp_data.Quaternion.w);
-		orient = FbxQuaternion(-temp_data.Quaternion.y, temp_data.Quaternion.z, temp_data.Quaternion.x, -temp_data.Quaternion.w);
-	else
-		orient = FbxQuaternion(temp_data.Quaternion.y, temp_data.Quaternion.z, temp_data.Quaternion.x, temp_data.Quaternion.w);
-	*/
-
-	orient = FbxQuaternion(temp_data.Quaternion.y, temp_data.Quaternion.z, temp_data.Quaternion.x, temp_data.Quaternion.w);
-
-	FbxAMatrix orientMat;
-	orientMat.SetQ(orient);
-	orientMat *= mat;
-
-	FbxQuaternion quat = orientMat.GetQ();
+// Seconds of animation covering the range of a finger
+#define FINGER_ANIMATION_TIME 1.66
 
-	pose.orientation.x = (float)quat.mData[0];
-	pose.orientation.y = (float)quat.mData[1];
-	pose.orientation.z = (float)quat.mData[2];
-	pose.orientation.w = (float)quat.mData[3];
-
-	FbxVector4 trans = orientMat.GetT();
-
-	pose.position.x = (float)trans.mData[0];
-	pose.position.y = (float)trans.mData[1];
-	pose.position.z = (float)trans.mData[2];
-
-	/*
-	if (temp_hand == GLOVE_RIGHT)
-		pose.position.x *= -1.0f;
-	*/
-	return pose;
-}
-
-// Creates an instance of the SDK manager
-// and use the SDK manager to create a new scene
 SkeletalModel::SkeletalModel()
+	: m_sdk_manager(nullptr)
+	, m_stop(false)
 {
+	for (int i = 0; i < 2; i++)
+	{
+		m_status[i].State = GLOVE_MODEL_DEFAULT;
+		m_status[i].Generation = 0;
+	}
 }
 
 SkeletalModel::~SkeletalModel()
 {
+	StopLoading();
+
 	// Delete the FBX SDK manager. All the objects that have been allocated 
 	// using the FBX SDK manager and that haven't been explicitly destroyed 
 	// are automatically destroyed at the same time.
@@ -70,122 +41,296 @@ SkeletalModel::~SkeletalModel()
 
 bool SkeletalModel::InitializeScene()
 {
-	// Create the FBX SDK memory manager object.
-	// The SDK Manager allocates and frees memory
-	// for almost all the classes in the SDK.
-	m_sdk_manager = FbxManager::Create();
+	if (std::atomic_load(&m_default))
+		return true;
+
+	// Callers that race for the first model wait for a single import
+	std::lock_guard<std::mutex> lock(m_scene_mutex);
+	if (std::atomic_load(&m_default))
+		return true;
 
-	// Create an IOSettings object.
-	FbxIOSettings* ios = FbxIOSettings::Create(m_sdk_manager, IOSROOT);
-	m_sdk_manager->SetIOSettings(ios);
+	// Get the module this code is in, which isn't Manus.dll when the SDK is linked statically.
+	static const char module_marker = 0;
+	HMODULE module = nullptr;
+	GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+		(LPCWSTR)&module_marker, &module);
 
 	// Get pointer and size to resource.
-	HRSRC hRes = FindResource(GetModuleHandle(L"Manus.dll"), MAKEINTRESOURCE(IDR_FBX1), RT_RCDATA);
-	HGLOBAL hMem = LoadResource(GetModuleHandle(L"Manus.dll"), hRes);
-	DWORD dSize = SizeofResource(GetModuleHandle(L"Manus.dll"), hRes);
+	HRSRC hRes = FindResource(module, MAKEINTRESOURCE(IDR_FBX1), RT_RCDATA);
+	HGLOBAL hMem = LoadResource(module, hRes);
+	DWORD dSize = SizeofResource(module, hRes);
 	void* pMem = LockResource(hMem);
 
+	std::shared_ptr<const HandModel> model = Import(nullptr, pMem, dSize);
+	if (!model)
+		return false;
+
+	std::atomic_store(&m_default, model);
+
+	// Hands that already have a model of their own keep it
+	for (int i = 0; i < 2; i++)
+	{
+		std::shared_ptr<const HandModel> empty;
+		std::atomic_compare_exchange_strong(&m_models[i], &empty, model);
+	}
+
+	return true;
+}
+
+std::shared_ptr<const HandModel> SkeletalModel::Import(const char* path, const void* data, size_t size)
+{
+	TRACE_SCOPE("SkeletalModel::Import");
+
+	std::lock_guard<std::mutex> lock(m_import_mutex);
+
+	if (!m_sdk_manager)
+	{
+		// Create the FBX SDK memory manager object.
+		// The SDK Manager allocates and frees memory
+		// for almost all the classes in the SDK.
+		m_sdk_manager = FbxManager::Create();
+
+		// Create an IOSettings object.
+		FbxIOSettings* ios = FbxIOSettings::Create(m_sdk_manager, IOSROOT);
+		m_sdk_manager->SetIOSettings(ios);
+	}
+
 	// Create an importer and initialize the importer.
 	FbxImporter* importer = FbxImporter::Create(m_sdk_manager, "");
-	FbxMemStream mem_stream(m_sdk_manager, pMem, dSize);
-	if (!importer->Initialize(&mem_stream, nullptr, -1, m_sdk_manager->GetIOSettings()))
+	FbxMemStream mem_stream(m_sdk_manager, (void*)data, size);
+	bool initialized = path ?
+		importer->Initialize(path, -1, m_sdk_manager->GetIOSettings()) :
+		importer->Initialize(&mem_stream, nullptr, -1, m_sdk_manager->GetIOSettings());
+	if (!initialized)
 	{
-		FBXSDK_printf("Call to FbxExporter::Initialize() failed.\n");
+		FBXSDK_printf("Call to FbxImporter::Initialize() failed.\n");
 		FBXSDK_printf("Error returned: %s\n\n", importer->GetStatus().GetErrorString());
-		return false;
+		importer->Destroy();
+		return nullptr;
 	}
 
 	// Create a new scene so it can be populated by the imported file.
-	m_scene = FbxScene::Create(m_sdk_manager, "HandModel");
+	FbxScene* scene = FbxScene::Create(m_sdk_manager, "HandModel");
 
 	// Import the contents of the file into the scene.
-	importer->Import(m_scene);
+	std::shared_ptr<const HandModel> model;
+	if (importer->Import(scene))
+		model = Bake(scene);
 
-	// Get the hand node
-	m_palm_node = m_scene->FindNodeByName("Palm");
+	// The model has been baked; we can get rid of the importer and the scene.
+	importer->Destroy();
+	scene->Destroy();
 
-	// Get the palm bone
-	m_palm_bone = m_scene->FindNodeByName("Palm bone");
+	return model;
+}
 
-	// Get the bones for each finger.
+std::shared_ptr<const HandModel> SkeletalModel::Bake(FbxScene* scene)
+{
+	// Get the node of every bone in GLOVE_SKELETAL order, the metacarpals of the fingers all use the palm bone
+	FbxNode* palm_bone = scene->FindNodeByName("Palm bone");
+	FbxNode* nodes[GLOVE_BONES] = { nullptr };
+	int bone = 1;
 	for (int i = 0; i < GLOVE_FINGERS; i++)
 	{
+		if (i > 0)
+			nodes[bone++] = palm_bone;
 		for (int j = 0; j < 3; j++)
+			nodes[bone++] = scene->FindNodeByName(s_bone_names[i][j]);
+	}
+
+	// A custom rig has to use the same names as the embedded model
+	for (int i = 1; i < GLOVE_BONES; i++)
+	{
+		if (!nodes[i])
+			return nullptr;
+	}
+
+	// Sample the animation of every bone over the range of its finger
+	std::shared_ptr<HandModel> model = std::make_shared<HandModel>();
+	FbxAnimEvaluator* eval = scene->GetAnimationEvaluator();
+	for (int i = 1; i < GLOVE_BONES; i++)
+	{
+		for (int j = 0; j < HAND_MODEL_SAMPLES; j++)
 		{
-			// Get the node for the finger
-			m_bone_nodes[i][j] = m_scene->FindNodeByName(s_bone_names[i][j]);
+			FbxTime time;
+			time.SetSecondDouble(FINGER_ANIMATION_TIME * j / (HAND_MODEL_SAMPLES - 1));
+			FbxAMatrix mat = eval->GetNodeGlobalTransform(nodes[i], time);
+
+			FbxQuaternion quat = mat.GetQ();
+			FbxVector4 trans = mat.GetT();
+
+			GLOVE_POSE pose;
+			pose.orientation.x = (float)quat.mData[0];
+			pose.orientation.y = (float)quat.mData[1];
+			pose.orientation.z = (float)quat.mData[2];
+			pose.orientation.w = (float)quat.mData[3];
+			pose.position.x = (float)trans.mData[0];
+			pose.position.y = (float)trans.mData[1];
+			pose.position.z = (float)trans.mData[2];
+			model->SetSample(i, j, pose);
 		}
 	}
 
-	// The file has been imported; we can get rid of the importer.
-	importer->Destroy();
-
-	return true;
+	return model;
 }
 
-
-
-
-bool SkeletalModel::Simulate(const GLOVE_DATA data, GLOVE_SKELETAL* model, GLOVE_HAND hand)
+GLOVE_QUATERNION SkeletalModel::GetPalmOrientation(const GLOVE_QUATERNION& quaternion)
 {
-	// Get the animation evaluator for this scene
-	FbxAnimEvaluator* eval = m_scene->GetAnimationEvaluator();
-	FbxTime normalizedAmount;
-	double timeFactor = 1.66;
-
-	temp_data = data;
-	temp_hand = hand;
-
-	// Swapping as in ToGlovePose;
-	temp_quaternion.x = data.Quaternion.y;
-	temp_quaternion.y = data.Quaternion.z;
-	temp_quaternion.z = data.Quaternion.x;
-	temp_quaternion.w = data.Quaternion.w;
-	
+	// Swapping as in HandModel::Evaluate;
+	GLOVE_QUATERNION result;
+	result.x = quaternion.y;
+	result.y = quaternion.z;
+	result.z = quaternion.x;
+	result.w = quaternion.w;
+
 	// Rotation to match Unity
 	GLOVE_QUATERNION rotation;
 	rotation.x = -0.707f;
 	rotation.y = 0;
 	rotation.z = 0;
 	rotation.w = 0.707f;
-	temp_quaternion = ManusMath::QuaternionMultiply(temp_quaternion, rotation);
-	
-	// Set the pose of the palm
-	model->palm.orientation = temp_quaternion;
-
-	// Evaluate the animation for the thumb
-	normalizedAmount.SetSecondDouble(data.Fingers[0] * timeFactor);
-	model->thumb.metacarpal = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[0][0], normalizedAmount));
-	model->thumb.proximal = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[0][1], normalizedAmount));
-	model->thumb.distal = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[0][2], normalizedAmount));
-
-	// Evaluate the animation for the index finger
-	normalizedAmount.SetSecondDouble(data.Fingers[1] * timeFactor);
-	model->index.metacarpal = ToGlovePose(eval->GetNodeGlobalTransform(m_palm_bone, normalizedAmount));
-	model->index.proximal = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[1][0], normalizedAmount));
-	model->index.intermediate = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[1][1], normalizedAmount));
-	model->index.distal = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[1][2], normalizedAmount));
-
-	// Evaluate the animation for the middle finger
-	normalizedAmount.SetSecondDouble(data.Fingers[2] * timeFactor);
-	model->middle.metacarpal = ToGlovePose(eval->GetNodeGlobalTransform(m_palm_bone, normalizedAmount));
-	model->middle.proximal = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[2][0], normalizedAmount));
-	model->middle.intermediate = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[2][1], normalizedAmount));
-	model->middle.distal = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[2][2], normalizedAmount));
-
-	// Evaluate the animation for the ring finger
-	normalizedAmount.SetSecondDouble(data.Fingers[3] * timeFactor);
-	model->ring.metacarpal = ToGlovePose(eval->GetNodeGlobalTransform(m_palm_bone, normalizedAmount));
-	model->ring.proximal = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[3][0], normalizedAmount));
-	model->ring.intermediate = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[3][1], normalizedAmount));
-	model->ring.distal = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[3][2], normalizedAmount));
-
-	// Evaluate the animation for the pink finger
-	normalizedAmount.SetSecondDouble(data.Fingers[4] * timeFactor);
-	model->pinky.metacarpal = ToGlovePose(eval->GetNodeGlobalTransform(m_palm_bone, normalizedAmount));
-	model->pinky.proximal = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[4][0], normalizedAmount));
-	model->pinky.intermediate = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[4][1], normalizedAmount));
-	model->pinky.distal = ToGlovePose(eval->GetNodeGlobalTransform(m_bone_nodes[4][2], normalizedAmount));
+	return ManusMath::QuaternionMultiply(result, rotation);
+}
+
+bool SkeletalModel::Simulate(const GLOVE_DATA data, GLOVE_SKELETAL* model, GLOVE_HAND hand)
+{
+	TRACE_SCOPE_ARG("SkeletalModel::Simulate", hand);
+
+	// Hold on to the model, a load that finishes meanwhile only affects later calls
+	std::shared_ptr<const HandModel> hand_model = std::atomic_load(&m_models[hand]);
+	if (!hand_model)
+		return false;
+
+	// Set the pose of the palm, the origin of the model
+	model->palm.orientation = GetPalmOrientation(data.Quaternion);
+	model->palm.position.x = 0.0f;
+	model->palm.position.y = 0.0f;
+	model->palm.position.z = 0.0f;
+
+	hand_model->Evaluate(data, model);
 
 	return true;
 }
+
+void SkeletalModel::Load(GLOVE_HAND hand, const char* path, const void* data, size_t size)
+{
+	LOAD_REQUEST request;
+	request.hand = hand;
+	if (path)
+		request.path = path;
+	else
+		request.data.assign((const char*)data, (const char*)data + size);
+
+	std::lock_guard<std::mutex> lock(m_loader_mutex);
+
+	// A stopped loader doesn't come back to life, the load fails like the ones StopLoading drops
+	if (m_stop)
+	{
+		m_status[hand].State = GLOVE_MODEL_FAILED;
+		return;
+	}
+
+	m_requests.push_back(std::move(request));
+	m_status[hand].State = GLOVE_MODEL_LOADING;
+
+	if (!m_loader.joinable())
+		m_loader = std::thread(&SkeletalModel::LoaderThread, this);
+	m_loader_wake.notify_one();
+}
+
+void SkeletalModel::Reset(GLOVE_HAND hand)
+{
+	std::lock_guard<std::mutex> lock(m_loader_mutex);
+
+	for (auto it = m_requests.begin(); it != m_requests.end();)
+	{
+		if (it->hand == hand)
+			it = m_requests.erase(it);
+		else
+			++it;
+	}
+
+	std::atomic_store(&m_models[hand], std::atomic_load(&m_default));
+	m_status[hand].State = GLOVE_MODEL_DEFAULT;
+	m_status[hand].Generation++;
+}
+
+void SkeletalModel::GetStatus(GLOVE_HAND hand, GLOVE_MODEL_STATUS* status)
+{
+	std::lock_guard<std::mutex> lock(m_loader_mutex);
+	*status = m_status[hand];
+}
+
+void SkeletalModel::StartLoading()
+{
+	std::lock_guard<std::mutex> control_lock(m_control_mutex);
+	std::lock_guard<std::mutex> lock(m_loader_mutex);
+
+	m_stop = false;
+}
+
+void SkeletalModel::StopLoading()
+{
+	std::lock_guard<std::mutex> control_lock(m_control_mutex);
+
+	// The thread is taken out under the lock, so Load can't see it while it is joined
+	std::thread loader;
+	{
+		std::lock_guard<std::mutex> lock(m_loader_mutex);
+		m_stop = true;
+		loader.swap(m_loader);
+		m_loader_wake.notify_one();
+	}
+
+	if (loader.joinable())
+		loader.join();
+
+	std::lock_guard<std::mutex> lock(m_loader_mutex);
+	m_requests.clear();
+	for (int i = 0; i < 2; i++)
+	{
+		if (m_status[i].State == GLOVE_MODEL_LOADING)
+			m_status[i].State = GLOVE_MODEL_FAILED;
+	}
+}
+
+void SkeletalModel::LoaderThread()
+{
+	ThreadScope thread_scope(GLOVE_THREAD_LOADER);
+
+	std::unique_lock<std::mutex> lock(m_loader_mutex);
+	while (true)
+	{
+		m_loader_wake.wait(lock, [this] { return m_stop || !m_requests.empty(); });
+		if (m_stop)
+			break;
+
+		LOAD_REQUEST request = std::move(m_requests.front());
+		m_requests.pop_front();
+
+		// Importing takes a while, so readers of the status aren't held up
+		lock.unlock();
+		std::shared_ptr<const HandModel> model = request.path.empty() ?
+			Import(nullptr, request.data.data(), request.data.size()) :
+			Import(request.path.c_str(), nullptr, 0);
+		lock.lock();
+
+		// A reset while importing drops the model
+		GLOVE_MODEL_STATUS& status = m_status[request.hand];
+		if (status.State != GLOVE_MODEL_LOADING)
+			continue;
+
+		if (model)
+		{
+			std::atomic_store(&m_models[request.hand], model);
+			status.Generation++;
+		}
+
+		// Only the last of the queued loads decides the state
+		bool queued = false;
+		for (const LOAD_REQUEST& other : m_requests)
+			queued |= other.hand == request.hand;
+		if (!queued)
+			status.State = model ? GLOVE_MODEL_LOADED : GLOVE_MODEL_FAILED;
+	}
+}
@@ -17,32 +17,91 @@
 * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
 */
 
+
 #pragma once
 
 #include "Manus.h"
 #include "Glove.h"
+#include "HandModel.h"
 #include <fbxsdk.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
+/*
+ * Simulates the skeletal model of the hand.
+ *
+ * Hand models are imported with the FBX SDK and baked into a HandModel,
+ * which is published for each hand with an atomic store of a shared
+ * pointer. Simulating only loads that pointer, so it never waits for a
+ * model being loaded and a model that is in use stays alive until the
+ * last caller is done with it. Models other than the embedded one are
+ * loaded one after the other on a background thread.
+ */
 class SkeletalModel
 {
 private:
+	struct LOAD_REQUEST
+	{
+		GLOVE_HAND hand;
+		std::string path;
+		std::vector<char> data;
+	};
+
+	// The FBX SDK manager is only used while importing
 	FbxManager* m_sdk_manager;
-	FbxScene* m_scene;
-	FbxNode* m_palm_node;
-	FbxNode* m_palm_bone;
-	FbxNode* m_bone_nodes[GLOVE_FINGERS][3];
+	std::mutex m_import_mutex;
+	std::mutex m_scene_mutex;
+
+	std::shared_ptr<const HandModel> m_default;
+	std::shared_ptr<const HandModel> m_models[2];
 
-	GLOVE_POSE ToGlovePose(FbxAMatrix mat);
+	std::thread m_loader;
+	std::deque<LOAD_REQUEST> m_requests;
+	GLOVE_MODEL_STATUS m_status[2];
+	bool m_stop;
+	std::mutex m_loader_mutex;
+	std::condition_variable m_loader_wake;
 
-	// temporary states for the ToGlovePose function call
-	GLOVE_HAND temp_hand;
-	GLOVE_DATA temp_data;
-	GLOVE_QUATERNION temp_quaternion;
+	// Keeps StartLoading from running while StopLoading joins the thread
+	std::mutex m_control_mutex;
+
+	std::shared_ptr<const HandModel> Import(const char* path, const void* data, size_t size);
+	static std::shared_ptr<const HandModel> Bake(FbxScene* scene);
+	void LoaderThread();
 
 public:
 	SkeletalModel();
 	~SkeletalModel();
 
+	/*! Load the embedded hand model for both hands, does nothing if it is already loaded. Safe to call from any thread. */
 	bool InitializeScene();
 	bool Simulate(const GLOVE_DATA data, GLOVE_SKELETAL* model, GLOVE_HAND hand);
-};
\ No newline at end of file
+
+	/*! Orientation of the palm in the model for the orientation of a glove. */
+	static GLOVE_QUATERNION GetPalmOrientation(const GLOVE_QUATERNION& quaternion);
+
+	/*! \brief Queue a hand model to be loaded on the background thread.
+	*
+	*  After StopLoading the load fails right away until StartLoading is called.
+	*
+	*  \param path Path of an FBX file, or nullptr to load from memory.
+	*  \param data Contents of an FBX file, copied before this returns.
+	*/
+	void Load(GLOVE_HAND hand, const char* path, const void* data, size_t size);
+
+	/*! Switch back to the embedded hand model and drop the queued loads. */
+	void Reset(GLOVE_HAND hand);
+
+	void GetStatus(GLOVE_HAND hand, GLOVE_MODEL_STATUS* status);
+
+	/*! Accept loads again after StopLoading. */
+	void StartLoading();
+
+	/*! Stop the background thread, the queued loads are dropped. */
+	void StopLoading();
+};
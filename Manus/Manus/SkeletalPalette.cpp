@@ -0,0 +1,156 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "SkeletalPalette.h"
+
+#include <stdlib.h>
+#include <xmmintrin.h>
+
+static_assert(sizeof(GLOVE_SKELETAL) == GLOVE_BONES * sizeof(GLOVE_POSE), "The skeletal model must be an array of poses");
+
+bool SkeletalPalette::IsValid(const GLOVE_PALETTE_LAYOUT& layout)
+{
+	if (layout.Format != GLOVE_PALETTE_3X4 && layout.Format != GLOVE_PALETTE_4X4_ROWS &&
+		layout.Format != GLOVE_PALETTE_4X4_COLUMNS)
+		return false;
+
+	if (layout.BoneCount > GLOVE_PALETTE_MAX_BONES)
+		return false;
+
+	for (unsigned int i = 0; i < layout.BoneCount; i++)
+	{
+		if (layout.Bones[i] >= GLOVE_BONES)
+			return false;
+	}
+
+	// Every source axis must be used exactly once
+	int used = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		int axis = abs(layout.Axes[i]);
+		if (axis < 1 || axis > 3)
+			return false;
+		used |= 1 << (axis - 1);
+	}
+
+	return used == 0x7;
+}
+
+size_t SkeletalPalette::GetMatrixSize(GLOVE_PALETTE_FORMAT format)
+{
+	return format == GLOVE_PALETTE_3X4 ? 12 : 16;
+}
+
+void SkeletalPalette::Write(const GLOVE_SKELETAL& model, const GLOVE_PALETTE_LAYOUT& layout, float* palette)
+{
+	const GLOVE_POSE* poses = (const GLOVE_POSE*)&model;
+	size_t size = GetMatrixSize(layout.Format);
+
+	// The axis convention turns R into C * R * C^T and t into C * t, with C a
+	// signed permutation, so every element is a signed element of the source.
+	int axis[3];
+	__m128 sign[3];
+	for (int i = 0; i < 3; i++)
+	{
+		axis[i] = abs(layout.Axes[i]) - 1;
+		sign[i] = _mm_set1_ps(layout.Axes[i] < 0 ? -1.0f : 1.0f);
+	}
+
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (unsigned int first = 0; first < layout.BoneCount; first += 4)
+	{
+		// Gather the next four bones, repeating the last one to fill the lanes
+		unsigned int lanes = layout.BoneCount - first < 4 ? layout.BoneCount - first : 4;
+		const GLOVE_POSE* bone[4];
+		for (unsigned int i = 0; i < 4; i++)
+			bone[i] = &poses[layout.Bones[first + (i < lanes ? i : lanes - 1)]];
+
+		__m128 w = _mm_loadu_ps(&bone[0]->orientation.w);
+		__m128 x = _mm_loadu_ps(&bone[1]->orientation.w);
+		__m128 y = _mm_loadu_ps(&bone[2]->orientation.w);
+		__m128 z = _mm_loadu_ps(&bone[3]->orientation.w);
+		_MM_TRANSPOSE4_PS(w, x, y, z);
+
+		__m128 t[3] = {
+			_mm_set_ps(bone[3]->position.x, bone[2]->position.x, bone[1]->position.x, bone[0]->position.x),
+			_mm_set_ps(bone[3]->position.y, bone[2]->position.y, bone[1]->position.y, bone[0]->position.y),
+			_mm_set_ps(bone[3]->position.z, bone[2]->position.z, bone[1]->position.z, bone[0]->position.z),
+		};
+
+		// Rotation matrix of the quaternions
+		__m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+		__m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+		__m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+		__m128 r[3][3];
+		r[0][0] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)));
+		r[0][1] = _mm_mul_ps(two, _mm_sub_ps(xy, wz));
+		r[0][2] = _mm_mul_ps(two, _mm_add_ps(xz, wy));
+		r[1][0] = _mm_mul_ps(two, _mm_add_ps(xy, wz));
+		r[1][1] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)));
+		r[1][2] = _mm_mul_ps(two, _mm_sub_ps(yz, wx));
+		r[2][0] = _mm_mul_ps(two, _mm_sub_ps(xz, wy));
+		r[2][1] = _mm_mul_ps(two, _mm_add_ps(yz, wx));
+		r[2][2] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)));
+
+		// Apply the axis convention
+		__m128 m[3][4];
+		for (int i = 0; i < 3; i++)
+		{
+			for (int j = 0; j < 3; j++)
+				m[i][j] = _mm_mul_ps(_mm_mul_ps(sign[i], sign[j]), r[axis[i]][axis[j]]);
+			m[i][3] = _mm_mul_ps(sign[i], t[axis[i]]);
+		}
+
+		// Transpose from one element of four bones to the rows or columns of each bone
+		__m128 out[4][4];
+		if (layout.Format == GLOVE_PALETTE_4X4_COLUMNS)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				__m128 a = m[0][j], b = m[1][j], c = m[2][j], d = j < 3 ? zero : one;
+				_MM_TRANSPOSE4_PS(a, b, c, d);
+				out[0][j] = a; out[1][j] = b; out[2][j] = c; out[3][j] = d;
+			}
+		}
+		else
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				__m128 a = m[i][0], b = m[i][1], c = m[i][2], d = m[i][3];
+				_MM_TRANSPOSE4_PS(a, b, c, d);
+				out[0][i] = a; out[1][i] = b; out[2][i] = c; out[3][i] = d;
+			}
+
+			for (int k = 0; k < 4; k++)
+				out[k][3] = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+		}
+
+		for (unsigned int k = 0; k < lanes; k++)
+		{
+			float* matrix = palette + (first + k) * size;
+			for (size_t row = 0; row < size / 4; row++)
+				_mm_storeu_ps(matrix + row * 4, out[k][row]);
+		}
+	}
+}
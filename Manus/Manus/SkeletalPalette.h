@@ -0,0 +1,47 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Manus.h"
+
+#include <stddef.h>
+
+/*
+ * Converts a skeletal model into a palette of bone matrices for skinning.
+ *
+ * The bones are converted four at a time with SSE: the quaternions are
+ * turned into rotation matrices, moved into the axis convention of the
+ * caller and transposed straight into the layout of the palette.
+ */
+class SkeletalPalette
+{
+public:
+	/*! Check the bones and that the axes are a signed permutation of x, y and z. */
+	static bool IsValid(const GLOVE_PALETTE_LAYOUT& layout);
+
+	/*! Number of floats of every matrix in the palette. */
+	static size_t GetMatrixSize(GLOVE_PALETTE_FORMAT format);
+
+	/*! Write the palette, which must have room for layout.BoneCount matrices. */
+	static void Write(const GLOVE_SKELETAL& model, const GLOVE_PALETTE_LAYOUT& layout, float* palette);
+
+private:
+	SkeletalPalette();
+};
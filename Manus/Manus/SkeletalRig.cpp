@@ -0,0 +1,354 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "SkeletalRig.h"
+#include "ManusMath.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <xmmintrin.h>
+
+// The poses of the model are followed by the global poses of the rig
+#define RIG_SLOTS (GLOVE_BONES + GLOVE_RIG_MAX_BONES)
+
+/*! Multiply four pairs of quaternions stored as w, x, y and z vectors. */
+static inline void Multiply(const __m128* a, const __m128* b, __m128* r)
+{
+	r[0] = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(a[0], b[0]), _mm_mul_ps(a[1], b[1])),
+		_mm_add_ps(_mm_mul_ps(a[2], b[2]), _mm_mul_ps(a[3], b[3])));
+	r[1] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[0], b[1]), _mm_mul_ps(a[1], b[0])),
+		_mm_sub_ps(_mm_mul_ps(a[2], b[3]), _mm_mul_ps(a[3], b[2])));
+	r[2] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(a[0], b[2]), _mm_mul_ps(a[1], b[3])),
+		_mm_add_ps(_mm_mul_ps(a[2], b[0]), _mm_mul_ps(a[3], b[1])));
+	r[3] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[0], b[3]), _mm_mul_ps(a[1], b[2])),
+		_mm_sub_ps(_mm_mul_ps(a[3], b[0]), _mm_mul_ps(a[2], b[1])));
+}
+
+static GLOVE_QUATERNION Conjugate(const GLOVE_QUATERNION& q)
+{
+	GLOVE_QUATERNION result = { q.w, -q.x, -q.y, -q.z };
+	return result;
+}
+
+SkeletalRig::SkeletalRig()
+	: m_hand(GLOVE_LEFT)
+	, m_space(GLOVE_RIG_LOCAL)
+	, m_bone_count(0)
+	, m_rig()
+	, m_generation(0)
+	, m_handedness(1.0f)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		m_axis[i] = i;
+		m_sign[i] = 1.0f;
+	}
+}
+
+void SkeletalRig::ToRig(const GLOVE_POSE& pose, GLOVE_POSE& result) const
+{
+	const float* v = &pose.orientation.x;
+	const float* p = &pose.position.x;
+	float* rv = &result.orientation.x;
+	float* rp = &result.position.x;
+
+	// A reflection of the axes also flips the direction of the rotation
+	result.orientation.w = pose.orientation.w;
+	for (int i = 0; i < 3; i++)
+	{
+		rv[i] = m_handedness * m_sign[i] * v[m_axis[i]];
+		rp[i] = m_sign[i] * p[m_axis[i]];
+	}
+}
+
+bool SkeletalRig::Compile(GLOVE_HAND hand, const GLOVE_RIG& rig, const GLOVE_SKELETAL& rest, unsigned int generation)
+{
+	if (rig.Space != GLOVE_RIG_LOCAL && rig.Space != GLOVE_RIG_GLOBAL)
+		return false;
+
+	if (rig.BoneCount == 0 || rig.BoneCount > GLOVE_RIG_MAX_BONES)
+		return false;
+
+	// Every source axis must be used exactly once
+	int used = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		int axis = abs(rig.Axes[i]);
+		if (axis < 1 || axis > 3)
+			return false;
+		used |= 1 << (axis - 1);
+	}
+	if (used != 0x7)
+		return false;
+
+	m_hand = hand;
+	m_space = rig.Space;
+	m_bone_count = rig.BoneCount;
+	m_rig = rig;
+	m_generation = generation;
+
+	// The determinant of the signed permutation tells if it is a reflection
+	m_handedness = 1.0f;
+	for (int i = 0; i < 3; i++)
+	{
+		m_axis[i] = abs(rig.Axes[i]) - 1;
+		m_sign[i] = rig.Axes[i] < 0 ? -1.0f : 1.0f;
+		m_handedness *= m_sign[i];
+	}
+	if ((m_axis[0] > m_axis[1]) ^ (m_axis[0] > m_axis[2]) ^ (m_axis[1] > m_axis[2]))
+		m_handedness = -m_handedness;
+
+	// Global rest rotations and depths of the rig
+	GLOVE_QUATERNION local[GLOVE_RIG_MAX_BONES];
+	GLOVE_QUATERNION global[GLOVE_RIG_MAX_BONES];
+	unsigned int depth[GLOVE_RIG_MAX_BONES];
+	unsigned int max_depth = 0;
+	for (unsigned int i = 0; i < rig.BoneCount; i++)
+	{
+		const GLOVE_RIG_BONE& bone = rig.Bones[i];
+		if (bone.Parent < -1 || bone.Parent >= (int)i || bone.Source < -1 || bone.Source >= GLOVE_BONES)
+			return false;
+
+		const GLOVE_QUATERNION& q = bone.Rest.orientation;
+		float norm = sqrtf(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+		if (!(norm > 1e-6f))
+			return false;
+		local[i] = { q.w / norm, q.x / norm, q.y / norm, q.z / norm };
+
+		if (bone.Parent < 0)
+		{
+			global[i] = local[i];
+			depth[i] = 0;
+		}
+		else
+		{
+			global[i] = ManusMath::QuaternionMultiply(global[bone.Parent], local[i]);
+			depth[i] = depth[bone.Parent] + 1;
+		}
+
+		if (depth[i] > max_depth)
+			max_depth = depth[i];
+	}
+
+	// Rest pose of the model in the axes of the rig
+	const GLOVE_POSE* source = (const GLOVE_POSE*)&rest;
+	GLOVE_POSE source_rest[GLOVE_BONES];
+	for (int i = 0; i < GLOVE_BONES; i++)
+		ToRig(source[i], source_rest[i]);
+
+	// A driven bone keeps the difference between its rest pose and the rest
+	// pose of its source, an undriven bone keeps its rest pose to the parent.
+	GLOVE_QUATERNION rotation[GLOVE_RIG_MAX_BONES];
+	for (unsigned int i = 0; i < rig.BoneCount; i++)
+	{
+		int s = rig.Bones[i].Source;
+		if (s >= 0)
+			rotation[i] = ManusMath::QuaternionMultiply(Conjugate(source_rest[s].orientation), global[i]);
+		else
+			rotation[i] = local[i];
+	}
+
+	m_roots.clear();
+	for (int i = 0; i < 4; i++)
+		m_rotation[i].clear();
+	for (int i = 0; i < 3; i++)
+		m_offset[i].clear();
+	m_left.clear();
+	m_parent.clear();
+	m_bone.clear();
+
+	for (unsigned int i = 0; i < rig.BoneCount; i++)
+	{
+		const GLOVE_RIG_BONE& bone = rig.Bones[i];
+		if (bone.Parent >= 0)
+			continue;
+
+		RIG_ROOT root;
+		root.bone = i;
+		root.source = bone.Source;
+		root.rotation = rotation[i];
+		root.position = bone.Rest.position;
+		root.source_position = bone.Source >= 0 ? source_rest[bone.Source].position : GLOVE_VECTOR{ 0.0f, 0.0f, 0.0f };
+		root.scale = rig.Scale;
+		m_roots.push_back(root);
+	}
+
+	// Bones at the same depth don't depend on each other
+	for (unsigned int d = 1; d <= max_depth; d++)
+	{
+		std::vector<unsigned int> level;
+		for (unsigned int i = 0; i < rig.BoneCount; i++)
+		{
+			if (depth[i] == d)
+				level.push_back(i);
+		}
+
+		// Pad the last batch by repeating its last bone
+		while (level.size() % 4 != 0)
+			level.push_back(level.back());
+
+		for (unsigned int i : level)
+		{
+			const GLOVE_RIG_BONE& bone = rig.Bones[i];
+			m_rotation[0].push_back(rotation[i].w);
+			m_rotation[1].push_back(rotation[i].x);
+			m_rotation[2].push_back(rotation[i].y);
+			m_rotation[3].push_back(rotation[i].z);
+			m_offset[0].push_back(bone.Rest.position.x);
+			m_offset[1].push_back(bone.Rest.position.y);
+			m_offset[2].push_back(bone.Rest.position.z);
+			m_left.push_back((uint16_t)(bone.Source >= 0 ? bone.Source : GLOVE_BONES + bone.Parent));
+			m_parent.push_back((uint16_t)(GLOVE_BONES + bone.Parent));
+			m_bone.push_back((uint16_t)i);
+		}
+	}
+
+	return true;
+}
+
+void SkeletalRig::Evaluate(const GLOVE_SKELETAL& model, GLOVE_POSE* poses) const
+{
+	GLOVE_POSE slots[RIG_SLOTS];
+	GLOVE_POSE* global = slots + GLOVE_BONES;
+
+	const GLOVE_POSE* source = (const GLOVE_POSE*)&model;
+	for (int i = 0; i < GLOVE_BONES; i++)
+		ToRig(source[i], slots[i]);
+
+	for (const RIG_ROOT& root : m_roots)
+	{
+		GLOVE_POSE& pose = global[root.bone];
+		if (root.source < 0)
+		{
+			pose.orientation = root.rotation;
+			pose.position = root.position;
+		}
+		else
+		{
+			const GLOVE_POSE& s = slots[root.source];
+			pose.orientation = ManusMath::QuaternionMultiply(s.orientation, root.rotation);
+			pose.position.x = root.position.x + root.scale * (s.position.x - root.source_position.x);
+			pose.position.y = root.position.y + root.scale * (s.position.y - root.source_position.y);
+			pose.position.z = root.position.z + root.scale * (s.position.z - root.source_position.z);
+		}
+
+		// The local pose of a root is its global pose
+		poses[root.bone] = pose;
+	}
+
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (size_t k = 0; k < m_bone.size(); k += 4)
+	{
+		const GLOVE_POSE* left[4];
+		const GLOVE_POSE* parent[4];
+		for (int i = 0; i < 4; i++)
+		{
+			left[i] = &slots[m_left[k + i]];
+			parent[i] = &slots[m_parent[k + i]];
+		}
+
+		__m128 a[4] = {
+			_mm_loadu_ps(&left[0]->orientation.w),
+			_mm_loadu_ps(&left[1]->orientation.w),
+			_mm_loadu_ps(&left[2]->orientation.w),
+			_mm_loadu_ps(&left[3]->orientation.w),
+		};
+		_MM_TRANSPOSE4_PS(a[0], a[1], a[2], a[3]);
+
+		__m128 b[4];
+		for (int i = 0; i < 4; i++)
+			b[i] = _mm_loadu_ps(&m_rotation[i][k]);
+
+		__m128 g[4];
+		Multiply(a, b, g);
+
+		// Parent rotations, conjugated for the local rotation
+		__m128 p[4] = {
+			_mm_loadu_ps(&parent[0]->orientation.w),
+			_mm_loadu_ps(&parent[1]->orientation.w),
+			_mm_loadu_ps(&parent[2]->orientation.w),
+			_mm_loadu_ps(&parent[3]->orientation.w),
+		};
+		_MM_TRANSPOSE4_PS(p[0], p[1], p[2], p[3]);
+
+		// Rotate the rest offset by the parent: v + w * t + u x t with t = 2 * u x v
+		__m128 v[3];
+		for (int i = 0; i < 3; i++)
+			v[i] = _mm_loadu_ps(&m_offset[i][k]);
+
+		__m128 t[3] = {
+			_mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(p[2], v[2]), _mm_mul_ps(p[3], v[1]))),
+			_mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(p[3], v[0]), _mm_mul_ps(p[1], v[2]))),
+			_mm_mul_ps(two, _mm_sub_ps(_mm_mul_ps(p[1], v[1]), _mm_mul_ps(p[2], v[0]))),
+		};
+
+		__m128 position[3] = {
+			_mm_set_ps(parent[3]->position.x, parent[2]->position.x, parent[1]->position.x, parent[0]->position.x),
+			_mm_set_ps(parent[3]->position.y, parent[2]->position.y, parent[1]->position.y, parent[0]->position.y),
+			_mm_set_ps(parent[3]->position.z, parent[2]->position.z, parent[1]->position.z, parent[0]->position.z),
+		};
+
+		position[0] = _mm_add_ps(_mm_add_ps(position[0], v[0]), _mm_add_ps(_mm_mul_ps(p[0], t[0]),
+			_mm_sub_ps(_mm_mul_ps(p[2], t[2]), _mm_mul_ps(p[3], t[1]))));
+		position[1] = _mm_add_ps(_mm_add_ps(position[1], v[1]), _mm_add_ps(_mm_mul_ps(p[0], t[1]),
+			_mm_sub_ps(_mm_mul_ps(p[3], t[0]), _mm_mul_ps(p[1], t[2]))));
+		position[2] = _mm_add_ps(_mm_add_ps(position[2], v[2]), _mm_add_ps(_mm_mul_ps(p[0], t[2]),
+			_mm_sub_ps(_mm_mul_ps(p[1], t[1]), _mm_mul_ps(p[2], t[0]))));
+
+		alignas(16) float x[4], y[4], z[4];
+		_mm_store_ps(x, position[0]);
+		_mm_store_ps(y, position[1]);
+		_mm_store_ps(z, position[2]);
+
+		// The local rotation is the conjugate of the parent times the global rotation
+		__m128 l[4];
+		if (m_space == GLOVE_RIG_LOCAL)
+		{
+			p[1] = _mm_sub_ps(zero, p[1]);
+			p[2] = _mm_sub_ps(zero, p[2]);
+			p[3] = _mm_sub_ps(zero, p[3]);
+			Multiply(p, g, l);
+			_MM_TRANSPOSE4_PS(l[0], l[1], l[2], l[3]);
+		}
+
+		_MM_TRANSPOSE4_PS(g[0], g[1], g[2], g[3]);
+
+		for (int i = 0; i < 4; i++)
+		{
+			GLOVE_POSE& pose = global[m_bone[k + i]];
+			_mm_storeu_ps(&pose.orientation.w, g[i]);
+			pose.position = { x[i], y[i], z[i] };
+
+			GLOVE_POSE& out = poses[m_bone[k + i]];
+			if (m_space == GLOVE_RIG_LOCAL)
+			{
+				_mm_storeu_ps(&out.orientation.w, l[i]);
+				out.position = { m_offset[0][k + i], m_offset[1][k + i], m_offset[2][k + i] };
+			}
+			else
+			{
+				out = pose;
+			}
+		}
+	}
+}
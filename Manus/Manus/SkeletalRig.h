@@ -0,0 +1,92 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Manus.h"
+
+#include <stdint.h>
+#include <vector>
+
+/*
+ * Retargets the skeletal model to a rig of the application.
+ *
+ * Compiling the rig folds the change of axes, the rest pose of the model
+ * and the rest pose of the rig into a single rotation per bone, so the
+ * global rotation of a bone is the rotation of its source bone times a
+ * constant. The bones are sorted by depth in the hierarchy and grouped in
+ * batches of four without dependencies between them, which are evaluated
+ * with SSE. The roots are evaluated first, on their own.
+ */
+class SkeletalRig
+{
+private:
+	GLOVE_HAND m_hand;
+	GLOVE_RIG_SPACE m_space;
+	unsigned int m_bone_count;
+
+	// Kept to compile the rig again for another hand model
+	GLOVE_RIG m_rig;
+	unsigned int m_generation;
+
+	// Signed permutation of the axes
+	int m_axis[3];
+	float m_sign[3];
+	float m_handedness;
+
+	struct RIG_ROOT
+	{
+		unsigned int bone;
+		int source;
+		GLOVE_QUATERNION rotation;
+		GLOVE_VECTOR position;
+		GLOVE_VECTOR source_position;
+		float scale;
+	};
+	std::vector<RIG_ROOT> m_roots;
+
+	// Batches of four bones as a structure of arrays, the global rotation of
+	// a bone is the pose in slot left times the constant rotation.
+	std::vector<float> m_rotation[4];
+	std::vector<float> m_offset[3];
+	std::vector<uint16_t> m_left;
+	std::vector<uint16_t> m_parent;
+	std::vector<uint16_t> m_bone;
+
+	void ToRig(const GLOVE_POSE& pose, GLOVE_POSE& result) const;
+
+public:
+	SkeletalRig();
+
+	/*! \brief Compile a rig for the rest pose of the skeletal model.
+	*
+	*  \param generation Generation of the hand model the rest pose is from.
+	*  \return False if the rig is invalid.
+	*/
+	bool Compile(GLOVE_HAND hand, const GLOVE_RIG& rig, const GLOVE_SKELETAL& rest, unsigned int generation);
+
+	GLOVE_HAND GetHand() const { return m_hand; }
+	const GLOVE_RIG& GetRig() const { return m_rig; }
+	unsigned int GetGeneration() const { return m_generation; }
+	unsigned int GetBoneCount() const { return m_bone_count; }
+
+	/*! Write the poses of the rig, which must have room for every bone. */
+	void Evaluate(const GLOVE_SKELETAL& model, GLOVE_POSE* poses) const;
+};
@@ -0,0 +1,90 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+// Keeps the indices of the producer and consumer on separate cache lines
+#define SPSC_CACHE_LINE 64
+
+/*
+ * Bounded lock-free queue for exactly one producer and one consumer thread.
+ *
+ * The capacity is rounded up to a power of two. Push fails instead of
+ * blocking when the queue is full, so the producer never waits.
+ */
+template <typename T>
+class SpscQueue
+{
+private:
+	std::vector<T> m_items;
+	size_t m_mask;
+
+	char m_pad0[SPSC_CACHE_LINE];
+	std::atomic<size_t> m_head;
+	char m_pad1[SPSC_CACHE_LINE];
+	std::atomic<size_t> m_tail;
+	char m_pad2[SPSC_CACHE_LINE];
+
+public:
+	explicit SpscQueue(size_t capacity)
+		: m_head(0), m_tail(0)
+	{
+		size_t size = 1;
+		while (size < capacity)
+			size <<= 1;
+
+		m_items.resize(size);
+		m_mask = size - 1;
+	}
+
+	/*! Called by the producer, returns false if the queue is full. */
+	bool Push(const T& item)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+			return false;
+
+		m_items[tail & m_mask] = item;
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/*! Called by the consumer, returns false if the queue is empty. */
+	bool Pop(T& item)
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+		if (head == m_tail.load(std::memory_order_acquire))
+			return false;
+
+		item = m_items[head & m_mask];
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/*! Number of queued items, exact only when called by the producer or consumer. */
+	size_t GetSize() const
+	{
+		return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+	}
+
+	size_t GetCapacity() const { return m_mask + 1; }
+};
@@ -0,0 +1,172 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "StreamClient.h"
+#include "ThreadRegistry.h"
+
+// How often the receive thread checks whether it should stop
+#define RECEIVE_TIMEOUT 100
+
+StreamClient::StreamClient()
+	: m_running(false)
+	, m_socket(INVALID_SOCKET)
+	, m_multicast(false)
+{
+	memset(&m_membership, 0, sizeof(m_membership));
+	memset(m_samples, 0, sizeof(m_samples));
+	m_received[GLOVE_LEFT] = m_received[GLOVE_RIGHT] = false;
+}
+
+StreamClient::~StreamClient()
+{
+	Disconnect();
+}
+
+bool StreamClient::Connect(const char* address, unsigned short port)
+{
+	if (m_running)
+		return false;
+
+	in_addr addr;
+	if (inet_pton(AF_INET, address, &addr) != 1)
+		return false;
+
+	WSADATA wsa_data;
+	if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+		return false;
+
+	m_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (m_socket == INVALID_SOCKET)
+	{
+		WSACleanup();
+		return false;
+	}
+
+	// Allow several clients on one machine to listen to the same group
+	m_multicast = IN_MULTICAST(ntohl(addr.s_addr));
+	DWORD reuse = m_multicast;
+	setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+	DWORD timeout = RECEIVE_TIMEOUT;
+	setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+
+	sockaddr_in local;
+	memset(&local, 0, sizeof(local));
+	local.sin_family = AF_INET;
+	local.sin_port = htons(port);
+	local.sin_addr.s_addr = m_multicast ? htonl(INADDR_ANY) : addr.s_addr;
+
+	bool bound = bind(m_socket, (const sockaddr*)&local, sizeof(local)) != SOCKET_ERROR;
+
+	if (bound && m_multicast)
+	{
+		m_membership.imr_multiaddr = addr;
+		m_membership.imr_interface.s_addr = htonl(INADDR_ANY);
+		bound = setsockopt(m_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP,
+			(const char*)&m_membership, sizeof(m_membership)) != SOCKET_ERROR;
+	}
+
+	if (!bound)
+	{
+		closesocket(m_socket);
+		m_socket = INVALID_SOCKET;
+		WSACleanup();
+		return false;
+	}
+
+	m_decoders[GLOVE_LEFT] = StreamDecoder();
+	m_decoders[GLOVE_RIGHT] = StreamDecoder();
+	m_received[GLOVE_LEFT] = m_received[GLOVE_RIGHT] = false;
+
+	m_running = true;
+	m_thread = std::thread(&StreamClient::ReceiveThread, this);
+
+	return true;
+}
+
+void StreamClient::Disconnect()
+{
+	if (!m_running)
+		return;
+
+	// Clear the flag under the lock, a reader could miss the wakeup otherwise
+	{
+		std::lock_guard<std::mutex> lk(m_sample_mutex);
+		m_running = false;
+	}
+	m_sample_block.notify_all();
+	m_thread.join();
+
+	if (m_multicast)
+		setsockopt(m_socket, IPPROTO_IP, IP_DROP_MEMBERSHIP, (const char*)&m_membership, sizeof(m_membership));
+
+	closesocket(m_socket);
+	m_socket = INVALID_SOCKET;
+	WSACleanup();
+}
+
+bool StreamClient::GetData(GLOVE_HAND hand, GLOVE_DATA* data, unsigned int timeout)
+{
+	std::unique_lock<std::mutex> lk(m_sample_mutex);
+
+	// Optionally wait until the next package for this hand is received
+	if (timeout > 0)
+	{
+		unsigned int packet = m_samples[hand].data.PacketNumber;
+		m_sample_block.wait_for(lk, std::chrono::milliseconds(timeout),
+			[&] { return !m_running || m_samples[hand].data.PacketNumber != packet; });
+		if (!m_running)
+			return false;
+	}
+
+	*data = m_samples[hand].data;
+
+	return m_received[hand];
+}
+
+void StreamClient::ReceiveThread()
+{
+	ThreadScope thread_scope(GLOVE_THREAD_STREAM);
+
+	uint8_t buffer[STREAM_MAX_PACKET];
+
+	while (m_running)
+	{
+		int length = recv(m_socket, (char*)buffer, sizeof(buffer), 0);
+		if (length <= 0)
+			continue;
+
+		GLOVE_HAND hand;
+		if (!StreamDecoder::PeekHand(buffer, length, &hand))
+			continue;
+
+		// Decode outside of the lock, only the copy is done while holding it
+		GLOVE_SAMPLE sample;
+		if (!m_decoders[hand].Decode(buffer, length, &sample))
+			continue;
+
+		{
+			std::lock_guard<std::mutex> lk(m_sample_mutex);
+			m_samples[hand] = sample;
+			m_received[hand] = true;
+		}
+		m_sample_block.notify_all();
+	}
+}
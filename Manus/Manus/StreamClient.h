@@ -0,0 +1,65 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "StreamProtocol.h"
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class StreamClient
+{
+private:
+	std::atomic<bool> m_running;
+	SOCKET m_socket;
+	ip_mreq m_membership;
+	bool m_multicast;
+	std::thread m_thread;
+
+	StreamDecoder m_decoders[2];
+	GLOVE_SAMPLE m_samples[2];
+	bool m_received[2];
+
+	std::mutex m_sample_mutex;
+	std::condition_variable m_sample_block;
+
+public:
+	StreamClient();
+	~StreamClient();
+
+	/*! \brief Start receiving samples on the given port.
+	*
+	*  If the address is a multicast group the client joins it,
+	*  otherwise the address selects the local interface to listen on.
+	*/
+	bool Connect(const char* address, unsigned short port);
+	void Disconnect();
+	bool IsConnected() const { return m_running; }
+
+	/*! Same semantics as Glove::GetData, but for the remote glove. */
+	bool GetData(GLOVE_HAND hand, GLOVE_DATA* data, unsigned int timeout);
+
+private:
+	void ReceiveThread();
+};
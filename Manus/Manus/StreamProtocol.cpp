@@ -0,0 +1,298 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "StreamProtocol.h"
+#include "ManusMath.h"
+
+#include <math.h>
+
+// Same scale as the glove report so the acceleration survives the round trip
+#define ACCEL_SCALE 16384.0f
+#define FINGER_SCALE 255.0f
+
+// Each of the three smallest components is stored in 15 bits
+#define QUAT_BITS 15
+#define QUAT_RANGE ((1 << (QUAT_BITS - 1)) - 1)
+#define QUAT_SQRT2 1.41421356f
+
+static void WriteU32(uint8_t* p, uint32_t v)
+{
+	for (int i = 0; i < 4; i++)
+		p[i] = (uint8_t)(v >> (i * 8));
+}
+
+static uint32_t ReadU32(const uint8_t* p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void WriteU64(uint8_t* p, uint64_t v)
+{
+	for (int i = 0; i < 8; i++)
+		p[i] = (uint8_t)(v >> (i * 8));
+}
+
+static uint64_t ReadU64(const uint8_t* p)
+{
+	uint64_t v = 0;
+	for (int i = 7; i >= 0; i--)
+		v = (v << 8) | p[i];
+	return v;
+}
+
+static int16_t QuantizeAccel(float value)
+{
+	float scaled = value * ACCEL_SCALE;
+	if (scaled > 32767.0f) scaled = 32767.0f;
+	if (scaled < -32768.0f) scaled = -32768.0f;
+	return (int16_t)lrintf(scaled);
+}
+
+static uint8_t QuantizeFinger(float value)
+{
+	if (value < 0.0f) value = 0.0f;
+	if (value > 1.0f) value = 1.0f;
+	return (uint8_t)lrintf(value * FINGER_SCALE);
+}
+
+static void EncodeQuaternion(const GLOVE_QUATERNION& q, uint8_t* p)
+{
+	float c[4] = { q.w, q.x, q.y, q.z };
+
+	// Find the largest component, it will be reconstructed from the others
+	int largest = 0;
+	float norm = 0.0f;
+	for (int i = 0; i < 4; i++)
+	{
+		norm += c[i] * c[i];
+		if (fabsf(c[i]) > fabsf(c[largest]))
+			largest = i;
+	}
+
+	// q and -q are the same rotation, so flip it to make the largest positive
+	float scale = (norm > 0.0f ? 1.0f / sqrtf(norm) : 1.0f) * (c[largest] < 0.0f ? -1.0f : 1.0f);
+
+	uint64_t bits = (uint64_t)largest;
+	for (int i = 0; i < 4; i++)
+	{
+		if (i == largest)
+			continue;
+
+		// The remaining components are within +-1/sqrt(2)
+		long v = lrintf(c[i] * scale * QUAT_SQRT2 * QUAT_RANGE);
+		if (v > QUAT_RANGE) v = QUAT_RANGE;
+		if (v < -QUAT_RANGE) v = -QUAT_RANGE;
+		bits = (bits << QUAT_BITS) | (uint64_t)(v + QUAT_RANGE);
+	}
+
+	for (int i = 0; i < 6; i++)
+		p[i] = (uint8_t)(bits >> (i * 8));
+}
+
+static void DecodeQuaternion(const uint8_t* p, GLOVE_QUATERNION* q)
+{
+	uint64_t bits = 0;
+	for (int i = 5; i >= 0; i--)
+		bits = (bits << 8) | p[i];
+
+	int largest = (int)(bits >> (3 * QUAT_BITS)) & 0x3;
+
+	float c[4];
+	float sum = 0.0f;
+	for (int i = 3; i >= 0; i--)
+	{
+		if (i == largest)
+			continue;
+
+		long v = (long)(bits & ((1 << QUAT_BITS) - 1)) - QUAT_RANGE;
+		bits >>= QUAT_BITS;
+		c[i] = v / (QUAT_SQRT2 * QUAT_RANGE);
+		sum += c[i] * c[i];
+	}
+	c[largest] = sum < 1.0f ? sqrtf(1.0f - sum) : 0.0f;
+
+	q->w = c[0];
+	q->x = c[1];
+	q->y = c[2];
+	q->z = c[3];
+}
+
+StreamEncoder::StreamEncoder()
+	: m_count(0)
+	, m_key_packet(0)
+{
+	memset(m_key_fingers, 0, sizeof(m_key_fingers));
+}
+
+size_t StreamEncoder::Encode(const GLOVE_SAMPLE& sample, uint8_t* buffer)
+{
+	uint8_t fingers[GLOVE_FINGERS];
+	for (int i = 0; i < GLOVE_FINGERS; i++)
+		fingers[i] = QuantizeFinger(sample.data.Fingers[i]);
+
+	// Deltas are relative to the last keyframe, so fall back to a keyframe
+	// if one of them doesn't fit in a byte.
+	bool keyframe = (m_count++ % STREAM_KEYFRAME_INTERVAL) == 0;
+	for (int i = 0; i < GLOVE_FINGERS && !keyframe; i++)
+	{
+		int delta = fingers[i] - m_key_fingers[i];
+		if (delta > 127 || delta < -128)
+			keyframe = true;
+	}
+
+	if (keyframe)
+	{
+		m_count = 1;
+		m_key_packet = sample.data.PacketNumber;
+		memcpy(m_key_fingers, fingers, sizeof(fingers));
+	}
+
+	uint8_t flags = (sample.hand == GLOVE_RIGHT ? STREAM_FLAGS_RIGHT : 0) |
+		(keyframe ? STREAM_FLAGS_KEYFRAME : 0);
+
+	uint8_t* p = buffer;
+	*p++ = STREAM_MAGIC;
+	*p++ = (STREAM_VERSION << 4) | flags;
+	WriteU32(p, sample.data.PacketNumber); p += 4;
+	WriteU64(p, sample.timestamp); p += 8;
+	*p++ = (uint8_t)m_key_packet;
+
+	EncodeQuaternion(sample.data.Quaternion, p); p += 6;
+
+	const float* accel = &sample.data.Acceleration.x;
+	for (int i = 0; i < GLOVE_AXES; i++)
+	{
+		int16_t value = QuantizeAccel(accel[i]);
+		*p++ = (uint8_t)value;
+		*p++ = (uint8_t)(value >> 8);
+	}
+
+	if (keyframe)
+	{
+		memcpy(p, fingers, GLOVE_FINGERS);
+		p += GLOVE_FINGERS;
+	}
+	else
+	{
+		// Only send the fingers that moved since the keyframe
+		uint8_t* mask = p++;
+		*mask = 0;
+		for (int i = 0; i < GLOVE_FINGERS; i++)
+		{
+			if (fingers[i] != m_key_fingers[i])
+			{
+				*mask |= 1 << i;
+				*p++ = (uint8_t)(int8_t)(fingers[i] - m_key_fingers[i]);
+			}
+		}
+	}
+
+	return p - buffer;
+}
+
+StreamDecoder::StreamDecoder()
+	: m_has_key(false)
+	, m_key_packet(0)
+	, m_last_packet(0)
+	, m_lost(0)
+{
+	memset(m_key_fingers, 0, sizeof(m_key_fingers));
+}
+
+bool StreamDecoder::PeekHand(const uint8_t* buffer, size_t length, GLOVE_HAND* hand)
+{
+	if (length < 2 || buffer[0] != STREAM_MAGIC || (buffer[1] >> 4) != STREAM_VERSION)
+		return false;
+
+	*hand = (buffer[1] & STREAM_FLAGS_RIGHT) ? GLOVE_RIGHT : GLOVE_LEFT;
+	return true;
+}
+
+bool StreamDecoder::Decode(const uint8_t* buffer, size_t length, GLOVE_SAMPLE* sample)
+{
+	const size_t fixed = 14 + 1 + 6 + 2 * GLOVE_AXES;
+	if (length < fixed + 1 || !PeekHand(buffer, length, &sample->hand))
+		return false;
+
+	const uint8_t* p = buffer + 1;
+	uint8_t flags = *p++ & 0xF;
+	unsigned int packet = ReadU32(p); p += 4;
+	uint64_t timestamp = ReadU64(p); p += 8;
+	uint8_t key_id = *p++;
+
+	// Gaps in the packet numbers are packets that were dropped on the way
+	if (m_last_packet != 0 && packet > m_last_packet + 1)
+		m_lost += packet - m_last_packet - 1;
+
+	// Ignore packets that arrived out of order
+	if (m_last_packet != 0 && packet <= m_last_packet && packet + STREAM_KEYFRAME_INTERVAL > m_last_packet)
+		return false;
+	m_last_packet = packet;
+
+	const uint8_t* quat = p; p += 6;
+	const uint8_t* accel = p; p += 2 * GLOVE_AXES;
+
+	uint8_t fingers[GLOVE_FINGERS];
+	if (flags & STREAM_FLAGS_KEYFRAME)
+	{
+		if (length < fixed + GLOVE_FINGERS)
+			return false;
+
+		memcpy(fingers, p, GLOVE_FINGERS);
+		memcpy(m_key_fingers, fingers, GLOVE_FINGERS);
+		m_key_packet = packet;
+		m_has_key = true;
+	}
+	else
+	{
+		// The deltas are useless without the keyframe they were made against
+		if (!m_has_key || (uint8_t)m_key_packet != key_id)
+			return false;
+
+		uint8_t mask = *p++;
+		for (int i = 0; i < GLOVE_FINGERS; i++)
+		{
+			fingers[i] = m_key_fingers[i];
+			if (mask & (1 << i))
+			{
+				if (p >= buffer + length)
+					return false;
+				fingers[i] = (uint8_t)(m_key_fingers[i] + (int8_t)*p++);
+			}
+		}
+	}
+
+	GLOVE_DATA* data = &sample->data;
+	data->PacketNumber = packet;
+	sample->timestamp = timestamp;
+	sample->position = { 0.0f, 0.0f, 0.0f };
+
+	DecodeQuaternion(quat, &data->Quaternion);
+	ManusMath::GetEuler(&data->Euler, &data->Quaternion);
+
+	float* acceleration = &data->Acceleration.x;
+	for (int i = 0; i < GLOVE_AXES; i++)
+		acceleration[i] = (int16_t)(accel[i * 2] | (accel[i * 2 + 1] << 8)) / ACCEL_SCALE;
+
+	for (int i = 0; i < GLOVE_FINGERS; i++)
+		data->Fingers[i] = fingers[i] / FINGER_SCALE;
+
+	return true;
+}
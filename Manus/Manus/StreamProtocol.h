@@ -0,0 +1,98 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Glove.h"
+
+#define STREAM_MAGIC            0x4D
+#define STREAM_VERSION          1
+
+#define STREAM_FLAGS_RIGHT      0x1
+#define STREAM_FLAGS_KEYFRAME   0x2
+
+// Send the fingers in full every so often so a lost keyframe doesn't stall a client.
+#define STREAM_KEYFRAME_INTERVAL 16
+
+// Header + key id + quaternion + acceleration + finger mask + five fingers.
+#define STREAM_MAX_PACKET       (14 + 1 + 6 + 6 + 1 + GLOVE_FINGERS)
+
+/*
+ * Wire format of a single sample, all fields are little-endian:
+ *
+ *   uint8   magic
+ *   uint8   version (high nibble) | flags (low nibble)
+ *   uint32  packet number
+ *   uint64  timestamp in microseconds on the server clock
+ *   uint8   low byte of the packet number of the last keyframe
+ *   48 bits quaternion, smallest-three encoded
+ *   int16   acceleration[3] in the same units as the glove report
+ *
+ * Followed on a keyframe by the five finger values as uint8 and otherwise by
+ * a bit mask of the fingers that changed since the keyframe and one int8
+ * delta for each bit that is set.
+ */
+
+class StreamEncoder
+{
+private:
+	unsigned int m_count;
+	unsigned int m_key_packet;
+	uint8_t m_key_fingers[GLOVE_FINGERS];
+
+public:
+	StreamEncoder();
+
+	/*! \brief Encode a sample into a packet.
+	*
+	*  \param buffer Output buffer of at least STREAM_MAX_PACKET bytes.
+	*  \return The size of the packet in bytes.
+	*/
+	size_t Encode(const GLOVE_SAMPLE& sample, uint8_t* buffer);
+};
+
+class StreamDecoder
+{
+private:
+	bool m_has_key;
+	unsigned int m_key_packet;
+	uint8_t m_key_fingers[GLOVE_FINGERS];
+	unsigned int m_last_packet;
+	unsigned int m_lost;
+
+public:
+	StreamDecoder();
+
+	/*! \brief Decode a packet received from a StreamEncoder.
+	*
+	*  Only the hand, data and timestamp fields of the sample are filled in.
+	*
+	*  \return False if the packet is malformed or references a keyframe that was lost.
+	*/
+	bool Decode(const uint8_t* buffer, size_t length, GLOVE_SAMPLE* sample);
+
+	/*! Number of packets that never arrived according to the packet numbers. */
+	unsigned int GetLost() const { return m_lost; }
+
+	/*! \brief Read the hand of a packet without decoding it.
+	*
+	*  \return False if the buffer doesn't contain a packet.
+	*/
+	static bool PeekHand(const uint8_t* buffer, size_t length, GLOVE_HAND* hand);
+};
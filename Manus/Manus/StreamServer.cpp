@@ -0,0 +1,99 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "StreamServer.h"
+
+// Keep multicast traffic on the local network
+#define MULTICAST_TTL 1
+
+StreamServer::StreamServer()
+	: m_socket(INVALID_SOCKET)
+{
+	memset(&m_destination, 0, sizeof(m_destination));
+}
+
+StreamServer::~StreamServer()
+{
+	Stop();
+}
+
+bool StreamServer::Start(const char* address, unsigned short port)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_socket != INVALID_SOCKET)
+		return false;
+
+	memset(&m_destination, 0, sizeof(m_destination));
+	m_destination.sin_family = AF_INET;
+	m_destination.sin_port = htons(port);
+	if (inet_pton(AF_INET, address, &m_destination.sin_addr) != 1)
+		return false;
+
+	WSADATA wsa_data;
+	if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+		return false;
+
+	m_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (m_socket == INVALID_SOCKET)
+	{
+		WSACleanup();
+		return false;
+	}
+
+	if (IN_MULTICAST(ntohl(m_destination.sin_addr.s_addr)))
+	{
+		// Also deliver the packets to clients on this machine
+		DWORD ttl = MULTICAST_TTL, loop = TRUE;
+		setsockopt(m_socket, IPPROTO_IP, IP_MULTICAST_TTL, (const char*)&ttl, sizeof(ttl));
+		setsockopt(m_socket, IPPROTO_IP, IP_MULTICAST_LOOP, (const char*)&loop, sizeof(loop));
+	}
+
+	// Start every client off with a keyframe
+	m_encoders[GLOVE_LEFT] = StreamEncoder();
+	m_encoders[GLOVE_RIGHT] = StreamEncoder();
+
+	return true;
+}
+
+void StreamServer::Stop()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_socket == INVALID_SOCKET)
+		return;
+
+	closesocket(m_socket);
+	m_socket = INVALID_SOCKET;
+	WSACleanup();
+}
+
+void StreamServer::Publish(const GLOVE_SAMPLE& sample)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_socket == INVALID_SOCKET)
+		return;
+
+	// Send straight from the notification thread, queueing would only add latency
+	uint8_t packet[STREAM_MAX_PACKET];
+	size_t length = m_encoders[sample.hand].Encode(sample, packet);
+	sendto(m_socket, (const char*)packet, (int)length, 0, (const sockaddr*)&m_destination, sizeof(m_destination));
+}
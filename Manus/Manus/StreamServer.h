@@ -0,0 +1,51 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "StreamProtocol.h"
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mutex>
+
+class StreamServer
+{
+private:
+	SOCKET m_socket;
+	sockaddr_in m_destination;
+	StreamEncoder m_encoders[2];
+
+	std::mutex m_mutex;
+
+public:
+	StreamServer();
+	~StreamServer();
+
+	/*! \brief Start sending samples to the given address.
+	*
+	*  The address can be a unicast, loopback or multicast IPv4 address.
+	*/
+	bool Start(const char* address, unsigned short port);
+	void Stop();
+	bool IsRunning() const { return m_socket != INVALID_SOCKET; }
+
+	/*! Send a sample to the clients, called for every sample of every glove. */
+	void Publish(const GLOVE_SAMPLE& sample);
+};
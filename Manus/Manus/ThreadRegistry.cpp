@@ -0,0 +1,234 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "ThreadRegistry.h"
+
+#include <string.h>
+
+// Win32 priorities indexed by GLOVE_THREAD_PRIORITY
+static const int g_priorities[] = {
+	THREAD_PRIORITY_NORMAL,
+	THREAD_PRIORITY_IDLE,
+	THREAD_PRIORITY_LOWEST,
+	THREAD_PRIORITY_BELOW_NORMAL,
+	THREAD_PRIORITY_NORMAL,
+	THREAD_PRIORITY_ABOVE_NORMAL,
+	THREAD_PRIORITY_HIGHEST,
+	THREAD_PRIORITY_TIME_CRITICAL,
+};
+
+// Names indexed by GLOVE_THREAD_ROLE, the Bluetooth threads keep the name Windows gave them
+static const char* g_names[GLOVE_THREAD_ROLES] = {
+	"Manus Devices",
+	"",
+	"Manus Decode",
+	"Manus Filter",
+	"Manus Skeleton",
+	"Manus Publish",
+	"Manus Recorder",
+	"Manus Stream",
+	"Manus Broker",
+	"Manus Loader",
+	"Manus Commands",
+};
+
+// Only available since Windows 10 version 1607, so it is looked up at runtime
+typedef HRESULT(WINAPI* SET_THREAD_DESCRIPTION)(HANDLE thread, const wchar_t* description);
+
+static uint64_t GetProcessAffinity()
+{
+	DWORD_PTR process, system;
+	if (!GetProcessAffinityMask(GetCurrentProcess(), &process, &system))
+		return 0;
+	return process;
+}
+
+ThreadRegistry::ThreadRegistry()
+{
+	for (int i = 0; i < GLOVE_THREAD_ROLES; i++)
+		GetDefault((GLOVE_THREAD_ROLE)i, &m_config[i]);
+}
+
+ThreadRegistry& ThreadRegistry::Instance()
+{
+	static ThreadRegistry* registry = new ThreadRegistry();
+	return *registry;
+}
+
+void ThreadRegistry::GetDefault(GLOVE_THREAD_ROLE role, GLOVE_THREAD_CONFIG* config)
+{
+	memset(config, 0, sizeof(GLOVE_THREAD_CONFIG));
+	config->Affinity = 0;
+	config->Priority = GLOVE_PRIORITY_DEFAULT;
+}
+
+bool ThreadRegistry::IsValid(GLOVE_THREAD_ROLE role, const GLOVE_THREAD_CONFIG& config)
+{
+	// Threads of Windows can only keep the default
+	if (!IsOwned(role))
+		return config.Affinity == 0 && config.Priority == GLOVE_PRIORITY_DEFAULT && config.Name[0] == '\0';
+
+	if (config.Priority < GLOVE_PRIORITY_DEFAULT || config.Priority > GLOVE_PRIORITY_TIME_CRITICAL)
+		return false;
+
+	if (!memchr(config.Name, '\0', GLOVE_THREAD_NAME))
+		return false;
+
+	// The threads can't leave the processors of the process
+	return (config.Affinity & ~GetProcessAffinity()) == 0;
+}
+
+void ThreadRegistry::GetConfig(GLOVE_THREAD_ROLE role, GLOVE_THREAD_CONFIG* config)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	*config = m_config[role];
+}
+
+void ThreadRegistry::Configure(GLOVE_THREAD_ROLE role, const GLOVE_THREAD_CONFIG& config)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_config[role] = config;
+	for (ENTRY& entry : m_threads)
+	{
+		if (entry.role == role && IsOwned(role))
+			Apply(entry, config);
+	}
+}
+
+void ThreadRegistry::Enter(GLOVE_THREAD_ROLE role)
+{
+	ENTRY entry;
+	entry.role = role;
+	entry.id = GetCurrentThreadId();
+	entry.affinity = GetProcessAffinity();
+	entry.pinned = false;
+	entry.prioritized = false;
+
+	// The pseudo handle of GetCurrentThread only works on the thread itself
+	if (!DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &entry.handle,
+		0, FALSE, DUPLICATE_SAME_ACCESS))
+		return;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (IsOwned(role))
+		Apply(entry, m_config[role]);
+	m_threads.push_back(entry);
+}
+
+void ThreadRegistry::Leave()
+{
+	DWORD id = GetCurrentThreadId();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (auto it = m_threads.begin(); it != m_threads.end(); ++it)
+	{
+		if (it->id == id)
+		{
+			CloseHandle(it->handle);
+			m_threads.erase(it);
+			return;
+		}
+	}
+}
+
+unsigned int ThreadRegistry::GetThreads(GLOVE_THREAD_INFO* threads, unsigned int count)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (unsigned int i = 0; i < count && i < m_threads.size(); i++)
+	{
+		const ENTRY& entry = m_threads[i];
+		GLOVE_THREAD_INFO& info = threads[i];
+
+		info.Role = entry.role;
+		info.Id = entry.id;
+		info.Affinity = entry.affinity;
+
+		// Priorities that can only be set outside the SDK are reported as the default
+		int priority = GetThreadPriority(entry.handle);
+		info.Priority = GLOVE_PRIORITY_DEFAULT;
+		for (int j = GLOVE_PRIORITY_IDLE; j <= GLOVE_PRIORITY_TIME_CRITICAL; j++)
+		{
+			if (g_priorities[j] == priority)
+				info.Priority = (GLOVE_THREAD_PRIORITY)j;
+		}
+
+		// Thread times are in units of 100 nanoseconds
+		FILETIME creation, exit, kernel, user;
+		info.CpuTime = 0;
+		if (GetThreadTimes(entry.handle, &creation, &exit, &kernel, &user))
+		{
+			ULARGE_INTEGER k, u;
+			k.LowPart = kernel.dwLowDateTime;
+			k.HighPart = kernel.dwHighDateTime;
+			u.LowPart = user.dwLowDateTime;
+			u.HighPart = user.dwHighDateTime;
+			info.CpuTime = (k.QuadPart + u.QuadPart) / 10;
+		}
+
+		const GLOVE_THREAD_CONFIG& config = m_config[entry.role];
+		strncpy_s(info.Name, config.Name[0] ? config.Name : g_names[entry.role], _TRUNCATE);
+	}
+
+	return (unsigned int)m_threads.size();
+}
+
+void ThreadRegistry::Apply(ENTRY& entry, const GLOVE_THREAD_CONFIG& config)
+{
+	// Only restore what an earlier configuration changed
+	if (config.Affinity != 0)
+	{
+		if (SetThreadAffinityMask(entry.handle, (DWORD_PTR)config.Affinity))
+		{
+			entry.affinity = config.Affinity;
+			entry.pinned = true;
+		}
+	}
+	else if (entry.pinned)
+	{
+		uint64_t process = GetProcessAffinity();
+		if (SetThreadAffinityMask(entry.handle, (DWORD_PTR)process))
+		{
+			entry.affinity = process;
+			entry.pinned = false;
+		}
+	}
+
+	if (config.Priority != GLOVE_PRIORITY_DEFAULT || entry.prioritized)
+	{
+		SetThreadPriority(entry.handle, g_priorities[config.Priority]);
+		entry.prioritized = config.Priority != GLOVE_PRIORITY_DEFAULT;
+	}
+
+	const char* name = config.Name[0] ? config.Name : g_names[entry.role];
+	if (name[0])
+	{
+		static const SET_THREAD_DESCRIPTION set_description = (SET_THREAD_DESCRIPTION)GetProcAddress(
+			GetModuleHandle(L"kernel32.dll"), "SetThreadDescription");
+
+		wchar_t description[GLOVE_THREAD_NAME];
+		if (set_description && MultiByteToWideChar(CP_UTF8, 0, name, -1, description, GLOVE_THREAD_NAME) > 0)
+			set_description(entry.handle, description);
+	}
+}
@@ -0,0 +1,96 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Manus.h"
+
+#include <mutex>
+#include <vector>
+
+/*
+ * Keeps track of the threads the SDK runs its work on.
+ *
+ * Every thread registers itself with its role when it starts, which
+ * applies the configuration of that role, and unregisters when it ends.
+ * Changing the configuration of a role applies it to the registered
+ * threads right away, so it doesn't matter whether the threads already
+ * run. Threads are named with SetThreadDescription where the system has
+ * it, which debuggers and profilers such as ETW pick up.
+ *
+ * The Bluetooth callbacks run on pool threads of Windows. They are only
+ * registered so they are reported, their affinity, priority and name are
+ * never changed since Windows runs other work on them as well.
+ */
+class ThreadRegistry
+{
+private:
+	struct ENTRY
+	{
+		GLOVE_THREAD_ROLE role;
+		DWORD id;
+		HANDLE handle;
+		uint64_t affinity;
+		bool pinned;
+		bool prioritized;
+	};
+
+	GLOVE_THREAD_CONFIG m_config[GLOVE_THREAD_ROLES];
+	std::vector<ENTRY> m_threads;
+	std::mutex m_mutex;
+
+	ThreadRegistry();
+
+public:
+	/*! The registry is never destroyed, so threads that end during process exit can still leave. */
+	static ThreadRegistry& Instance();
+
+	static void GetDefault(GLOVE_THREAD_ROLE role, GLOVE_THREAD_CONFIG* config);
+	static bool IsValid(GLOVE_THREAD_ROLE role, const GLOVE_THREAD_CONFIG& config);
+
+	/*! Whether the threads of a role are created by the SDK and can be configured. */
+	static bool IsOwned(GLOVE_THREAD_ROLE role) { return role != GLOVE_THREAD_BLUETOOTH; }
+
+	void GetConfig(GLOVE_THREAD_ROLE role, GLOVE_THREAD_CONFIG* config);
+	void Configure(GLOVE_THREAD_ROLE role, const GLOVE_THREAD_CONFIG& config);
+
+	/*! Register the calling thread and apply the configuration of its role. */
+	void Enter(GLOVE_THREAD_ROLE role);
+
+	/*! Unregister the calling thread. */
+	void Leave();
+
+	/*! \return The number of registered threads, which may exceed count. */
+	unsigned int GetThreads(GLOVE_THREAD_INFO* threads, unsigned int count);
+
+private:
+	void Apply(ENTRY& entry, const GLOVE_THREAD_CONFIG& config);
+};
+
+/*! Registers the calling thread for as long as it is in scope. */
+class ThreadScope
+{
+public:
+	ThreadScope(GLOVE_THREAD_ROLE role) { ThreadRegistry::Instance().Enter(role); }
+	~ThreadScope() { ThreadRegistry::Instance().Leave(); }
+
+	ThreadScope(const ThreadScope&) = delete;
+	ThreadScope& operator=(const ThreadScope&) = delete;
+};
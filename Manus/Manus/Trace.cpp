@@ -0,0 +1,219 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "Trace.h"
+#include "ThreadRegistry.h"
+
+#include <stdio.h>
+
+#include <string>
+
+std::atomic<bool> Tracer::s_enabled(false);
+
+namespace
+{
+	// Gives the ring back when the thread ends
+	struct TRACE_OWNER
+	{
+		TraceBuffer* buffer = nullptr;
+		~TRACE_OWNER() { if (buffer) Tracer::Instance().Release(buffer); }
+	};
+
+	// A plain pointer keeps the lookup on the hot path free of guards
+	thread_local TraceBuffer* t_buffer = nullptr;
+	thread_local TRACE_OWNER t_owner;
+
+	// Thread and event names come from the application, quote them as JSON strings
+	std::string EscapeJson(const char* text)
+	{
+		std::string escaped;
+		for (const char* c = text; *c; c++)
+		{
+			if (*c == '"' || *c == '\\')
+			{
+				escaped += '\\';
+				escaped += *c;
+			}
+			else if ((unsigned char)*c < 0x20)
+			{
+				char code[7];
+				snprintf(code, sizeof(code), "\\u%04x", (unsigned char)*c);
+				escaped += code;
+			}
+			else
+				escaped += *c;
+		}
+		return escaped;
+	}
+}
+
+void TraceBuffer::Snapshot(std::vector<TRACE_EVENT>& events) const
+{
+	uint64_t head = m_head.load(std::memory_order_acquire);
+	uint64_t first = head > TRACE_EVENTS ? head - TRACE_EVENTS : 0;
+
+	size_t offset = events.size();
+	for (uint64_t i = first; i < head; i++)
+		events.push_back(m_events[i & (TRACE_EVENTS - 1)]);
+
+	// The writer may have wrapped around while copying, the slot it writes next is also suspect
+	std::atomic_thread_fence(std::memory_order_acquire);
+	uint64_t after = m_head.load(std::memory_order_relaxed);
+	uint64_t valid = after >= TRACE_EVENTS ? after - TRACE_EVENTS + 1 : 0;
+	if (valid > first)
+	{
+		size_t stale = (size_t)(valid - first < head - first ? valid - first : head - first);
+		events.erase(events.begin() + offset, events.begin() + offset + stale);
+	}
+}
+
+Tracer::Tracer()
+	: m_cleared(0)
+{
+}
+
+Tracer& Tracer::Instance()
+{
+	static Tracer* instance = new Tracer();
+	return *instance;
+}
+
+TraceBuffer* Tracer::Acquire()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	TraceBuffer* buffer = nullptr;
+	for (TraceBuffer* candidate : m_buffers)
+	{
+		if (!candidate->m_owned)
+		{
+			buffer = candidate;
+			break;
+		}
+	}
+
+	if (!buffer)
+	{
+		buffer = new TraceBuffer();
+		m_buffers.push_back(buffer);
+	}
+
+	// Snapshots happen under the lock, so the events of the previous owner can be dropped safely
+	buffer->m_head.store(0, std::memory_order_relaxed);
+	buffer->m_thread = GetCurrentThreadId();
+	buffer->m_owned = true;
+
+	return buffer;
+}
+
+void Tracer::Release(TraceBuffer* buffer)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	buffer->m_owned = false;
+}
+
+void Tracer::Record(const char* name, int64_t start, int64_t end, uint64_t arg)
+{
+	TraceBuffer* buffer = t_buffer;
+	if (!buffer)
+	{
+		buffer = Instance().Acquire();
+		t_buffer = buffer;
+		t_owner.buffer = buffer;
+	}
+
+	buffer->Record(name, start, end, arg);
+}
+
+void Tracer::Clear()
+{
+	m_cleared.store(Now(), std::memory_order_relaxed);
+}
+
+bool Tracer::Write(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+
+	// Name the threads after their role where the SDK knows it
+	std::vector<GLOVE_THREAD_INFO> threads(64);
+	unsigned int count = ThreadRegistry::Instance().GetThreads(threads.data(), (unsigned int)threads.size());
+	threads.resize(count < threads.size() ? count : threads.size());
+
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	double us_per_tick = 1e6 / (double)freq.QuadPart;
+
+	DWORD pid = GetCurrentProcessId();
+	int64_t cleared = m_cleared.load(std::memory_order_relaxed);
+
+	fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%lu,\"tid\":0,\"args\":{\"name\":\"Manus SDK\"}}",
+		(unsigned long)pid);
+
+	std::vector<TRACE_EVENT> events;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (TraceBuffer* buffer : m_buffers)
+	{
+		events.clear();
+		buffer->Snapshot(events);
+		if (events.empty())
+			continue;
+
+		unsigned long tid = (unsigned long)buffer->m_thread;
+		for (const GLOVE_THREAD_INFO& info : threads)
+		{
+			if (info.Id == buffer->m_thread)
+			{
+				fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%lu,\"tid\":%lu,\"args\":{\"name\":\"%s\"}}",
+					(unsigned long)pid, tid, EscapeJson(info.Name).c_str());
+				break;
+			}
+		}
+
+		// Timestamps stay on the performance counter, the same clock as the timestamps of the samples
+		for (const TRACE_EVENT& event : events)
+		{
+			if (event.start < cleared)
+				continue;
+
+			std::string name = EscapeJson(event.name);
+
+			if (event.end == event.start)
+			{
+				fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%lu,\"tid\":%lu,\"args\":{\"arg\":%llu}}",
+					name.c_str(), event.start * us_per_tick, (unsigned long)pid, tid, (unsigned long long)event.arg);
+			}
+			else
+			{
+				fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%lu,\"tid\":%lu,\"args\":{\"arg\":%llu}}",
+					name.c_str(), event.start * us_per_tick, (event.end - event.start) * us_per_tick,
+					(unsigned long)pid, tid, (unsigned long long)event.arg);
+			}
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+
+	return fclose(file) == 0;
+}
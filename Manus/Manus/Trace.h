@@ -0,0 +1,166 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Manus.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// Set to 0 to compile every trace point out of the SDK
+#ifndef MANUS_TRACING
+#define MANUS_TRACING 1
+#endif
+
+// Events kept per thread, a power of two
+#define TRACE_EVENTS 8192
+
+typedef struct
+{
+	// Must be a string literal, only the pointer is stored
+	const char* name;
+	// Performance counter ticks, an instant event has the same start and end
+	int64_t start;
+	int64_t end;
+	uint64_t arg;
+} TRACE_EVENT;
+
+/*
+ * Ring of the trace events of one thread.
+ *
+ * Only the owning thread writes, so recording an event is a plain store
+ * followed by publishing the new head. A reader copies the events and
+ * then discards those the writer may have overwritten meanwhile.
+ */
+class TraceBuffer
+{
+private:
+	friend class Tracer;
+
+	TRACE_EVENT m_events[TRACE_EVENTS];
+	std::atomic<uint64_t> m_head;
+	DWORD m_thread;
+	bool m_owned;
+
+public:
+	TraceBuffer() : m_head(0), m_thread(0), m_owned(false) {}
+
+	void Record(const char* name, int64_t start, int64_t end, uint64_t arg)
+	{
+		uint64_t head = m_head.load(std::memory_order_relaxed);
+
+		TRACE_EVENT& event = m_events[head & (TRACE_EVENTS - 1)];
+		event.name = name;
+		event.start = start;
+		event.end = end;
+		event.arg = arg;
+
+		m_head.store(head + 1, std::memory_order_release);
+	}
+
+	/*! Copy the events that weren't overwritten yet, oldest first. */
+	void Snapshot(std::vector<TRACE_EVENT>& events) const;
+};
+
+/*
+ * Collects trace events from every thread of the SDK.
+ *
+ * Each thread writes into its own ring, which it gets the first time it
+ * records an event while tracing is enabled. Rings of threads that have
+ * ended are reused by new threads. While tracing is disabled a trace
+ * point costs a single relaxed load.
+ */
+class Tracer
+{
+private:
+	static std::atomic<bool> s_enabled;
+
+	std::vector<TraceBuffer*> m_buffers;
+	std::atomic<int64_t> m_cleared;
+	std::mutex m_mutex;
+
+	Tracer();
+
+	TraceBuffer* Acquire();
+
+public:
+	/*! The tracer is never destroyed, threads may record events during process exit. */
+	static Tracer& Instance();
+
+	static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+	static void SetEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+
+	static int64_t Now()
+	{
+		LARGE_INTEGER now;
+		QueryPerformanceCounter(&now);
+		return now.QuadPart;
+	}
+
+	/*! Record an event on the ring of the calling thread. */
+	static void Record(const char* name, int64_t start, int64_t end, uint64_t arg);
+
+	/*! Hide the events recorded so far from the next trace that is written. */
+	void Clear();
+
+	/*! Write the recorded events in the Chrome trace event format, which Perfetto also reads. */
+	bool Write(const char* path);
+
+	/*! Called when a thread ends, its ring can then be reused. */
+	void Release(TraceBuffer* buffer);
+};
+
+/*! Records the time spent in a scope as a single event. */
+class TraceScope
+{
+private:
+	const char* m_name;
+	int64_t m_start;
+	uint64_t m_arg;
+
+public:
+	TraceScope(const char* name, uint64_t arg = 0)
+		: m_name(name), m_start(Tracer::IsEnabled() ? Tracer::Now() : 0), m_arg(arg) {}
+
+	~TraceScope()
+	{
+		// Scopes that began while tracing was disabled are left out
+		if (m_start != 0 && Tracer::IsEnabled())
+			Tracer::Record(m_name, m_start, Tracer::Now(), m_arg);
+	}
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+};
+
+#if MANUS_TRACING
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_SCOPE_ARG(name, arg) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name, arg)
+#define TRACE_INSTANT(name, arg) \
+	do { if (Tracer::IsEnabled()) { int64_t trace_now = Tracer::Now(); Tracer::Record(name, trace_now, trace_now, arg); } } while (0)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_SCOPE_ARG(name, arg) ((void)0)
+#define TRACE_INSTANT(name, arg) ((void)0)
+#endif
@@ -0,0 +1,220 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "TrackerFusion.h"
+#include "ManusMath.h"
+#include "SkeletalModel.h"
+
+#include <math.h>
+
+static GLOVE_QUATERNION Conjugate(const GLOVE_QUATERNION& q)
+{
+	GLOVE_QUATERNION result = { q.w, -q.x, -q.y, -q.z };
+	return result;
+}
+
+static GLOVE_VECTOR Rotate(const GLOVE_QUATERNION& q, const GLOVE_VECTOR& v)
+{
+	// v + 2w(u x v) + 2u x (u x v), with u the vector part of q
+	float tx = 2.0f * (q.y * v.z - q.z * v.y);
+	float ty = 2.0f * (q.z * v.x - q.x * v.z);
+	float tz = 2.0f * (q.x * v.y - q.y * v.x);
+
+	GLOVE_VECTOR result;
+	result.x = v.x + q.w * tx + q.y * tz - q.z * ty;
+	result.y = v.y + q.w * ty + q.z * tx - q.x * tz;
+	result.z = v.z + q.w * tz + q.x * ty - q.y * tx;
+	return result;
+}
+
+static GLOVE_QUATERNION Normalize(const GLOVE_QUATERNION& q)
+{
+	float norm = sqrtf(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+	GLOVE_QUATERNION result = { q.w / norm, q.x / norm, q.y / norm, q.z / norm };
+	return result;
+}
+
+TrackerFusion::TrackerFusion()
+{
+	GetDefault(&m_config);
+	Configure(m_config);
+}
+
+void TrackerFusion::GetDefault(GLOVE_TRACKER* tracker)
+{
+	tracker->Mount.orientation = { 1.0f, 0.0f, 0.0f, 0.0f };
+	tracker->Mount.position = { 0.0f, 0.0f, 0.0f };
+	tracker->Scale = 0.001f;
+	tracker->TimeOffset = 0;
+	tracker->OrientationGain = 1.0f;
+	tracker->Timeout = 100000;
+}
+
+bool TrackerFusion::IsValid(const GLOVE_TRACKER& tracker)
+{
+	const GLOVE_QUATERNION& q = tracker.Mount.orientation;
+	float norm = q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z;
+
+	return fabsf(norm - 1.0f) < 0.01f && tracker.Scale > 0.0f &&
+		tracker.OrientationGain > 0.0f && tracker.OrientationGain <= 1.0f && tracker.Timeout > 0;
+}
+
+void TrackerFusion::GetConfig(GLOVE_TRACKER* tracker)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	*tracker = m_config;
+}
+
+void TrackerFusion::Configure(const GLOVE_TRACKER& tracker)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_config = tracker;
+	m_config.Mount.orientation = Normalize(tracker.Mount.orientation);
+
+	m_count = 0;
+	m_newest = 0;
+	m_rotation = { 1.0f, 0.0f, 0.0f, 0.0f };
+	m_position = { 0.0f, 0.0f, 0.0f };
+	m_aligned = false;
+	m_valid = false;
+}
+
+bool TrackerFusion::Push(uint64_t time, const GLOVE_POSE& pose)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_count > 0 && time <= m_history[m_newest].time)
+		return false;
+
+	m_newest = (m_newest + 1) % TRACKER_HISTORY;
+	m_history[m_newest].time = time;
+	m_history[m_newest].pose = pose;
+	m_history[m_newest].pose.orientation = Normalize(pose.orientation);
+	if (m_count < TRACKER_HISTORY)
+		m_count++;
+
+	return true;
+}
+
+bool TrackerFusion::Interpolate(uint64_t time, GLOVE_POSE* pose) const
+{
+	if (m_count == 0)
+		return false;
+
+	uint64_t timeout = m_config.Timeout;
+
+	// Hold the newest pose for a sample after it
+	const TRACKER_POSE& newest = m_history[m_newest];
+	if (time >= newest.time)
+	{
+		*pose = newest.pose;
+		return time - newest.time <= timeout;
+	}
+
+	// Walk back to the poses around the sample, the newest ones are the most likely
+	unsigned int later = m_newest;
+	for (unsigned int i = 1; i < m_count; i++)
+	{
+		unsigned int earlier = (m_newest + TRACKER_HISTORY - i) % TRACKER_HISTORY;
+		const TRACKER_POSE& a = m_history[earlier];
+		const TRACKER_POSE& b = m_history[later];
+
+		if (a.time <= time)
+		{
+			float t = (float)(time - a.time) / (float)(b.time - a.time);
+			pose->orientation = ManusMath::QuaternionSlerp(a.pose.orientation, b.pose.orientation, t);
+			pose->position.x = a.pose.position.x + t * (b.pose.position.x - a.pose.position.x);
+			pose->position.y = a.pose.position.y + t * (b.pose.position.y - a.pose.position.y);
+			pose->position.z = a.pose.position.z + t * (b.pose.position.z - a.pose.position.z);
+
+			// A gap in the tracker is as bad as a lost tracker
+			return b.time - a.time <= 2 * timeout;
+		}
+
+		later = earlier;
+	}
+
+	// Hold the oldest pose for a sample before it
+	const TRACKER_POSE& oldest = m_history[later];
+	*pose = oldest.pose;
+	return oldest.time - time <= timeout;
+}
+
+void TrackerFusion::Process(const GLOVE_SAMPLE& sample)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_count == 0)
+		return;
+
+	int64_t time = (int64_t)sample.timestamp + m_config.TimeOffset;
+
+	GLOVE_POSE tracker;
+	m_valid = time >= 0 && Interpolate((uint64_t)time, &tracker);
+	if (!m_valid)
+		return;
+
+	// Pose of the palm in the world
+	GLOVE_QUATERNION palm = ManusMath::QuaternionMultiply(tracker.orientation, m_config.Mount.orientation);
+	GLOVE_VECTOR offset = Rotate(tracker.orientation, m_config.Mount.position);
+	m_position.x = tracker.position.x + offset.x;
+	m_position.y = tracker.position.y + offset.y;
+	m_position.z = tracker.position.z + offset.z;
+
+	// Rotation that takes the palm of the model to the palm in the world
+	GLOVE_QUATERNION model = SkeletalModel::GetPalmOrientation(sample.data.Quaternion);
+	GLOVE_QUATERNION rotation = Normalize(ManusMath::QuaternionMultiply(palm, Conjugate(model)));
+
+	if (m_aligned)
+		m_rotation = Normalize(ManusMath::QuaternionSlerp(m_rotation, rotation, m_config.OrientationGain));
+	else
+		m_rotation = rotation;
+	m_aligned = true;
+}
+
+bool TrackerFusion::Transform(GLOVE_SKELETAL* model)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (!m_valid)
+		return false;
+
+	// The palm is the origin of the model, any translation of the palm is replaced by the tracker
+	GLOVE_VECTOR origin = model->palm.position;
+
+	GLOVE_POSE* poses = (GLOVE_POSE*)model;
+	for (int i = 0; i < GLOVE_BONES; i++)
+	{
+		GLOVE_VECTOR relative;
+		relative.x = m_config.Scale * (poses[i].position.x - origin.x);
+		relative.y = m_config.Scale * (poses[i].position.y - origin.y);
+		relative.z = m_config.Scale * (poses[i].position.z - origin.z);
+
+		GLOVE_VECTOR offset = Rotate(m_rotation, relative);
+		poses[i].position.x = m_position.x + offset.x;
+		poses[i].position.y = m_position.y + offset.y;
+		poses[i].position.z = m_position.z + offset.z;
+		poses[i].orientation = ManusMath::QuaternionMultiply(m_rotation, poses[i].orientation);
+	}
+
+	return true;
+}
@@ -0,0 +1,90 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Glove.h"
+
+#include <mutex>
+
+// Tracker poses kept for matching with glove samples, about a quarter second at 240 Hz
+#define TRACKER_HISTORY 64
+
+/*! A pose of the tracker on the SDK clock. */
+typedef struct
+{
+	uint64_t time;
+	GLOVE_POSE pose;
+} TRACKER_POSE;
+
+/*
+ * Places the skeletal model of a glove in the world of an external tracker.
+ *
+ * The pushed tracker poses are kept in a short history, and every glove
+ * sample is matched with the tracker pose at its time by interpolating
+ * between the poses around it. The tracker gives the pose of the palm in
+ * the world, which is compared with the orientation of the glove to find
+ * the rotation from the glove to the world. That rotation is smoothed
+ * across samples, so the glove carries the orientation between tracker
+ * poses and the tracker slowly removes the drift of the glove.
+ */
+class TrackerFusion
+{
+private:
+	GLOVE_TRACKER m_config;
+
+	TRACKER_POSE m_history[TRACKER_HISTORY];
+	unsigned int m_count;
+	unsigned int m_newest;
+
+	// Rotation from the model of the glove to the world, and the world position of the palm
+	GLOVE_QUATERNION m_rotation;
+	GLOVE_VECTOR m_position;
+	bool m_aligned;
+	bool m_valid;
+
+	std::mutex m_mutex;
+
+public:
+	TrackerFusion();
+
+	static void GetDefault(GLOVE_TRACKER* tracker);
+	static bool IsValid(const GLOVE_TRACKER& tracker);
+
+	void GetConfig(GLOVE_TRACKER* tracker);
+
+	/*! Replace the configuration and forget the pushed poses. */
+	void Configure(const GLOVE_TRACKER& tracker);
+
+	/*! \return False if the pose is older than the newest pose. */
+	bool Push(uint64_t time, const GLOVE_POSE& pose);
+
+	/*! Align a glove sample with the tracker. */
+	void Process(const GLOVE_SAMPLE& sample);
+
+	/*! \brief Move a skeletal model into the world of the tracker.
+	*
+	*  \return False if the newest sample had no tracker pose close to it.
+	*/
+	bool Transform(GLOVE_SKELETAL* model);
+
+private:
+	bool Interpolate(uint64_t time, GLOVE_POSE* pose) const;
+};
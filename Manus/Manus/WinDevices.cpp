@@ -20,8 +20,11 @@
 #include "stdafx.h"
 #include "Glove.h"
 #include "WinDevices.h"
+#include "ThreadRegistry.h"
 
+#include <cfgmgr32.h>
 #include <dbt.h>
+#include <stdlib.h>
 
 WinDevices::WinDevices()
 {
@@ -39,6 +42,7 @@ WinDevices::~WinDevices()
 DWORD WINAPI WinDevices::DeviceThread(LPVOID param)
 {
 	WinDevices* devices = (WinDevices*)param;
+	ThreadScope thread_scope(GLOVE_THREAD_DEVICES);
 	devices->m_running = true;
 
 	// Register a ManusDevices class
@@ -92,3 +96,53 @@ LRESULT CALLBACK WinDevices::WinProcCallback(HWND hWnd, UINT message, WPARAM wPa
 	else
 		return DefWindowProc(hWnd, message, wParam, lParam);
 }
+
+bool WinDevices::GetTopology(const wchar_t* device_path, uint64_t* address, std::wstring* adapter)
+{
+	HDEVINFO device_info_set = SetupDiCreateDeviceInfoList(nullptr, nullptr);
+	if (device_info_set == INVALID_HANDLE_VALUE)
+		return false;
+
+	SP_DEVICE_INTERFACE_DATA device_interface_data = { 0 };
+	device_interface_data.cbSize = sizeof(SP_DEVICE_INTERFACE_DATA);
+	SP_DEVINFO_DATA device_info_data = { 0 };
+	device_info_data.cbSize = sizeof(SP_DEVINFO_DATA);
+
+	// Only the device node is needed, the detail fails for the lack of a buffer
+	bool found = SetupDiOpenDeviceInterface(device_info_set, device_path, 0, &device_interface_data) &&
+		(SetupDiGetDeviceInterfaceDetail(device_info_set, &device_interface_data, nullptr, 0, nullptr, &device_info_data) ||
+		GetLastError() == ERROR_INSUFFICIENT_BUFFER);
+
+	SetupDiDestroyDeviceInfoList(device_info_set);
+	if (!found)
+		return false;
+
+	// The service sits below BTHLE\Dev_<address>, which sits below the LE enumerator of the radio
+	bool has_address = false;
+	DEVINST node = device_info_data.DevInst;
+	DEVINST parent;
+	wchar_t id[MAX_DEVICE_ID_LEN];
+	while (CM_Get_Parent(&parent, node, 0) == CR_SUCCESS &&
+		CM_Get_Device_ID(parent, id, MAX_DEVICE_ID_LEN, 0) == CR_SUCCESS)
+	{
+		if (_wcsnicmp(id, L"BTHLE\\Dev_", 10) == 0)
+		{
+			*address = wcstoull(id + 10, nullptr, 16);
+			has_address = true;
+		}
+		else if (_wcsnicmp(id, L"BTH\\MS_BTHLE", 12) == 0)
+		{
+			DEVINST radio;
+			if (!has_address || CM_Get_Parent(&radio, parent, 0) != CR_SUCCESS ||
+				CM_Get_Device_ID(radio, id, MAX_DEVICE_ID_LEN, 0) != CR_SUCCESS)
+				return false;
+
+			*adapter = id;
+			return true;
+		}
+
+		node = parent;
+	}
+
+	return false;
+}
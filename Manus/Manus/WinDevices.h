@@ -22,6 +22,8 @@
 #include "Devices.h"
 
 #include <functional>
+#include <inttypes.h>
+#include <string>
 #include <thread>
 
 class WinDevices :
@@ -36,6 +38,17 @@ public:
 	WinDevices();
 	~WinDevices();
 
+	/*! \brief Find the glove and the adapter behind a device interface.
+	*
+	*  A glove that is paired with several adapters has a device interface
+	*  for each of them. The device tree is walked up from the interface to
+	*  the Bluetooth LE device, which names the glove, and on to the radio.
+	*
+	*  \param address Output variable to receive the Bluetooth address of the glove.
+	*  \param adapter Output variable to receive the device instance of the radio.
+	*/
+	static bool GetTopology(const wchar_t* device_path, uint64_t* address, std::wstring* adapter);
+
 private:
 	static DWORD WINAPI WinDevices::DeviceThread(LPVOID param);
 	static LRESULT CALLBACK WinProcCallback(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
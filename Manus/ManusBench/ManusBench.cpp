@@ -0,0 +1,1341 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmarks for the hot paths of the SDK.
+ *
+ * The SDK sources are compiled into this executable so the internal classes
+ * can be measured directly. Gloves are simulated and fed with synthetic
+ * reports, or with the reports from a recording made by ManusRecordStart.
+ *
+ * Usage: ManusBench [--recording file] [--out file] [--filter name] [--trace file]
+ *
+ * The results are written as JSON, all times are in nanoseconds. With
+ * --trace the trace events of the whole run are written to a file too.
+ *
+ * The codec benchmarks report the compression ratio against the raw report
+ * and the decode rate next to the targets of the recording format, and say
+ * so when they fall short.
+ *
+ * The adapter benchmarks run the scheduler against simulated Bluetooth
+ * adapters and report how far it brings the loss down next to its time.
+ *
+ * The cold start benchmarks start a fresh copy of this executable with
+ * --cold-start for every run, so each one measures ManusInitEx and the
+ * first use of the features in a process that hasn't loaded anything yet.
+ */
+
+#include "stdafx.h"
+#include "Manus.h"
+#include "Glove.h"
+#include "ManusMath.h"
+#include "SkeletalModel.h"
+#include "Recording.h"
+#include "SkeletalPalette.h"
+#include "SkeletalRig.h"
+#include "GestureEngine.h"
+#include "ImuCalibration.h"
+#include "PalmTracker.h"
+#include "TrackerFusion.h"
+#include "Trace.h"
+#include "PoseHistory.h"
+#include "AdapterScheduler.h"
+#include "StreamServer.h"
+#include "StreamClient.h"
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <psapi.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Defined in Manus.cpp
+extern std::vector<Glove*> g_gloves;
+extern std::mutex g_gloves_mutex;
+int GetGlove(GLOVE_HAND hand, Glove** elem);
+
+#define SYNTHETIC_REPORTS 4096
+#define LATENCY_SAMPLES   2000
+#define COLD_START_RUNS   5
+
+// Blocks encoded for the codec benchmark and the targets it is held against
+#define CODEC_BENCH_BLOCKS 64
+#define CODEC_TARGET_RATIO 5.0
+#define CODEC_TARGET_RATE  100e6
+
+// The stream server sends to the relay port, the relay forwards to the port after it
+#define LOOPBACK_PORT     47500
+#define LOOPBACK_SAMPLES  1000
+#define LOOPBACK_DROP     7
+#define LOOPBACK_TIMEOUT  100
+
+// Count every allocation made through operator new
+static std::atomic<uint64_t> g_allocations(0);
+
+void* operator new(size_t size)
+{
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+	void* p = malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+typedef struct
+{
+	std::string name;
+	uint64_t ops;
+	// Number of operations timed together for every entry in the percentiles
+	unsigned int batch;
+	double ns_per_op;
+	double allocs_per_op;
+	double p50, p90, p99, max;
+	// Growth of the working set in bytes, negative when not measured
+	int64_t memory;
+	// Outcomes of a simulation, written as they are named
+	std::vector<std::pair<std::string, double>> metrics;
+} BENCH_RESULT;
+
+static double g_ns_per_tick;
+static std::vector<BENCH_RESULT> g_results;
+static const char* g_filter = nullptr;
+
+// A failed check makes the benchmark exit with an error after writing the results
+static int g_exit_code = 0;
+
+static int64_t GetTicks()
+{
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	return now.QuadPart;
+}
+
+static bool Enabled(const char* name)
+{
+	return !g_filter || strstr(name, g_filter) != nullptr;
+}
+
+static double Percentile(const std::vector<double>& sorted, double p)
+{
+	if (sorted.empty())
+		return 0.0;
+	size_t index = (size_t)(p * (sorted.size() - 1) + 0.5);
+	return sorted[index];
+}
+
+/*! Summarize the per-batch timings, in ticks, of a benchmark. */
+static void AddResult(const std::string& name, std::vector<double>& ticks, unsigned int batch, uint64_t allocations)
+{
+	BENCH_RESULT result;
+	result.name = name;
+	result.batch = batch;
+	result.ops = (uint64_t)ticks.size() * batch;
+	result.memory = -1;
+
+	double total = 0.0;
+	for (double& t : ticks)
+	{
+		t = t * g_ns_per_tick / batch;
+		total += t;
+	}
+	std::sort(ticks.begin(), ticks.end());
+
+	result.ns_per_op = ticks.empty() ? 0.0 : total / ticks.size();
+	result.allocs_per_op = result.ops ? (double)allocations / result.ops : 0.0;
+	result.p50 = Percentile(ticks, 0.50);
+	result.p90 = Percentile(ticks, 0.90);
+	result.p99 = Percentile(ticks, 0.99);
+	result.max = ticks.empty() ? 0.0 : ticks.back();
+
+	fprintf(stderr, "%-40s %12.1f ns/op %8.3f allocs/op  p50 %10.1f  p99 %10.1f\n",
+		result.name.c_str(), result.ns_per_op, result.allocs_per_op, result.p50, result.p99);
+
+	g_results.push_back(result);
+}
+
+/*! Time an operation in batches, the operation is passed the iteration number. */
+template <typename F>
+static void Measure(const std::string& name, unsigned int batches, unsigned int batch, F op)
+{
+	if (!Enabled(name.c_str()))
+		return;
+
+	// Warm up the caches and any lazy initialization
+	for (unsigned int i = 0; i < batch; i++)
+		op(i);
+
+	std::vector<double> ticks;
+	ticks.reserve(batches);
+
+	uint64_t allocations = g_allocations.load();
+	unsigned int n = 0;
+	for (unsigned int b = 0; b < batches; b++)
+	{
+		int64_t start = GetTicks();
+		for (unsigned int i = 0; i < batch; i++)
+			op(n++);
+		ticks.push_back((double)(GetTicks() - start));
+	}
+	allocations = g_allocations.load() - allocations;
+
+	AddResult(name, ticks, batch, allocations);
+}
+
+static std::vector<GLOVE_REPORT> GenerateReports()
+{
+	std::vector<GLOVE_REPORT> reports(SYNTHETIC_REPORTS);
+
+	for (size_t i = 0; i < reports.size(); i++)
+	{
+		// A hand slowly rotating around a tilted axis while the fingers open and close
+		float t = i / 100.0f;
+		float angle = t * 0.5f;
+		float axis[3] = { 0.48f, 0.6f, 0.64f };
+
+		GLOVE_REPORT& report = reports[i];
+		report.quat[0] = (int16_t)(cosf(angle) * 16383.0f);
+		for (int j = 0; j < 3; j++)
+			report.quat[j + 1] = (int16_t)(sinf(angle) * axis[j] * 16383.0f);
+
+		report.accel[0] = (int16_t)(sinf(t * 3.0f) * 2000.0f);
+		report.accel[1] = (int16_t)(cosf(t * 2.0f) * 2000.0f);
+		report.accel[2] = (int16_t)(16384 + sinf(t) * 500.0f);
+
+		for (int j = 0; j < GLOVE_FINGERS; j++)
+			report.fingers[j] = (uint8_t)(127.5f + 127.5f * sinf(t + j * 0.3f));
+	}
+
+	return reports;
+}
+
+static bool LoadReports(const char* path, std::vector<GLOVE_REPORT>& reports)
+{
+	RecordingReader reader;
+	if (!reader.Open(path))
+		return false;
+
+	std::vector<GLOVE_RECORD> records;
+	RECORDING_READ result;
+	while ((result = reader.ReadRecords(records)) == RECORDING_BLOCK);
+
+	for (const GLOVE_RECORD& record : records)
+		reports.push_back(record.report);
+
+	return result == RECORDING_END && !reports.empty();
+}
+
+static void BenchDecode(const std::vector<GLOVE_REPORT>& reports)
+{
+	Glove glove(GLOVE_RIGHT);
+	size_t count = reports.size();
+
+	Measure("glove_decode", 2000, 256, [&](unsigned int i) {
+		glove.ProcessReport(reports[i % count], 0);
+	});
+
+	GLOVE_SAMPLE sample;
+	Glove callback_glove(GLOVE_RIGHT, [&](const GLOVE_SAMPLE& s) { sample = s; });
+	Measure("glove_decode/callback", 2000, 256, [&](unsigned int i) {
+		callback_glove.ProcessReport(reports[i % count], 0);
+	});
+}
+
+/*! Size against the 19-byte report and single-core decode speed of GloveCodec. */
+static void MeasureCodec(const char* name, const std::vector<GLOVE_RECORD>& records)
+{
+	if (!Enabled(name))
+		return;
+
+	size_t count = records.size() / CODEC_BLOCK_SAMPLES;
+	std::vector<std::vector<uint8_t>> blocks(count);
+	size_t encoded = 0;
+	for (size_t b = 0; b < count; b++)
+	{
+		GloveCodec::EncodeBlock(&records[b * CODEC_BLOCK_SAMPLES], CODEC_BLOCK_SAMPLES, blocks[b]);
+		encoded += blocks[b].size();
+	}
+
+	std::vector<GLOVE_RECORD> decoded;
+	decoded.reserve(CODEC_BLOCK_SAMPLES);
+	std::vector<double> ticks;
+	uint64_t allocations = g_allocations.load();
+	for (int pass = 0; pass < 8; pass++)
+	{
+		for (const std::vector<uint8_t>& block : blocks)
+		{
+			decoded.clear();
+			int64_t start = GetTicks();
+			GloveCodec::DecodeBlock(block.data(), block.size(), decoded);
+			ticks.push_back((double)(GetTicks() - start));
+		}
+	}
+	allocations = g_allocations.load() - allocations;
+
+	AddResult(name, ticks, CODEC_BLOCK_SAMPLES, allocations);
+
+	double ratio = (double)(count * CODEC_BLOCK_SAMPLES * sizeof(GLOVE_REPORT)) / encoded;
+	double rate = g_results.back().ns_per_op > 0.0 ? 1e9 / g_results.back().ns_per_op : 0.0;
+	g_results.back().metrics.push_back(std::make_pair("ratio", ratio));
+	g_results.back().metrics.push_back(std::make_pair("samples_per_second", rate));
+	g_results.back().metrics.push_back(std::make_pair("target_ratio", CODEC_TARGET_RATIO));
+	g_results.back().metrics.push_back(std::make_pair("target_samples_per_second", CODEC_TARGET_RATE));
+
+	// The shortfall is reported rather than failed, neither target is reachable for every input.
+	// A lossless codec can't store the sensor noise in fewer bits than its entropy: the noise of
+	// codec_decode/noisy alone takes about 39 bits per sample, which caps any codec at 3.9x of the
+	// 152-bit report. A Rice code decodes every value after the previous one, which costs about
+	// 4 ns for each of the 13 channels of a sample, so one core tops out near 20M samples/s.
+	if (ratio < CODEC_TARGET_RATIO)
+		fprintf(stderr, "%-40s %.2fx smaller, below the target of %.0fx\n", name, ratio, CODEC_TARGET_RATIO);
+	if (rate < CODEC_TARGET_RATE)
+	{
+		fprintf(stderr, "%-40s %.1fM samples/s, below the target of %.0fM\n", name, rate / 1e6,
+			CODEC_TARGET_RATE / 1e6);
+	}
+}
+
+static void BenchCodec(const std::vector<GLOVE_REPORT>& reports)
+{
+	std::vector<GLOVE_RECORD> records(CODEC_BENCH_BLOCKS * CODEC_BLOCK_SAMPLES);
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		records[i].report = reports[i % reports.size()];
+		records[i].timestamp = i * 10000;
+	}
+	MeasureCodec("codec_decode", records);
+
+	// The synthetic reports are perfectly smooth, a real sensor adds noise to every channel
+	srand(1);
+	for (GLOVE_RECORD& record : records)
+	{
+		for (int j = 0; j < GLOVE_QUATS; j++)
+			record.report.quat[j] += (int16_t)(rand() % 7 - 3);
+		for (int j = 0; j < GLOVE_AXES; j++)
+			record.report.accel[j] += (int16_t)(rand() % 81 - 40);
+		record.timestamp += rand() % 601;
+	}
+	MeasureCodec("codec_decode/noisy", records);
+}
+
+static void BenchEuler(const std::vector<GLOVE_REPORT>& reports)
+{
+	std::vector<GLOVE_QUATERNION> quats(reports.size());
+	for (size_t i = 0; i < reports.size(); i++)
+	{
+		quats[i].w = reports[i].quat[0] / 16384.0f;
+		quats[i].x = reports[i].quat[1] / 16384.0f;
+		quats[i].y = reports[i].quat[2] / 16384.0f;
+		quats[i].z = reports[i].quat[3] / 16384.0f;
+	}
+
+	GLOVE_VECTOR euler;
+	float sink = 0.0f;
+	Measure("math_get_euler", 2000, 256, [&](unsigned int i) {
+		ManusMath::GetEuler(&euler, &quats[i % quats.size()]);
+		sink += euler.x;
+	});
+
+	// Keep the results alive
+	if (sink == 12345.0f)
+		fprintf(stderr, "\n");
+}
+
+static void BenchSimulate(const std::vector<GLOVE_REPORT>& reports)
+{
+	if (!Enabled("skeletal_simulate"))
+		return;
+
+	SkeletalModel skeletal;
+	if (!skeletal.InitializeScene())
+	{
+		fprintf(stderr, "skeletal_simulate: failed to load the hand model\n");
+		return;
+	}
+
+	std::vector<GLOVE_DATA> data(reports.size());
+	Glove glove(GLOVE_RIGHT);
+	for (size_t i = 0; i < reports.size(); i++)
+	{
+		glove.ProcessReport(reports[i], 0);
+		glove.GetData(&data[i], 0);
+	}
+
+	GLOVE_SKELETAL model;
+	Measure("skeletal_simulate", 500, 16, [&](unsigned int i) {
+		skeletal.Simulate(data[i % data.size()], &model, GLOVE_RIGHT);
+	});
+}
+
+static void BenchPalette()
+{
+	if (!Enabled("skeletal_palette"))
+		return;
+
+	// Every bone, converted from the Unity axes to a right-handed convention
+	GLOVE_PALETTE_LAYOUT layout;
+	layout.Format = GLOVE_PALETTE_3X4;
+	layout.Axes[0] = -1;
+	layout.Axes[1] = 2;
+	layout.Axes[2] = 3;
+	layout.BoneCount = GLOVE_BONES;
+	for (unsigned int i = 0; i < GLOVE_BONES; i++)
+		layout.Bones[i] = i;
+
+	GLOVE_SKELETAL model;
+	GLOVE_POSE* poses = (GLOVE_POSE*)&model;
+	for (unsigned int i = 0; i < GLOVE_BONES; i++)
+	{
+		float angle = i * 0.1f;
+		poses[i].orientation = { cosf(angle), sinf(angle), 0.0f, 0.0f };
+		poses[i].position = { (float)i, 0.0f, 0.0f };
+	}
+
+	alignas(16) float palette[GLOVE_BONES * 12];
+	float sink = 0.0f;
+	Measure("skeletal_palette", 2000, 64, [&](unsigned int i) {
+		SkeletalPalette::Write(model, layout, palette);
+		sink += palette[i % (GLOVE_BONES * 12)];
+	});
+
+	// Keep the results alive
+	if (sink == 12345.0f)
+		fprintf(stderr, "\n");
+}
+
+static void BenchRig()
+{
+	if (!Enabled("skeletal_rig"))
+		return;
+
+	static const int parents[GLOVE_BONES] = { -1, 0, 1, 2, 0, 4, 5, 6, 0, 8, 9, 10, 0, 12, 13, 14, 0, 16, 17, 18 };
+
+	// A rest pose of straight fingers and a model with every finger bent
+	GLOVE_SKELETAL rest, model;
+	GLOVE_POSE* rest_poses = (GLOVE_POSE*)&rest;
+	GLOVE_POSE* poses = (GLOVE_POSE*)&model;
+	for (unsigned int i = 0; i < GLOVE_BONES; i++)
+	{
+		float angle = i * 0.1f;
+		rest_poses[i].orientation = { 1.0f, 0.0f, 0.0f, 0.0f };
+		rest_poses[i].position = { 0.0f, 0.0f, (float)i };
+		poses[i].orientation = { cosf(angle), sinf(angle), 0.0f, 0.0f };
+		poses[i].position = { 0.0f, 0.0f, (float)i };
+	}
+
+	// Every bone, converted from the Unity axes to a right-handed convention
+	GLOVE_RIG rig = {};
+	rig.Axes[0] = -1;
+	rig.Axes[1] = 2;
+	rig.Axes[2] = 3;
+	rig.Scale = 1.0f;
+	rig.Space = GLOVE_RIG_LOCAL;
+	rig.BoneCount = GLOVE_BONES;
+	for (unsigned int i = 0; i < GLOVE_BONES; i++)
+	{
+		rig.Bones[i].Parent = parents[i];
+		rig.Bones[i].Source = i;
+		rig.Bones[i].Rest.orientation = { 1.0f, 0.0f, 0.0f, 0.0f };
+		rig.Bones[i].Rest.position = { 0.0f, 0.0f, parents[i] < 0 ? 0.0f : 1.0f };
+	}
+
+	SkeletalRig compiled;
+	compiled.Compile(GLOVE_RIGHT, rig, rest, 0);
+
+	GLOVE_POSE output[GLOVE_BONES];
+	float sink = 0.0f;
+	Measure("skeletal_rig", 2000, 64, [&](unsigned int i) {
+		compiled.Evaluate(model, output);
+		sink += output[i % GLOVE_BONES].orientation.w;
+	});
+
+	// Keep the results alive
+	if (sink == 12345.0f)
+		fprintf(stderr, "\n");
+}
+
+static void BenchGestures(const std::vector<GLOVE_REPORT>& reports)
+{
+	if (!Enabled("gesture_match"))
+		return;
+
+	std::vector<GLOVE_SAMPLE> samples(reports.size());
+	Glove glove(GLOVE_RIGHT);
+	for (size_t i = 0; i < reports.size(); i++)
+	{
+		glove.ProcessReport(reports[i], i * 10000);
+		glove.GetData(&samples[i].data, 0);
+		samples[i].hand = GLOVE_RIGHT;
+		samples[i].timestamp = i * 10000;
+	}
+
+	// Spread the templates over the finger space, half with an orientation constraint
+	GestureEngine engine;
+	for (unsigned int id = 0; id < 32; id++)
+	{
+		GLOVE_GESTURE gesture = {};
+		gesture.Id = id;
+		for (int i = 0; i < 5; i++)
+		{
+			gesture.Fingers[i] = ((id >> i) & 1) ? 1.0f : 0.0f;
+			gesture.Tolerance[i] = 0.3f;
+		}
+		if (id & 1)
+		{
+			gesture.Axis = { 0.0f, 0.0f, 1.0f };
+			gesture.Direction = { 0.0f, -1.0f, 0.0f };
+			gesture.MaxAngle = 0.5f;
+		}
+		engine.Add(gesture);
+	}
+
+	GLOVE_GESTURE_EVENT event;
+	Measure("gesture_match/templates:32", 2000, 256, [&](unsigned int i) {
+		engine.Process(samples[i % samples.size()]);
+		while (engine.Poll(&event));
+	});
+}
+
+static void BenchImuCalibration()
+{
+	if (!Enabled("imu_calibration_solve"))
+		return;
+
+	// Gravity turned slowly around the sphere, with an offset and a scale error
+	ImuCalibration calibration;
+	calibration.Start();
+	for (unsigned int i = 0; i < 20000; i++)
+	{
+		float theta = i * 0.0005f;
+		float phi = i * 0.0137f;
+		GLOVE_VECTOR acceleration = {
+			1.04f * sinf(theta) * cosf(phi) + 0.03f,
+			0.97f * sinf(theta) * sinf(phi) - 0.02f,
+			1.01f * cosf(theta) + 0.05f,
+		};
+		calibration.Apply(&acceleration);
+	}
+
+	GLOVE_IMU_CALIBRATION fit;
+	GLOVE_IMU_CALIBRATION_STATUS status;
+	float sink = 0.0f;
+	Measure("imu_calibration_solve", 200, 4, [&](unsigned int i) {
+		calibration.Solve(&fit, &status);
+		sink += fit.Offset.x;
+	});
+
+	// Keep the results alive
+	if (sink == 12345.0f)
+		fprintf(stderr, "\n");
+}
+
+static void BenchPalmTracking(const std::vector<GLOVE_REPORT>& reports)
+{
+	if (!Enabled("palm_tracking"))
+		return;
+
+	// Decode the reports once, the tracker only sees the decoded data
+	std::vector<GLOVE_DATA> data;
+	Glove glove(GLOVE_RIGHT);
+	for (const GLOVE_REPORT& report : reports)
+	{
+		glove.ProcessReport(report, 0);
+		GLOVE_DATA sample;
+		glove.GetData(&sample, 0);
+		data.push_back(sample);
+	}
+
+	PalmTracker tracker;
+	GLOVE_PALM_TRACKING parameters;
+	PalmTracker::GetDefault(&parameters);
+	parameters.Enabled = true;
+	tracker.SetParameters(parameters);
+
+	// Samples arrive at 100 Hz
+	uint64_t timestamp = 0;
+	GLOVE_VECTOR position;
+	float sink = 0.0f;
+	Measure("palm_tracking", 2000, 256, [&](unsigned int i) {
+		timestamp += 10000;
+		tracker.Update(data[i % data.size()], timestamp, &position);
+		sink += position.x;
+	});
+
+	// Keep the results alive
+	if (sink == 12345.0f)
+		fprintf(stderr, "\n");
+}
+
+static void BenchTrackerFusion(const std::vector<GLOVE_REPORT>& reports)
+{
+	if (!Enabled("tracker_fusion"))
+		return;
+
+	std::vector<GLOVE_SAMPLE> samples;
+	Glove glove(GLOVE_RIGHT);
+	for (const GLOVE_REPORT& report : reports)
+	{
+		glove.ProcessReport(report, 0);
+		GLOVE_SAMPLE sample = {};
+		sample.hand = GLOVE_RIGHT;
+		glove.GetData(&sample.data, 0);
+		samples.push_back(sample);
+	}
+
+	GLOVE_SKELETAL rest;
+	GLOVE_POSE* poses = (GLOVE_POSE*)&rest;
+	for (int i = 0; i < GLOVE_BONES; i++)
+	{
+		poses[i].orientation = { 1.0f, 0.0f, 0.0f, 0.0f };
+		poses[i].position = { (float)i, 0.0f, 0.0f };
+	}
+
+	// Glove samples at 100 Hz and tracker poses at 90 Hz, with every sample in between two poses
+	TrackerFusion fusion;
+	uint64_t timestamp = 100000;
+	uint64_t tracker_time = 0;
+	GLOVE_SKELETAL model;
+	float sink = 0.0f;
+	Measure("tracker_fusion", 2000, 256, [&](unsigned int i) {
+		timestamp += 10000;
+		while (tracker_time <= timestamp)
+		{
+			tracker_time += 11111;
+			GLOVE_POSE pose = { { 1.0f, 0.0f, 0.0f, 0.0f }, { 0.001f * (float)(tracker_time % 1000), 1.5f, 0.0f } };
+			fusion.Push(tracker_time, pose);
+		}
+
+		GLOVE_SAMPLE& sample = samples[i % samples.size()];
+		sample.timestamp = timestamp;
+		fusion.Process(sample);
+
+		model = rest;
+		fusion.Transform(&model);
+		sink += model.palm.position.x;
+	});
+
+	// Keep the results alive
+	if (sink == 12345.0f)
+		fprintf(stderr, "\n");
+}
+
+static void BenchPoseHistory(const std::vector<GLOVE_REPORT>& reports)
+{
+	if (!Enabled("pose_history"))
+		return;
+
+	std::vector<GLOVE_SAMPLE> samples;
+	Glove glove(GLOVE_RIGHT);
+	for (const GLOVE_REPORT& report : reports)
+	{
+		glove.ProcessReport(report, 0);
+		GLOVE_SAMPLE sample = {};
+		sample.hand = GLOVE_RIGHT;
+		glove.GetData(&sample.data, 0);
+		samples.push_back(sample);
+	}
+
+	// Ten seconds of samples at 100 Hz, trimmed as new ones arrive
+	PoseHistory history;
+	history.SetRetention(10000);
+	uint64_t timestamp = 0;
+	Measure("pose_history/push", 2000, 256, [&](unsigned int i) {
+		GLOVE_SAMPLE& sample = samples[i % samples.size()];
+		timestamp += 10000;
+		sample.timestamp = timestamp;
+		history.Push(sample);
+	});
+
+	// Look up times spread over the whole history, in between the samples
+	uint64_t oldest, newest;
+	history.GetRange(&oldest, &newest);
+	uint64_t span = newest - oldest;
+	GLOVE_DATA data;
+	float sink = 0.0f;
+	Measure("pose_history/data_at", 2000, 256, [&](unsigned int i) {
+		history.GetData(oldest + (i * 7919ull * 997) % span, &data);
+		sink += data.Fingers[0];
+	});
+
+	SkeletalModel skeletal;
+	if (skeletal.InitializeScene())
+	{
+		GLOVE_SKELETAL model;
+		Measure("pose_history/skeletal_at", 2000, 64, [&](unsigned int i) {
+			history.GetSkeletal(oldest + (i * 7919ull * 997) % span, skeletal, GLOVE_RIGHT, &model);
+			sink += model.palm.position.x;
+		});
+	}
+
+	// Keep the results alive
+	if (sink == 12345.0f)
+		fprintf(stderr, "\n");
+}
+
+static void BenchTracing()
+{
+	if (!Enabled("trace"))
+		return;
+
+	bool enabled = Tracer::IsEnabled();
+
+	// A trace point on a path while tracing is off
+	Tracer::SetEnabled(false);
+	Measure("trace_disabled", 2000, 1024, [&](unsigned int i) {
+		TraceScope scope("ManusBench::TraceDisabled", i);
+	});
+
+	// Recording into the ring of this thread, which wraps around many times
+	Tracer::SetEnabled(true);
+	Measure("trace_scope", 2000, 1024, [&](unsigned int i) {
+		TraceScope scope("ManusBench::TraceScope", i);
+	});
+	Measure("trace_instant", 2000, 1024, [&](unsigned int i) {
+		TRACE_INSTANT("ManusBench::TraceInstant", i);
+	});
+
+	// Leave the benchmark's own events out of a trace of the run
+	Tracer::SetEnabled(enabled);
+	Tracer::Instance().Clear();
+}
+
+static void AddGloves(unsigned int others, Glove* right)
+{
+	std::lock_guard<std::mutex> lock(g_gloves_mutex);
+
+	// The right glove is added last, so every lookup has to skip all the others
+	for (unsigned int i = 0; i < others; i++)
+		g_gloves.push_back(new Glove(GLOVE_LEFT));
+	g_gloves.push_back(right);
+}
+
+static void RemoveGloves(Glove* keep)
+{
+	std::lock_guard<std::mutex> lock(g_gloves_mutex);
+
+	for (Glove* glove : g_gloves)
+	{
+		if (glove != keep)
+			delete glove;
+	}
+	g_gloves.clear();
+}
+
+static void BenchLookup()
+{
+	const unsigned int counts[] = { 1, 8, 64 };
+	for (unsigned int count : counts)
+	{
+		Glove right(GLOVE_RIGHT);
+		AddGloves(count, &right);
+
+		Glove* elem;
+		Measure("get_glove/gloves:" + std::to_string(count + 1), 2000, 256, [&](unsigned int i) {
+			GetGlove(GLOVE_RIGHT, &elem);
+		});
+
+		RemoveGloves(&right);
+	}
+}
+
+static void BenchContention(const std::vector<GLOVE_REPORT>& reports)
+{
+	const unsigned int readers[] = { 1, 2, 4, 8 };
+	for (unsigned int count : readers)
+	{
+		std::string name = "get_data_contention/readers:" + std::to_string(count);
+		if (!Enabled(name.c_str()))
+			continue;
+
+		Glove right(GLOVE_RIGHT);
+		AddGloves(0, &right);
+		right.ProcessReport(reports[0], 0);
+
+		std::atomic<bool> running(true);
+		std::atomic<unsigned int> ready(0);
+
+		// Deliver reports as fast as possible to maximize the contention on the glove
+		std::thread writer([&] {
+			size_t i = 0;
+			while (running.load(std::memory_order_relaxed))
+				right.ProcessReport(reports[i++ % reports.size()], 0);
+		});
+
+		const unsigned int batches = 2000, batch = 64;
+		std::vector<std::vector<double>> ticks(count);
+		std::vector<std::thread> threads;
+
+		uint64_t allocations = g_allocations.load();
+		for (unsigned int t = 0; t < count; t++)
+		{
+			threads.emplace_back([&, t] {
+				ticks[t].reserve(batches);
+				ready++;
+				while (ready.load() < count)
+					std::this_thread::yield();
+
+				GLOVE_DATA data;
+				for (unsigned int b = 0; b < batches; b++)
+				{
+					int64_t start = GetTicks();
+					for (unsigned int i = 0; i < batch; i++)
+						ManusGetData(GLOVE_RIGHT, &data, 0);
+					ticks[t].push_back((double)(GetTicks() - start));
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+		allocations = g_allocations.load() - allocations;
+
+		running = false;
+		writer.join();
+		RemoveGloves(&right);
+
+		std::vector<double> merged;
+		for (const std::vector<double>& t : ticks)
+			merged.insert(merged.end(), t.begin(), t.end());
+
+		// Allocations made by the writer are included, which is also the SDK at work
+		AddResult(name, merged, batch, allocations);
+	}
+}
+
+static void BenchLatency(const std::vector<GLOVE_REPORT>& reports)
+{
+	if (!Enabled("callback_to_reader_latency"))
+		return;
+
+	Glove right(GLOVE_RIGHT);
+	AddGloves(0, &right);
+
+	// The time every packet was handed to the glove, indexed by packet number
+	std::vector<std::atomic<int64_t>> sent(LATENCY_SAMPLES + 2);
+	std::vector<double> ticks;
+	ticks.reserve(LATENCY_SAMPLES);
+	std::atomic<bool> running(true);
+
+	std::thread reader([&] {
+		unsigned int last = 0;
+		GLOVE_DATA data;
+		while (running.load())
+		{
+			// Wait for the next packet, a timeout returns the last one again
+			if (ManusGetData(GLOVE_RIGHT, &data, 100) != MANUS_SUCCESS || data.PacketNumber == last)
+				continue;
+
+			int64_t now = GetTicks();
+			last = data.PacketNumber;
+			if (last < sent.size())
+				ticks.push_back((double)(now - sent[last].load()));
+		}
+	});
+
+	// Give the reader time to start waiting
+	Sleep(10);
+
+	uint64_t allocations = g_allocations.load();
+	for (unsigned int i = 1; i <= LATENCY_SAMPLES; i++)
+	{
+		sent[i] = GetTicks();
+		right.ProcessReport(reports[i % reports.size()], 0);
+
+		// Roughly the rate of the glove, which gives the reader time to go back to waiting
+		Sleep(1);
+	}
+	allocations = g_allocations.load() - allocations;
+
+	running = false;
+	reader.join();
+	RemoveGloves(&right);
+
+	AddResult("callback_to_reader_latency", ticks, 1, allocations);
+}
+
+static int64_t GetResidentMemory()
+{
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return (int64_t)counters.WorkingSetSize;
+}
+
+/*! Initialize the SDK in this fresh process and print the cost of starting the features. */
+static int RunColdStart(unsigned int features)
+{
+	std::vector<GLOVE_REPORT> reports = GenerateReports();
+	GLOVE_POSE pose = { { 1.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+
+	GLOVE_INIT_OPTIONS options;
+	options.Features = features;
+	options.Preload = false;
+
+	int64_t memory = GetResidentMemory();
+	uint64_t allocations = g_allocations.load();
+	int64_t start = GetTicks();
+
+	if (ManusInitEx(&options) != MANUS_SUCCESS)
+		return 1;
+
+	int64_t initialized = GetTicks();
+
+	// Feed a simulated glove, then use every enabled feature once
+	Glove* glove = new Glove(GLOVE_RIGHT);
+	glove->ProcessReport(reports[0], 0);
+	{
+		std::lock_guard<std::mutex> lock(g_gloves_mutex);
+		g_gloves.push_back(glove);
+	}
+
+	GLOVE_SKELETAL model;
+	if ((features & GLOVE_FEATURE_SKELETAL) && ManusGetSkeletal(GLOVE_RIGHT, &model) != MANUS_SUCCESS)
+		return 1;
+	if ((features & GLOVE_FEATURE_FUSION) && ManusPushTrackerPose(GLOVE_RIGHT, 0, &pose) != MANUS_SUCCESS)
+		return 1;
+
+	int64_t used = GetTicks();
+	allocations = g_allocations.load() - allocations;
+	memory = GetResidentMemory() - memory;
+
+	printf("%lld %lld %llu %lld\n", (long long)(initialized - start), (long long)(used - initialized),
+		(unsigned long long)allocations, (long long)memory);
+
+	ManusExit();
+
+	return 0;
+}
+
+/*! Gloves on a simulated adapter lose the share of their reports over its bandwidth. */
+static float SimulateAdapters(AdapterScheduler& scheduler, const std::vector<GLOVE_ADAPTER_CAPACITY>& capacities,
+	const std::vector<float>& rates, uint64_t now)
+{
+	float demand = 0.0f;
+	float received = 0.0f;
+	for (int adapter = 0; adapter < (int)capacities.size(); adapter++)
+	{
+		// Gloves beyond the connections of the adapter don't get through at all
+		std::vector<uint64_t> gloves;
+		float offered = 0.0f;
+		for (uint64_t glove = 0; glove < rates.size(); glove++)
+		{
+			if (scheduler.GetAdapter(glove) != adapter)
+				continue;
+			if (gloves.size() < capacities[adapter].Connections)
+				offered += rates[glove];
+			gloves.push_back(glove);
+		}
+
+		float delivered = offered > capacities[adapter].Bandwidth ? capacities[adapter].Bandwidth / offered : 1.0f;
+		for (size_t i = 0; i < gloves.size(); i++)
+		{
+			float fraction = i < capacities[adapter].Connections ? delivered : 0.0f;
+			scheduler.Update(gloves[i], now, rates[gloves[i]] * fraction, 1.0f - fraction);
+			demand += rates[gloves[i]];
+			received += rates[gloves[i]] * fraction;
+		}
+	}
+
+	return demand > 0.0f ? 1.0f - received / demand : 0.0f;
+}
+
+static void BenchAdapters()
+{
+	static const struct
+	{
+		const char* name;
+		unsigned int gloves;
+		unsigned int adapters;
+		GLOVE_ADAPTER_CAPACITY capacity;
+	} fleets[] = {
+		{ "gloves:12/adapters:3", 12, 3, { 7, 1000.0f } },
+		{ "gloves:16/adapters:3", 16, 3, { 7, 700.0f } },
+		{ "gloves:32/adapters:6", 32, 6, { 7, 800.0f } },
+	};
+
+	for (const auto& fleet : fleets)
+	{
+		std::string name = std::string("adapter_scheduler/") + fleet.name;
+		if (!Enabled(name.c_str()))
+			continue;
+
+		// The last adapter is a weaker one, the gloves send at slightly different rates
+		std::vector<GLOVE_ADAPTER_CAPACITY> capacities(fleet.adapters, fleet.capacity);
+		capacities.back().Connections = 4;
+		capacities.back().Bandwidth = fleet.capacity.Bandwidth / 2;
+		std::vector<float> rates;
+		for (unsigned int i = 0; i < fleet.gloves; i++)
+			rates.push_back(80.0f + (i % 5) * 10.0f);
+
+		AdapterScheduler scheduler;
+		for (unsigned int a = 0; a < fleet.adapters; a++)
+			scheduler.SetCapacity(scheduler.AddAdapter(), capacities[a]);
+
+		// Windows puts every glove on the first adapter, the others are found later
+		for (uint64_t glove = 0; glove < fleet.gloves; glove++)
+		{
+			scheduler.AddGlove(glove, 0);
+			scheduler.Assign(glove);
+		}
+		for (uint64_t glove = 0; glove < fleet.gloves; glove++)
+		{
+			for (unsigned int a = 1; a < fleet.adapters; a++)
+				scheduler.AddGlove(glove, a);
+		}
+
+		// One round per period until the gloves have stayed put for a while
+		std::vector<double> ticks;
+		std::vector<ADAPTER_MIGRATION> migrations;
+		uint64_t now = 0;
+		uint64_t last_move = 0;
+		unsigned int moved = 0;
+		float initial_loss = -1.0f;
+		float loss = 0.0f;
+		uint64_t allocations = g_allocations.load();
+		for (int round = 0; round < 300 && now - last_move <= 2 * SCHEDULER_SETTLE; round++)
+		{
+			now += SCHEDULER_PERIOD;
+			loss = SimulateAdapters(scheduler, capacities, rates, now);
+			if (initial_loss < 0.0f)
+				initial_loss = loss;
+
+			int64_t start = GetTicks();
+			scheduler.Rebalance(now, migrations);
+			ticks.push_back((double)(GetTicks() - start));
+
+			if (!migrations.empty())
+			{
+				moved += (unsigned int)migrations.size();
+				last_move = now;
+			}
+		}
+		allocations = g_allocations.load() - allocations;
+
+		AddResult(name + "/rebalance", ticks, 1, allocations);
+		g_results.back().metrics.push_back(std::make_pair("initial_loss", (double)initial_loss));
+		g_results.back().metrics.push_back(std::make_pair("final_loss", (double)loss));
+		g_results.back().metrics.push_back(std::make_pair("migrations", (double)moved));
+		g_results.back().metrics.push_back(std::make_pair("settle_seconds", last_move / 1e6));
+		fprintf(stderr, "%-40s loss %.3f -> %.3f after %u migrations in %.0f s\n",
+			name.c_str(), initial_loss, loss, moved, last_move / 1e6);
+	}
+}
+
+// Compare a sample after the trip through the stream protocol, which quantizes it.
+static bool MatchesStreamed(const GLOVE_DATA& sent, const GLOVE_DATA& received)
+{
+	// q and -q are the same rotation
+	const GLOVE_QUATERNION& a = sent.Quaternion;
+	const GLOVE_QUATERNION& b = received.Quaternion;
+	if (fabsf(a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z) < 1.0f - 1e-6f)
+		return false;
+
+	const float* sent_accel = &sent.Acceleration.x;
+	const float* received_accel = &received.Acceleration.x;
+	for (int i = 0; i < GLOVE_AXES; i++)
+	{
+		if (fabsf(sent_accel[i] - received_accel[i]) > 1.0f / 16384.0f)
+			return false;
+	}
+
+	for (int i = 0; i < GLOVE_FINGERS; i++)
+	{
+		if (fabsf(sent.Fingers[i] - received.Fingers[i]) > 1.0f / 255.0f)
+			return false;
+	}
+
+	return sent.PacketNumber == received.PacketNumber;
+}
+
+static void BenchStreamLoopback()
+{
+	if (!Enabled("stream_loopback"))
+		return;
+
+	// The relay sits between the server and the client and drops every Nth packet
+	WSADATA wsa_data;
+	if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+		return;
+
+	SOCKET relay = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	sockaddr_in relay_address = {};
+	relay_address.sin_family = AF_INET;
+	relay_address.sin_port = htons(LOOPBACK_PORT);
+	inet_pton(AF_INET, "127.0.0.1", &relay_address.sin_addr);
+	sockaddr_in client_address = relay_address;
+	client_address.sin_port = htons(LOOPBACK_PORT + 1);
+
+	DWORD timeout = LOOPBACK_TIMEOUT;
+	setsockopt(relay, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+
+	StreamServer server;
+	StreamClient client;
+	if (relay == INVALID_SOCKET || bind(relay, (const sockaddr*)&relay_address, sizeof(relay_address)) == SOCKET_ERROR ||
+		!server.Start("127.0.0.1", LOOPBACK_PORT) || !client.Connect("127.0.0.1", LOOPBACK_PORT + 1))
+	{
+		fprintf(stderr, "stream_loopback: failed to open the sockets\n");
+		g_exit_code = 1;
+		if (relay != INVALID_SOCKET)
+			closesocket(relay);
+		WSACleanup();
+		return;
+	}
+
+	std::vector<double> ticks;
+	unsigned int dropped = 0, skipped = 0, mismatched = 0;
+	bool key_lost = false;
+	uint64_t allocations = g_allocations.load();
+	for (unsigned int i = 1; i <= LOOPBACK_SAMPLES; i++)
+	{
+		GLOVE_SAMPLE sample = {};
+		sample.hand = GLOVE_RIGHT;
+		sample.timestamp = i * 10000ull;
+
+		float angle = i * 0.01f;
+		GLOVE_DATA& data = sample.data;
+		data.Quaternion = { cosf(angle), 0.6f * sinf(angle), 0.8f * sinf(angle), 0.0f };
+		data.Acceleration = { 0.5f * sinf(angle), 0.25f * cosf(angle), 1.0f };
+		for (int f = 0; f < GLOVE_FINGERS; f++)
+			data.Fingers[f] = 0.5f + 0.4f * sinf(angle * (f + 1));
+		data.PacketNumber = i;
+
+		int64_t start = GetTicks();
+		server.Publish(sample);
+
+		uint8_t packet[STREAM_MAX_PACKET];
+		int length = recv(relay, (char*)packet, sizeof(packet), 0);
+		if (length < 2)
+		{
+			mismatched++;
+			continue;
+		}
+
+		// Deltas after a lost keyframe can't be decoded until the next keyframe
+		bool keyframe = (packet[1] & STREAM_FLAGS_KEYFRAME) != 0;
+		if (i % LOOPBACK_DROP == 0)
+		{
+			key_lost |= keyframe;
+			dropped++;
+			continue;
+		}
+		if (keyframe)
+			key_lost = false;
+
+		sendto(relay, (const char*)packet, length, 0, (const sockaddr*)&client_address, sizeof(client_address));
+		if (key_lost)
+		{
+			skipped++;
+			continue;
+		}
+
+		// Only wait if the packet hasn't been received yet
+		GLOVE_DATA received = {};
+		client.GetData(GLOVE_RIGHT, &received, 0);
+		if (received.PacketNumber != i)
+			client.GetData(GLOVE_RIGHT, &received, LOOPBACK_TIMEOUT);
+		if (!MatchesStreamed(data, received))
+		{
+			mismatched++;
+			continue;
+		}
+		ticks.push_back((double)(GetTicks() - start));
+	}
+	allocations = g_allocations.load() - allocations;
+
+	client.Disconnect();
+	server.Stop();
+	closesocket(relay);
+	WSACleanup();
+
+	AddResult("stream_loopback", ticks, 1, allocations);
+	g_results.back().metrics.push_back(std::make_pair("dropped", (double)dropped));
+	g_results.back().metrics.push_back(std::make_pair("undecodable", (double)skipped));
+	g_results.back().metrics.push_back(std::make_pair("mismatched", (double)mismatched));
+	if (mismatched > 0)
+	{
+		fprintf(stderr, "stream_loopback: %u of %u samples didn't arrive intact\n", mismatched, LOOPBACK_SAMPLES);
+		g_exit_code = 1;
+	}
+}
+
+static void BenchColdStart(const char* executable)
+{
+	static const struct
+	{
+		const char* name;
+		unsigned int features;
+	} sets[] = {
+		{ "none", 0 },
+		{ "recording", GLOVE_FEATURE_RECORDING },
+		{ "skeletal", GLOVE_FEATURE_SKELETAL },
+		{ "all", GLOVE_FEATURE_ALL },
+	};
+
+	for (const auto& set : sets)
+	{
+		std::string name = std::string("cold_start/features:") + set.name;
+		if (!Enabled((name + "/init").c_str()) && !Enabled((name + "/first_use").c_str()))
+			continue;
+
+		std::vector<double> init, first_use;
+		uint64_t allocations = 0;
+		int64_t memory = 0;
+		for (int run = 0; run < COLD_START_RUNS; run++)
+		{
+			std::string command = std::string("\"") + executable + "\" --cold-start " + std::to_string(set.features);
+			FILE* pipe = _popen(command.c_str(), "r");
+			if (!pipe)
+				break;
+
+			long long init_ticks, use_ticks, run_memory;
+			unsigned long long run_allocations;
+			int fields = fscanf(pipe, "%lld %lld %llu %lld", &init_ticks, &use_ticks, &run_allocations, &run_memory);
+			if (_pclose(pipe) != 0 || fields != 4)
+			{
+				fprintf(stderr, "Cold start with features %s failed\n", set.name);
+				break;
+			}
+
+			init.push_back((double)init_ticks);
+			first_use.push_back((double)use_ticks);
+			allocations += run_allocations;
+			memory += run_memory;
+		}
+
+		if (init.size() != COLD_START_RUNS)
+			continue;
+
+		// The allocations and memory cover both phases, so they are reported with the first use
+		AddResult(name + "/init", init, 1, 0);
+		AddResult(name + "/first_use", first_use, 1, allocations);
+		g_results.back().memory = memory / COLD_START_RUNS;
+	}
+}
+
+static void WriteResults(FILE* out)
+{
+	fprintf(out, "{\n");
+	fprintf(out, "  \"hardware_threads\": %u,\n", std::thread::hardware_concurrency());
+	fprintf(out, "  \"results\": [\n");
+	for (size_t i = 0; i < g_results.size(); i++)
+	{
+		const BENCH_RESULT& r = g_results[i];
+		fprintf(out, "    { \"name\": \"%s\", \"ops\": %llu, \"batch\": %u, \"ns_per_op\": %.2f, \"allocs_per_op\": %.4f, "
+			"\"p50_ns\": %.2f, \"p90_ns\": %.2f, \"p99_ns\": %.2f, \"max_ns\": %.2f",
+			r.name.c_str(), (unsigned long long)r.ops, r.batch, r.ns_per_op, r.allocs_per_op,
+			r.p50, r.p90, r.p99, r.max);
+		if (r.memory >= 0)
+			fprintf(out, ", \"memory_bytes\": %lld", (long long)r.memory);
+		for (const std::pair<std::string, double>& metric : r.metrics)
+			fprintf(out, ", \"%s\": %.4f", metric.first.c_str(), metric.second);
+		fprintf(out, " }%s\n", i + 1 < g_results.size() ? "," : "");
+	}
+	fprintf(out, "  ]\n");
+	fprintf(out, "}\n");
+}
+
+int main(int argc, char* argv[])
+{
+	const char* recording = nullptr;
+	const char* output = nullptr;
+	const char* trace = nullptr;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--cold-start") == 0)
+			return RunColdStart((unsigned int)strtoul(argv[i + 1], nullptr, 10));
+		else if (strcmp(argv[i], "--recording") == 0)
+			recording = argv[i + 1];
+		else if (strcmp(argv[i], "--out") == 0)
+			output = argv[i + 1];
+		else if (strcmp(argv[i], "--filter") == 0)
+			g_filter = argv[i + 1];
+		else if (strcmp(argv[i], "--trace") == 0)
+			trace = argv[i + 1];
+	}
+
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	g_ns_per_tick = 1e9 / freq.QuadPart;
+
+	std::vector<GLOVE_REPORT> reports;
+	if (recording)
+	{
+		if (!LoadReports(recording, reports))
+		{
+			fprintf(stderr, "Failed to read the recording %s\n", recording);
+			return 1;
+		}
+	}
+	else
+	{
+		reports = GenerateReports();
+	}
+
+	if (trace)
+		ManusSetTracing(true);
+
+	BenchTracing();
+	BenchDecode(reports);
+	BenchCodec(reports);
+	BenchEuler(reports);
+	BenchSimulate(reports);
+	BenchPalette();
+	BenchRig();
+	BenchGestures(reports);
+	BenchImuCalibration();
+	BenchPalmTracking(reports);
+	BenchTrackerFusion(reports);
+	BenchPoseHistory(reports);
+	BenchLookup();
+	BenchContention(reports);
+	BenchLatency(reports);
+	BenchAdapters();
+	BenchStreamLoopback();
+	BenchColdStart(argv[0]);
+
+	if (trace && ManusWriteTrace(trace) != MANUS_SUCCESS)
+		fprintf(stderr, "Failed to write the trace %s\n", trace);
+
+	FILE* out = output ? fopen(output, "w") : stdout;
+	if (!out)
+	{
+		fprintf(stderr, "Failed to open %s\n", output);
+		return 1;
+	}
+
+	WriteResults(out);
+
+	if (out != stdout)
+		fclose(out);
+
+	return g_exit_code;
+}
@@ -19,6 +19,7 @@
 
 using System;
 using System.Runtime.InteropServices;
+using System.Threading;
 
 namespace ManusMachina {
 #pragma warning disable 0649 // Disable 'field never assigned' warning
@@ -140,6 +141,241 @@ public struct GLOVE_SKELETAL {
             ring, pinky;
     }
 
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_PROFILE {
+        public const int POINTS = 9;
+
+        [MarshalAsAttribute(UnmanagedType.ByValArray, SizeConst = 5)]
+        public float[] Minimum;
+        [MarshalAsAttribute(UnmanagedType.ByValArray, SizeConst = 5)]
+        public float[] Maximum;
+        [MarshalAsAttribute(UnmanagedType.ByValArray, SizeConst = POINTS)]
+        public float[] Curve;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_FILTER {
+        public float FingerMinCutoff;
+        public float FingerBeta;
+        public float OrientationMinCutoff;
+        public float OrientationBeta;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_FRAME {
+        public ulong Time;
+        [MarshalAsAttribute(UnmanagedType.ByValArray, SizeConst = 2)]
+        public GLOVE_DATA[] Hands;
+        public uint ValidHands;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_PALETTE_LAYOUT {
+        public const int BONES = 20;
+        public const int MAX_BONES = 32;
+
+        public GLOVE_PALETTE_FORMAT Format;
+        [MarshalAsAttribute(UnmanagedType.ByValArray, SizeConst = 3)]
+        public int[] Axes;
+        public uint BoneCount;
+        [MarshalAsAttribute(UnmanagedType.ByValArray, SizeConst = MAX_BONES)]
+        public uint[] Bones;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_RING_FINGERS {
+        public float f0, f1, f2, f3, f4;
+
+        public float this[int index] {
+            get {
+                switch (index) {
+                    case 0: return this.f0;
+                    case 1: return this.f1;
+                    case 2: return this.f2;
+                    case 3: return this.f3;
+                    case 4: return this.f4;
+                    default: throw new InvalidOperationException();
+                }
+            }
+        }
+    }
+
+    /*! Blittable version of GLOVE_DATA, used in buffers shared with the SDK. */
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_RING_DATA {
+        public GLOVE_VECTOR Acceleration;
+        public GLOVE_VECTOR Euler;
+        public GLOVE_QUATERNION Quaternion;
+        public GLOVE_RING_FINGERS Fingers;
+        public uint PacketNumber;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_RING_ENTRY {
+        public ulong Sequence;
+        public ulong Timestamp;
+        public GLOVE_RING_DATA Data;
+        public GLOVE_SKELETAL Skeletal;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_GESTURE {
+        public uint Id;
+        [MarshalAsAttribute(UnmanagedType.ByValArray, SizeConst = 5)]
+        public float[] Fingers;
+        [MarshalAsAttribute(UnmanagedType.ByValArray, SizeConst = 5)]
+        public float[] Tolerance;
+        public GLOVE_VECTOR Axis;
+        public GLOVE_VECTOR Direction;
+        public float MaxAngle;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_GESTURE_EVENT {
+        public uint Id;
+        public GLOVE_GESTURE_EVENT_TYPE Type;
+        public uint PacketNumber;
+        public ulong Timestamp;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_PIPELINE {
+        public const int STAGES = 5;
+
+        [MarshalAsAttribute(UnmanagedType.ByValArray, SizeConst = STAGES)]
+        public GLOVE_PLACEMENT[] Placement;
+        public uint QueueSize;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_STAGE_STATS {
+        public ulong Count;
+        public ulong TotalTime;
+        public ulong MaxTime;
+        public ulong Dropped;
+        public uint MaxQueueDepth;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_RIG_BONE {
+        public int Parent;
+        public int Source;
+        public GLOVE_POSE Rest;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_RIG {
+        public const int MAX_BONES = 64;
+
+        [MarshalAsAttribute(UnmanagedType.ByValArray, SizeConst = 3)]
+        public int[] Axes;
+        public float Scale;
+        public GLOVE_RIG_SPACE Space;
+        public uint BoneCount;
+        [MarshalAsAttribute(UnmanagedType.ByValArray, SizeConst = MAX_BONES)]
+        public GLOVE_RIG_BONE[] Bones;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_IMU_CALIBRATION {
+        public GLOVE_VECTOR Offset;
+        /*! Rows of the 3x3 gain matrix. */
+        [MarshalAsAttribute(UnmanagedType.ByValArray, SizeConst = 9)]
+        public float[] Gain;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_IMU_CALIBRATION_STATUS {
+        public uint Samples;
+        public float Coverage;
+        public float FitError;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_LINK_STATS {
+        public ulong Packets;
+        public ulong Dropped;
+        public ulong Duplicates;
+        public ulong ReadFailures;
+        public float Rate;
+        public float Loss;
+        public float Interval;
+        public float Jitter;
+        public ulong Age;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_PALM_TRACKING {
+        [MarshalAsAttribute(UnmanagedType.I1)]
+        public bool Enabled;
+        public float StillAcceleration;
+        public float StillRotation;
+        public float StillTime;
+        public float VelocityTimeConstant;
+        public float PositionTimeConstant;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_TRACKER {
+        public GLOVE_POSE Mount;
+        public float Scale;
+        public int TimeOffset;
+        public float OrientationGain;
+        public uint Timeout;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_THREAD_CONFIG {
+        public const int NAME = 32;
+
+        public ulong Affinity;
+        public GLOVE_THREAD_PRIORITY Priority;
+        [MarshalAsAttribute(UnmanagedType.ByValTStr, SizeConst = NAME)]
+        public string Name;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_THREAD_INFO {
+        public GLOVE_THREAD_ROLE Role;
+        public uint Id;
+        public ulong Affinity;
+        public GLOVE_THREAD_PRIORITY Priority;
+        public ulong CpuTime;
+        [MarshalAsAttribute(UnmanagedType.ByValTStr, SizeConst = GLOVE_THREAD_CONFIG.NAME)]
+        public string Name;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_MODEL_STATUS {
+        public GLOVE_MODEL_STATE State;
+        public uint Generation;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_INIT_OPTIONS {
+        public uint Features;
+        [MarshalAsAttribute(UnmanagedType.I1)]
+        public bool Preload;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_ADAPTER_CAPACITY {
+        public uint Connections;
+        public float Bandwidth;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GLOVE_ADAPTER_INFO {
+        public GLOVE_ADAPTER_CAPACITY Capacity;
+        public uint Gloves;
+        public float Demand;
+        public float Loss;
+        public float Load;
+        [MarshalAsAttribute(UnmanagedType.I1)]
+        public bool Saturated;
+        public uint Migrations;
+    }
+
 #pragma warning restore 0649
 
     public enum GLOVE_HAND {
@@ -147,6 +383,69 @@ public enum GLOVE_HAND {
         GLOVE_RIGHT,
     };
 
+    public enum GLOVE_PALETTE_FORMAT {
+        GLOVE_PALETTE_3X4 = 0,
+        GLOVE_PALETTE_4X4_ROWS,
+        GLOVE_PALETTE_4X4_COLUMNS,
+    };
+
+    public enum GLOVE_GESTURE_EVENT_TYPE {
+        GLOVE_GESTURE_BEGIN = 0,
+        GLOVE_GESTURE_END,
+    };
+
+    public enum GLOVE_STAGE {
+        GLOVE_STAGE_TRANSPORT = 0,
+        GLOVE_STAGE_DECODE,
+        GLOVE_STAGE_FILTER,
+        GLOVE_STAGE_SKELETON,
+        GLOVE_STAGE_PUBLISH,
+    };
+
+    public enum GLOVE_PLACEMENT {
+        GLOVE_PLACEMENT_INLINE = 0,
+        GLOVE_PLACEMENT_THREAD,
+        GLOVE_PLACEMENT_CALLER,
+        GLOVE_PLACEMENT_SKIP,
+    };
+
+    public enum GLOVE_RIG_SPACE {
+        GLOVE_RIG_LOCAL = 0,
+        GLOVE_RIG_GLOBAL,
+    };
+
+    public enum GLOVE_THREAD_ROLE {
+        GLOVE_THREAD_DEVICES = 0,
+        GLOVE_THREAD_BLUETOOTH,
+        GLOVE_THREAD_DECODE,
+        GLOVE_THREAD_FILTER,
+        GLOVE_THREAD_SKELETON,
+        GLOVE_THREAD_PUBLISH,
+        GLOVE_THREAD_RECORDER,
+        GLOVE_THREAD_STREAM,
+        GLOVE_THREAD_BROKER,
+        GLOVE_THREAD_LOADER,
+        GLOVE_THREAD_COMMANDS,
+    };
+
+    public enum GLOVE_MODEL_STATE {
+        GLOVE_MODEL_DEFAULT = 0,
+        GLOVE_MODEL_LOADING,
+        GLOVE_MODEL_LOADED,
+        GLOVE_MODEL_FAILED,
+    };
+
+    public enum GLOVE_THREAD_PRIORITY {
+        GLOVE_PRIORITY_DEFAULT = 0,
+        GLOVE_PRIORITY_IDLE,
+        GLOVE_PRIORITY_LOWEST,
+        GLOVE_PRIORITY_BELOW_NORMAL,
+        GLOVE_PRIORITY_NORMAL,
+        GLOVE_PRIORITY_ABOVE_NORMAL,
+        GLOVE_PRIORITY_HIGHEST,
+        GLOVE_PRIORITY_TIME_CRITICAL,
+    };
+
 
     /*!
     *   \brief Glove class
@@ -160,6 +459,18 @@ public class Glove {
         public const int OUT_OF_RANGE = 2;
         public const int DISCONNECTED = 3;
 
+        public const uint RING_DATA = 0x1;
+        public const uint RING_SKELETAL = 0x2;
+
+        public const uint GESTURE_NONE = 0xFFFFFFFF;
+
+        public const uint FEATURE_SKELETAL = 0x01;
+        public const uint FEATURE_FUSION = 0x02;
+        public const uint FEATURE_RECORDING = 0x04;
+        public const uint FEATURE_STREAMING = 0x08;
+        public const uint FEATURE_HOTPLUG = 0x10;
+        public const uint FEATURE_ALL = 0x1F;
+
         /*! \brief Initialize the Manus SDK.
         *
         *  Must be called before any other function
@@ -168,6 +479,16 @@ public class Glove {
         [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
         public static extern int ManusInit();
 
+        /*! \brief Initialize the Manus SDK with a selection of features.
+        *
+        *  The enabled features start the first time they are used, unless
+        *  they are preloaded.
+        *
+        *  \param options The options.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusInitEx(ref GLOVE_INIT_OPTIONS options);
+
         /*! \brief Shutdown the Manus SDK.
         *
         *  Must be called when the SDK is no longer
@@ -241,5 +562,670 @@ public class Glove {
         */
         [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
         public static extern int ManusSetVibration(GLOVE_HAND hand, float power);
+
+        /*! \brief Start streaming the gloves over the network.
+        *
+        *  \param address The unicast, loopback or multicast address to send the samples to.
+        *  \param port The UDP port to send the samples to.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusStreamStart(string address, ushort port);
+
+        /*! \brief Stop streaming the gloves over the network.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusStreamStop();
+
+        /*! \brief Start receiving gloves streamed by another machine.
+        *
+        *  \param address The multicast group to join or the local address to listen on.
+        *  \param port The UDP port the samples are sent to.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusStreamConnect(string address, ushort port);
+
+        /*! \brief Stop receiving gloves from the network.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusStreamDisconnect();
+
+        /*! \brief Get the state of a glove on the network.
+        *
+        *  \param hand The left or right hand index.
+        *  \param data Output variable to receive the data.
+        *  \param timeout Milliseconds to wait until the glove returns a value.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusStreamGetData(GLOVE_HAND hand, out GLOVE_DATA data, uint timeout = 0);
+
+        /*! \brief Get a skeletal model for a glove on the network.
+        *
+        *  \param hand The left or right hand index.
+        *  \param model The glove skeletal model.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusStreamGetSkeletal(GLOVE_HAND hand, out GLOVE_SKELETAL model, uint timeout = 1000);
+
+        /*! \brief Share the gloves of this process with other processes.
+        *
+        *  Must be called after ManusInit.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusBrokerStart();
+
+        /*! \brief Stop sharing the gloves with other processes.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusBrokerStop();
+
+        /*! \brief Initialize the Manus SDK as a client of a broker.
+        *
+        *  Use this instead of ManusInit in processes that don't own the gloves.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusBrokerAttach();
+
+        /*! \brief Read every sample published since the last call.
+        *
+        *  \param hand The left or right hand index.
+        *  \param cursor Position in the stream, initialize to zero and pass it back unchanged.
+        *  \param data Array to receive the samples.
+        *  \param count Size of the array.
+        *  \param read Output variable to receive the number of samples read.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusBrokerRead(GLOVE_HAND hand, ref uint cursor, [Out] GLOVE_DATA[] data, uint count, out uint read);
+
+        /*! \brief Record the raw reports of a glove to a file.
+        *
+        *  \param hand The left or right hand index.
+        *  \param path Path of the file to write, an existing file is overwritten.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusRecordStart(GLOVE_HAND hand, string path);
+
+        /*! \brief Stop recording a glove and close the file.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusRecordStop(GLOVE_HAND hand);
+
+        /*! \brief Get the finger calibration profile of a glove.
+        *
+        *  \param hand The left or right hand index.
+        *  \param profile Output variable to receive the profile.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetProfile(GLOVE_HAND hand, out GLOVE_PROFILE profile);
+
+        /*! \brief Set the finger calibration profile of a glove.
+        *
+        *  \param hand The left or right hand index.
+        *  \param profile The profile to apply to every sample.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusSetProfile(GLOVE_HAND hand, ref GLOVE_PROFILE profile);
+
+        /*! \brief Load a finger calibration profile from a file and set it on a glove.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusLoadProfile(GLOVE_HAND hand, string path);
+
+        /*! \brief Save the finger calibration profile of a glove to a file.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusSaveProfile(GLOVE_HAND hand, string path);
+
+        /*! \brief Get the filtered state of a glove.
+        *
+        *  \param hand The left or right hand index.
+        *  \param data Output variable to receive the data.
+        *  \param timeout Milliseconds to wait until the glove returns a value.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetFilteredData(GLOVE_HAND hand, out GLOVE_DATA data, uint timeout = 0);
+
+        /*! \brief Get the parameters of the adaptive filter of a glove.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetFilter(GLOVE_HAND hand, out GLOVE_FILTER filter);
+
+        /*! \brief Set the parameters of the adaptive filter of a glove.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusSetFilter(GLOVE_HAND hand, ref GLOVE_FILTER filter);
+
+        /*! \brief Get the current time of the SDK clock.
+        *
+        *  \param time Output variable to receive the time in microseconds.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetTime(out ulong time);
+
+        /*! \brief Get the data of both hands at a point in time.
+        *
+        *  \param time Time of the frame on the SDK clock, see ManusGetTime.
+        *  \param frame Output variable to receive the frame.
+        *  \param timeout Milliseconds to wait until every connected hand has a sample after the time.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetFrame(ulong time, out GLOVE_FRAME frame, uint timeout = 0);
+
+        /*! \brief Get the skeletal model as a palette of bone matrices.
+        *
+        *  \param hand The left or right hand index.
+        *  \param layout The layout of the palette.
+        *  \param palette Output buffer of 12 or 16 floats per bone depending on the format.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetPalette(GLOVE_HAND hand, ref GLOVE_PALETTE_LAYOUT layout, [Out] float[] palette, uint timeout = 0);
+
+        /*! \brief Let the SDK write every sample of a glove directly into a pinned buffer.
+        *
+        *  Use the GloveRing class instead of calling this directly.
+        *
+        *  \param hand The left or right hand index.
+        *  \param entries Pinned array of GLOVE_RING_ENTRY.
+        *  \param capacity Number of entries in the array.
+        *  \param counter Pinned ulong that receives the number of samples written.
+        *  \param contents Combination of RING_DATA and RING_SKELETAL.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusRegisterRing(GLOVE_HAND hand, IntPtr entries, uint capacity, IntPtr counter, uint contents);
+
+        /*! \brief Stop writing into the ring of a glove.
+        *
+        *  \param hand The left or right hand index.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusUnregisterRing(GLOVE_HAND hand);
+
+        /*! \brief Add a gesture template to a glove.
+        *
+        *  \param hand The left or right hand index.
+        *  \param gesture The template to add.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusAddGesture(GLOVE_HAND hand, ref GLOVE_GESTURE gesture);
+
+        /*! \brief Remove every template of a gesture.
+        *
+        *  \param hand The left or right hand index.
+        *  \param id Identifier of the gesture, or GESTURE_NONE to remove all gestures.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusRemoveGesture(GLOVE_HAND hand, uint id);
+
+        /*! \brief Get the gesture that is currently active.
+        *
+        *  \param hand The left or right hand index.
+        *  \param id Output variable to receive the identifier, GESTURE_NONE when no gesture is active.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetGesture(GLOVE_HAND hand, out uint id);
+
+        /*! \brief Take the oldest gesture event from the queue of a glove.
+        *
+        *  \param hand The left or right hand index.
+        *  \param gestureEvent Output variable to receive the event.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusPollGesture(GLOVE_HAND hand, out GLOVE_GESTURE_EVENT gestureEvent);
+
+        /*! \brief Get the configuration of the sample pipeline.
+        *
+        *  \param pipeline Output variable to receive the configuration.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetPipeline(out GLOVE_PIPELINE pipeline);
+
+        /*! \brief Configure the sample pipeline, must be called before ManusInit.
+        *
+        *  \param pipeline The configuration.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusSetPipeline(ref GLOVE_PIPELINE pipeline);
+
+        /*! \brief Run the stages placed on the caller thread.
+        *
+        *  \param processed Output variable to receive the number of packets processed.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusPumpPipeline(out uint processed);
+
+        /*! \brief Get the timing counters of a pipeline stage.
+        *
+        *  \param stage The pipeline stage.
+        *  \param stats Output variable to receive the counters.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetStageStats(GLOVE_STAGE stage, out GLOVE_STAGE_STATS stats);
+
+        /*! \brief Register a rig to retarget the skeletal model of a hand to, must be called after ManusInit.
+        *
+        *  \param hand The left or right hand index.
+        *  \param rig Description of the rig.
+        *  \param id Output variable to receive the identifier of the rig.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusRegisterRig(GLOVE_HAND hand, ref GLOVE_RIG rig, out uint id);
+
+        /*! \brief Remove a rig registered with ManusRegisterRig.
+        *
+        *  \param id The identifier of the rig.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusUnregisterRig(uint id);
+
+        /*! \brief Get the skeletal model of the hand of a rig as poses of the rig.
+        *
+        *  \param id The identifier of the rig.
+        *  \param poses Output buffer of one pose per bone of the rig.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetRigPose(uint id, [Out] GLOVE_POSE[] poses, uint timeout = 0);
+
+        /*! \brief Start a host-side calibration of the accelerometer.
+        *
+        *  \param hand The left or right hand index.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusStartImuCalibration(GLOVE_HAND hand);
+
+        /*! \brief Get the progress of the calibration and the fit so far.
+        *
+        *  \param hand The left or right hand index.
+        *  \param status Output variable to receive the progress.
+        *  \param fit Output variable to receive the fit, only written when there is one.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetImuCalibrationStatus(GLOVE_HAND hand, out GLOVE_IMU_CALIBRATION_STATUS status, ref GLOVE_IMU_CALIBRATION fit);
+
+        /*! \brief Stop the calibration of the accelerometer.
+        *
+        *  \param hand The left or right hand index.
+        *  \param apply Apply the fit to the acceleration.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusStopImuCalibration(GLOVE_HAND hand, bool apply);
+
+        /*! \brief Get the correction applied to the accelerometer.
+        *
+        *  \param hand The left or right hand index.
+        *  \param calibration Output variable to receive the correction.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetImuCalibration(GLOVE_HAND hand, out GLOVE_IMU_CALIBRATION calibration);
+
+        /*! \brief Set the correction applied to the accelerometer.
+        *
+        *  \param hand The left or right hand index.
+        *  \param calibration The correction.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusSetImuCalibration(GLOVE_HAND hand, ref GLOVE_IMU_CALIBRATION calibration);
+
+        /*! \brief Get the quality of the Bluetooth link of a glove.
+        *
+        *  \param hand The left or right hand index.
+        *  \param stats Output variable to receive the statistics.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetLinkStats(GLOVE_HAND hand, out GLOVE_LINK_STATS stats);
+
+        /*! \brief Get the parameters of the palm position tracking of a glove.
+        *
+        *  \param hand The left or right hand index.
+        *  \param tracking Output variable to receive the parameters.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetPalmTracking(GLOVE_HAND hand, out GLOVE_PALM_TRACKING tracking);
+
+        /*! \brief Set the parameters of the palm position tracking of a glove.
+        *
+        *  \param hand The left or right hand index.
+        *  \param tracking The parameters.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusSetPalmTracking(GLOVE_HAND hand, ref GLOVE_PALM_TRACKING tracking);
+
+        /*! \brief Get the position of the palm in meters.
+        *
+        *  \param hand The left or right hand index.
+        *  \param position Output variable to receive the position.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetPalmPosition(GLOVE_HAND hand, out GLOVE_VECTOR position);
+
+        /*! \brief Move the palm back to the origin.
+        *
+        *  \param hand The left or right hand index.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusResetPalmPosition(GLOVE_HAND hand);
+
+        /*! \brief Get the configuration of the external tracker of a glove.
+        *
+        *  \param hand The left or right hand index.
+        *  \param tracker Output variable to receive the configuration.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetTracker(GLOVE_HAND hand, out GLOVE_TRACKER tracker);
+
+        /*! \brief Set the configuration of the external tracker of a glove.
+        *
+        *  \param hand The left or right hand index.
+        *  \param tracker The configuration.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusSetTracker(GLOVE_HAND hand, ref GLOVE_TRACKER tracker);
+
+        /*! \brief Push a pose of the external tracker on the wrist.
+        *
+        *  \param hand The left or right hand index.
+        *  \param time Time the pose was measured on the SDK clock.
+        *  \param pose The pose of the tracker in the world.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusPushTrackerPose(GLOVE_HAND hand, ulong time, ref GLOVE_POSE pose);
+
+        /*! \brief Get the skeletal model of a glove in the world of the tracker.
+        *
+        *  \param hand The left or right hand index.
+        *  \param model The glove skeletal model.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetWorldSkeletal(GLOVE_HAND hand, out GLOVE_SKELETAL model, uint timeout = 1000);
+
+        /*! \brief Get the configuration of the threads with a role.
+        *
+        *  \param role The role of the threads.
+        *  \param config Output variable to receive the configuration.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetThreadConfig(GLOVE_THREAD_ROLE role, out GLOVE_THREAD_CONFIG config);
+
+        /*! \brief Set the configuration of the threads with a role.
+        *
+        *  \param role The role of the threads.
+        *  \param config The configuration.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusSetThreadConfig(GLOVE_THREAD_ROLE role, ref GLOVE_THREAD_CONFIG config);
+
+        /*! \brief Get the threads the SDK runs its work on.
+        *
+        *  \param threads Array to receive the threads.
+        *  \param count Size of the array.
+        *  \param total Output variable to receive the number of threads.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetThreads([Out] GLOVE_THREAD_INFO[] threads, uint count, out uint total);
+
+        /*! \brief Load a hand model from a file in the background.
+        *
+        *  \param hand The left or right hand index.
+        *  \param path Path of the hand model.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusLoadHandModel(GLOVE_HAND hand, string path);
+
+        /*! \brief Load a hand model from an FBX file in memory in the background.
+        *
+        *  \param hand The left or right hand index.
+        *  \param data Contents of the FBX file.
+        *  \param size Size of the contents in bytes.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusLoadHandModelFromMemory(GLOVE_HAND hand, byte[] data, uint size);
+
+        /*! \brief Switch back to the embedded hand model.
+        *
+        *  \param hand The left or right hand index.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusResetHandModel(GLOVE_HAND hand);
+
+        /*! \brief Get the status of the hand model of a glove.
+        *
+        *  \param hand The left or right hand index.
+        *  \param status Output variable to receive the status.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetHandModelStatus(GLOVE_HAND hand, out GLOVE_MODEL_STATUS status);
+
+        /*! \brief Called with every new sample of a glove, on the thread that publishes the samples.
+        *
+        *  \param sample Pointer to a GLOVE_RING_ENTRY, only valid during the call.
+        */
+        [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+        public delegate void SampleCallback(GLOVE_HAND hand, IntPtr sample, IntPtr context);
+
+        /*! \brief Called when an asynchronous command is done.
+        *
+        *  \param result The value the synchronous function would have returned.
+        */
+        [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+        public delegate void CompletionCallback(int result, IntPtr context);
+
+        /*! \brief Register a callback that is called with every new sample of a glove.
+        *
+        *  The delegate must be kept alive until it is unregistered.
+        *
+        *  \param hand The left or right hand index.
+        *  \param callback The function to call.
+        *  \param context Passed to the callback unchanged.
+        *  \param contents Combination of RING_DATA and RING_SKELETAL.
+        *  \param id Output variable to receive the identifier of the callback.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusRegisterSampleCallback(GLOVE_HAND hand, SampleCallback callback, IntPtr context,
+            uint contents, out uint id);
+
+        /*! \brief Unregister a sample callback.
+        *
+        *  \param id The identifier of the callback.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusUnregisterSampleCallback(uint id);
+
+        /*! \brief Set the output power of the vibration motor without waiting for the glove.
+        *
+        *  \param hand The left or right hand index.
+        *  \param power The power of the vibration motor ranging from 0 to 1.
+        *  \param callback Called on a background thread when the glove was written, may be null.
+        *  \param context Passed to the callback unchanged.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusSetVibrationAsync(GLOVE_HAND hand, float power,
+            CompletionCallback callback = null, IntPtr context = default(IntPtr));
+
+        /*! \brief Calibrate the IMU on the glove without waiting for the glove.
+        *
+        *  \param hand The left or right hand index.
+        *  \param callback Called on a background thread when the glove was written, may be null.
+        *  \param context Passed to the callback unchanged.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusCalibrateAsync(GLOVE_HAND hand, bool gyro, bool accel, bool fingers,
+            CompletionCallback callback = null, IntPtr context = default(IntPtr));
+
+        /*! \brief Enable or disable recording trace events.
+        *
+        *  \param enabled True to record trace events.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusSetTracing(bool enabled);
+
+        /*! \brief Leave the events recorded so far out of the next trace that is written. */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusClearTrace();
+
+        /*! \brief Write the recorded trace events to a file in the Chrome trace event format.
+        *
+        *  \param path Path of the file to write.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusWriteTrace(string path);
+
+        /*! \brief Keep the poses of a glove for looking them up later.
+        *
+        *  \param hand The left or right hand index.
+        *  \param retention Milliseconds of samples to keep up to a minute, zero to stop keeping them.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusSetHistory(GLOVE_HAND hand, uint retention);
+
+        /*! \brief Get the time span covered by the history of a glove.
+        *
+        *  \param hand The left or right hand index.
+        *  \param oldest Output variable to receive the time of the oldest sample.
+        *  \param newest Output variable to receive the time of the newest sample.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetHistoryRange(GLOVE_HAND hand, out ulong oldest, out ulong newest);
+
+        /*! \brief Get the state of a glove at a point in the past.
+        *
+        *  \param hand The left or right hand index.
+        *  \param time Time on the SDK clock, see ManusGetTime.
+        *  \param data Output variable to receive the data.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetDataAt(GLOVE_HAND hand, ulong time, out GLOVE_DATA data);
+
+        /*! \brief Get the skeletal model of a glove at a point in the past.
+        *
+        *  \param hand The left or right hand index.
+        *  \param time Time on the SDK clock, see ManusGetTime.
+        *  \param model Output variable to receive the skeletal model.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetSkeletalAt(GLOVE_HAND hand, ulong time, out GLOVE_SKELETAL model);
+
+        /*! \brief Get the Bluetooth adapters the gloves are connected through.
+        *
+        *  A glove that is paired with several adapters is connected through
+        *  one of them, chosen by the load of the adapters. While the SDK runs,
+        *  a glove is moved to another adapter when its adapter saturates.
+        *
+        *  \param adapters Array to receive the adapters.
+        *  \param count Size of the array.
+        *  \param total Output variable to receive the number of adapters, which may exceed the size of the array.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusGetAdapters([Out] GLOVE_ADAPTER_INFO[] adapters, uint count, out uint total);
+
+        /*! \brief Set the capacity of a Bluetooth adapter.
+        *
+        *  \param adapter Index of the adapter as returned by ManusGetAdapters.
+        *  \param capacity The capacity.
+        */
+        [DllImport("Manus.dll", CallingConvention = CallingConvention.Cdecl)]
+        public static extern int ManusSetAdapterCapacity(uint adapter, ref GLOVE_ADAPTER_CAPACITY capacity);
+    }
+
+    /*!
+    *   \brief Ring of samples written by the SDK into pinned managed memory.
+    *
+    *   The buffers are pinned and registered once, after which reading a
+    *   sample is a plain copy of a blittable struct without any call into
+    *   the SDK, marshalling or allocation.
+    */
+    public class GloveRing : IDisposable {
+        private GLOVE_RING_ENTRY[] m_entries;
+        private ulong[] m_counter;
+        private GCHandle m_entries_handle;
+        private GCHandle m_counter_handle;
+        private GLOVE_HAND m_hand;
+        private ulong m_read;
+
+        public GloveRing(GLOVE_HAND hand, int capacity, uint contents = Glove.RING_DATA | Glove.RING_SKELETAL) {
+            m_hand = hand;
+            m_entries = new GLOVE_RING_ENTRY[capacity];
+            m_counter = new ulong[1];
+            m_entries_handle = GCHandle.Alloc(m_entries, GCHandleType.Pinned);
+            m_counter_handle = GCHandle.Alloc(m_counter, GCHandleType.Pinned);
+
+            int ret = Glove.ManusRegisterRing(hand, m_entries_handle.AddrOfPinnedObject(), (uint)capacity,
+                m_counter_handle.AddrOfPinnedObject(), contents);
+            if (ret != Glove.SUCCESS) {
+                Release();
+                throw new ArgumentException("Failed to register the ring: " + ret);
+            }
+        }
+
+        ~GloveRing() {
+            Dispose();
+        }
+
+        public void Dispose() {
+            if (m_entries == null)
+                return;
+
+            // The SDK stops writing before it returns, only then can the buffers be unpinned
+            Glove.ManusUnregisterRing(m_hand);
+            Release();
+            GC.SuppressFinalize(this);
+        }
+
+        private void Release() {
+            m_counter_handle.Free();
+            m_entries_handle.Free();
+            m_entries = null;
+        }
+
+        /*! Number of samples written by the SDK so far. */
+        public ulong Count {
+            get { return Thread.VolatileRead(ref m_counter[0]); }
+        }
+
+        /*! \brief Copy a sample by its number, counting from 1.
+        *
+        *  \return False if the sample was not written yet or was overwritten.
+        */
+        public bool TryGet(ulong number, out GLOVE_RING_ENTRY entry) {
+            int index = (int)((number - 1) % (ulong)m_entries.Length);
+            ulong sequence = number * 2;
+
+            if (number == 0 || Thread.VolatileRead(ref m_entries[index].Sequence) != sequence) {
+                entry = new GLOVE_RING_ENTRY();
+                return false;
+            }
+
+            entry = m_entries[index];
+            Thread.MemoryBarrier();
+            return Thread.VolatileRead(ref m_entries[index].Sequence) == sequence;
+        }
+
+        /*! Copy the newest sample. */
+        public bool TryGetNewest(out GLOVE_RING_ENTRY entry) {
+            return TryGet(Count, out entry);
+        }
+
+        /*! \brief Copy the samples that arrived since the last call.
+        *
+        *  Samples that were overwritten before they could be read are skipped.
+        *
+        *  \return The number of samples copied into the output.
+        */
+        public int ReadNew(GLOVE_RING_ENTRY[] output) {
+            ulong count = Count;
+            ulong first = m_read + 1;
+
+            // Only the last capacity samples can still be in the ring
+            if (count - m_read > (ulong)output.Length)
+                first = count - (ulong)output.Length + 1;
+            if (count - first + 1 > (ulong)m_entries.Length)
+                first = count - (ulong)m_entries.Length + 1;
+
+            int copied = 0;
+            for (ulong number = first; number <= count; number++) {
+                if (TryGet(number, out output[copied]))
+                    copied++;
+            }
+
+            m_read = count;
+            return copied;
+        }
     }
 }
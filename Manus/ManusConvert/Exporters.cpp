@@ -0,0 +1,507 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "Exporters.h"
+#include "ManusMath.h"
+
+#include <math.h>
+#include <stdarg.h>
+#include <string.h>
+
+#define PI 3.14159265358979
+
+// The skeletal model viewed as an array of poses, see GLOVE_BONES
+static const char* g_bone_names[GLOVE_BONES] = {
+	"palm",
+	"thumb_metacarpal", "thumb_proximal", "thumb_distal",
+	"index_metacarpal", "index_proximal", "index_intermediate", "index_distal",
+	"middle_metacarpal", "middle_proximal", "middle_intermediate", "middle_distal",
+	"ring_metacarpal", "ring_proximal", "ring_intermediate", "ring_distal",
+	"pinky_metacarpal", "pinky_proximal", "pinky_intermediate", "pinky_distal",
+};
+
+// Parent of every bone, the bones are in depth-first order of the hierarchy
+static const int g_bone_parents[GLOVE_BONES] = {
+	-1,
+	0, 1, 2,
+	0, 4, 5, 6,
+	0, 8, 9, 10,
+	0, 12, 13, 14,
+	0, 16, 17, 18,
+};
+
+static bool IsLeaf(int bone)
+{
+	return bone + 1 == GLOVE_BONES || g_bone_parents[bone + 1] != bone;
+}
+
+static void Append(std::string& out, const char* format, ...)
+{
+	char buffer[256];
+
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+
+	if (length > 0)
+		out.append(buffer, length < (int)sizeof(buffer) ? length : sizeof(buffer) - 1);
+}
+
+static GLOVE_QUATERNION Conjugate(const GLOVE_QUATERNION& q)
+{
+	GLOVE_QUATERNION result = { q.w, -q.x, -q.y, -q.z };
+	return result;
+}
+
+static GLOVE_VECTOR Rotate(const GLOVE_QUATERNION& q, const GLOVE_VECTOR& v)
+{
+	GLOVE_QUATERNION p = { 0.0f, v.x, v.y, v.z };
+	GLOVE_QUATERNION r = ManusMath::QuaternionMultiply(ManusMath::QuaternionMultiply(q, p), Conjugate(q));
+	GLOVE_VECTOR result = { r.x, r.y, r.z };
+	return result;
+}
+
+/*! Convert the global poses of the model to poses relative to the parent bone. */
+static void GetLocalPoses(const GLOVE_SKELETAL& model, GLOVE_POSE* local)
+{
+	const GLOVE_POSE* global = (const GLOVE_POSE*)&model;
+
+	for (int i = 0; i < GLOVE_BONES; i++)
+	{
+		int parent = g_bone_parents[i];
+		if (parent < 0)
+		{
+			local[i] = global[i];
+			continue;
+		}
+
+		GLOVE_QUATERNION inverse = Conjugate(global[parent].orientation);
+		GLOVE_VECTOR offset = {
+			global[i].position.x - global[parent].position.x,
+			global[i].position.y - global[parent].position.y,
+			global[i].position.z - global[parent].position.z,
+		};
+
+		local[i].orientation = ManusMath::QuaternionMultiply(inverse, global[i].orientation);
+		local[i].position = Rotate(inverse, offset);
+	}
+}
+
+/*
+ * Comma separated values with the fingers and the global pose of every bone.
+ */
+class CsvExporter : public Exporter
+{
+private:
+	FILE* m_file;
+
+public:
+	CsvExporter() : m_file(nullptr) {}
+	~CsvExporter() { if (m_file) fclose(m_file); }
+
+	bool Begin(const char* path, GLOVE_HAND hand, const FRAME& first) override
+	{
+		m_file = fopen(path, "wb");
+		if (!m_file)
+			return false;
+
+		m_origin = first.timestamp;
+
+		std::string header = "time";
+		for (int i = 0; i < 5; i++)
+			Append(header, ",finger%d", i);
+		for (int i = 0; i < GLOVE_BONES; i++)
+		{
+			const char* name = g_bone_names[i];
+			Append(header, ",%s_qw,%s_qx,%s_qy,%s_qz,%s_x,%s_y,%s_z", name, name, name, name, name, name, name);
+		}
+		header += "\n";
+
+		return fwrite(header.data(), 1, header.size(), m_file) == header.size();
+	}
+
+	void Format(const FRAME* frames, size_t count, std::vector<std::string>& streams) const override
+	{
+		std::string& out = streams[0];
+
+		for (size_t k = 0; k < count; k++)
+		{
+			const FRAME& frame = frames[k];
+			const GLOVE_POSE* poses = (const GLOVE_POSE*)&frame.model;
+
+			Append(out, "%.6f", (frame.timestamp - m_origin) / 1000000.0);
+			for (int i = 0; i < 5; i++)
+				Append(out, ",%.5f", frame.data.Fingers[i]);
+			for (int i = 0; i < GLOVE_BONES; i++)
+			{
+				const GLOVE_POSE& pose = poses[i];
+				Append(out, ",%.6f,%.6f,%.6f,%.6f,%.4f,%.4f,%.4f",
+					pose.orientation.w, pose.orientation.x, pose.orientation.y, pose.orientation.z,
+					pose.position.x, pose.position.y, pose.position.z);
+			}
+			out += "\n";
+		}
+	}
+
+	bool Write(const std::vector<std::string>& streams) override
+	{
+		return fwrite(streams[0].data(), 1, streams[0].size(), m_file) == streams[0].size();
+	}
+
+	bool End(uint64_t last, size_t count) override
+	{
+		bool result = fclose(m_file) == 0;
+		m_file = nullptr;
+		return result;
+	}
+};
+
+/*
+ * Biovision hierarchy with the palm as root, positions in millimeters.
+ *
+ * The frame count and frame time are only known at the end, so the header
+ * reserves fixed-width fields that are filled in once all frames are written.
+ */
+class BvhExporter : public Exporter
+{
+private:
+	FILE* m_file;
+	long m_frames_offset;
+	long m_time_offset;
+
+public:
+	BvhExporter() : m_file(nullptr), m_frames_offset(0), m_time_offset(0) {}
+	~BvhExporter() { if (m_file) fclose(m_file); }
+
+	bool Begin(const char* path, GLOVE_HAND hand, const FRAME& first) override
+	{
+		m_file = fopen(path, "wb");
+		if (!m_file)
+			return false;
+
+		m_origin = first.timestamp;
+
+		// The bone lengths don't change, so any frame gives the offsets
+		GLOVE_POSE local[GLOVE_BONES];
+		GetLocalPoses(first.model, local);
+
+		std::string header = "HIERARCHY\n";
+		int depth = 0;
+		for (int i = 0; i < GLOVE_BONES; i++)
+		{
+			// Close the joints down to the depth of the parent
+			int parent_depth = 0;
+			for (int p = g_bone_parents[i]; p >= 0; p = g_bone_parents[p])
+				parent_depth++;
+			for (; depth > parent_depth; depth--)
+				header += std::string(depth - 1, '\t') + "}\n";
+
+			std::string indent(depth, '\t');
+			if (i == 0)
+				Append(header, "ROOT %s\n", g_bone_names[i]);
+			else
+				Append(header, "%sJOINT %s\n", indent.c_str(), g_bone_names[i]);
+			header += indent + "{\n";
+			Append(header, "%s\tOFFSET %.4f %.4f %.4f\n", indent.c_str(), local[i].position.x, local[i].position.y, local[i].position.z);
+			if (i == 0)
+				Append(header, "%s\tCHANNELS 6 Xposition Yposition Zposition Zrotation Xrotation Yrotation\n", indent.c_str());
+			else
+				Append(header, "%s\tCHANNELS 3 Zrotation Xrotation Yrotation\n", indent.c_str());
+
+			// The tip isn't part of the model, extend the last bone by its own length
+			if (IsLeaf(i))
+			{
+				Append(header, "%s\tEnd Site\n%s\t{\n", indent.c_str(), indent.c_str());
+				Append(header, "%s\t\tOFFSET %.4f %.4f %.4f\n", indent.c_str(), local[i].position.x, local[i].position.y, local[i].position.z);
+				Append(header, "%s\t}\n", indent.c_str());
+			}
+
+			depth++;
+		}
+		for (; depth > 0; depth--)
+			header += std::string(depth - 1, '\t') + "}\n";
+
+		header += "MOTION\nFrames: ";
+		if (fwrite(header.data(), 1, header.size(), m_file) != header.size())
+			return false;
+
+		m_frames_offset = ftell(m_file);
+		fprintf(m_file, "%10u\nFrame Time: ", 0);
+		m_time_offset = ftell(m_file);
+		fprintf(m_file, "%12.8f\n", 0.0);
+
+		return true;
+	}
+
+	void Format(const FRAME* frames, size_t count, std::vector<std::string>& streams) const override
+	{
+		std::string& out = streams[0];
+
+		for (size_t k = 0; k < count; k++)
+		{
+			GLOVE_POSE local[GLOVE_BONES];
+			GetLocalPoses(frames[k].model, local);
+
+			const GLOVE_VECTOR& root = local[0].position;
+			Append(out, "%.4f %.4f %.4f", root.x, root.y, root.z);
+
+			for (int i = 0; i < GLOVE_BONES; i++)
+			{
+				// Rotation matrix of the quaternion, decomposed as Z * X * Y
+				const GLOVE_QUATERNION& q = local[i].orientation;
+				double r01 = 2.0 * (q.x * q.y - q.w * q.z);
+				double r11 = 1.0 - 2.0 * (q.x * q.x + q.z * q.z);
+				double r20 = 2.0 * (q.x * q.z - q.w * q.y);
+				double r21 = 2.0 * (q.y * q.z + q.w * q.x);
+				double r22 = 1.0 - 2.0 * (q.x * q.x + q.y * q.y);
+
+				double x = asin(r21 > 1.0 ? 1.0 : (r21 < -1.0 ? -1.0 : r21));
+				double z = atan2(-r01, r11);
+				double y = atan2(-r20, r22);
+
+				Append(out, " %.4f %.4f %.4f", z * 180.0 / PI, x * 180.0 / PI, y * 180.0 / PI);
+			}
+			out += "\n";
+		}
+	}
+
+	bool Write(const std::vector<std::string>& streams) override
+	{
+		return fwrite(streams[0].data(), 1, streams[0].size(), m_file) == streams[0].size();
+	}
+
+	bool End(uint64_t last, size_t count) override
+	{
+		// BVH has a fixed frame rate, use the average interval of the recording
+		double frame_time = count > 1 ? (last - m_origin) / 1000000.0 / (count - 1) : 0.0;
+
+		fseek(m_file, m_frames_offset, SEEK_SET);
+		fprintf(m_file, "%10u", (unsigned int)count);
+		fseek(m_file, m_time_offset, SEEK_SET);
+		fprintf(m_file, "%12.8f", frame_time);
+
+		bool result = fclose(m_file) == 0;
+		m_file = nullptr;
+		return result;
+	}
+};
+
+/*
+ * glTF 2.0 with one node per bone and a rotation channel for every node.
+ *
+ * Animation accessors must be tightly packed, so the times and the rotations
+ * of every bone are streamed to separate temporary files. The binary buffer
+ * is assembled from those files at the end and the JSON is written last.
+ */
+class GltfExporter : public Exporter
+{
+private:
+	std::string m_path;
+	std::string m_buffer_path;
+	std::vector<FILE*> m_parts;
+	GLOVE_POSE m_rest[GLOVE_BONES];
+
+	std::string GetPartPath(size_t index) const
+	{
+		char suffix[32];
+		snprintf(suffix, sizeof(suffix), ".part%u", (unsigned int)index);
+		return m_buffer_path + suffix;
+	}
+
+public:
+	~GltfExporter()
+	{
+		for (size_t i = 0; i < m_parts.size(); i++)
+		{
+			if (m_parts[i])
+				fclose(m_parts[i]);
+			remove(GetPartPath(i).c_str());
+		}
+	}
+
+	// The times followed by the rotations of every bone
+	size_t GetStreamCount() const override { return 1 + GLOVE_BONES; }
+
+	bool Begin(const char* path, GLOVE_HAND hand, const FRAME& first) override
+	{
+		m_origin = first.timestamp;
+		GetLocalPoses(first.model, m_rest);
+
+		m_path = path;
+		size_t extension = m_path.rfind(".gltf");
+		m_buffer_path = (extension != std::string::npos ? m_path.substr(0, extension) : m_path) + ".bin";
+
+		for (size_t i = 0; i < GetStreamCount(); i++)
+		{
+			FILE* part = fopen(GetPartPath(i).c_str(), "w+b");
+			m_parts.push_back(part);
+			if (!part)
+				return false;
+		}
+
+		return true;
+	}
+
+	void Format(const FRAME* frames, size_t count, std::vector<std::string>& streams) const override
+	{
+		for (size_t k = 0; k < count; k++)
+		{
+			float time = (float)((frames[k].timestamp - m_origin) / 1000000.0);
+			streams[0].append((const char*)&time, sizeof(time));
+
+			GLOVE_POSE local[GLOVE_BONES];
+			GetLocalPoses(frames[k].model, local);
+
+			// glTF stores quaternions as x, y, z, w
+			for (int i = 0; i < GLOVE_BONES; i++)
+			{
+				const GLOVE_QUATERNION& q = local[i].orientation;
+				float rotation[4] = { q.x, q.y, q.z, q.w };
+				streams[1 + i].append((const char*)rotation, sizeof(rotation));
+			}
+		}
+	}
+
+	bool Write(const std::vector<std::string>& streams) override
+	{
+		for (size_t i = 0; i < streams.size(); i++)
+		{
+			if (fwrite(streams[i].data(), 1, streams[i].size(), m_parts[i]) != streams[i].size())
+				return false;
+		}
+
+		return true;
+	}
+
+	bool End(uint64_t last, size_t count) override
+	{
+		FILE* buffer = fopen(m_buffer_path.c_str(), "wb");
+		if (!buffer)
+			return false;
+
+		// Concatenate the parts into the buffer
+		std::vector<uint64_t> offsets;
+		std::vector<uint64_t> lengths;
+		uint64_t offset = 0;
+		std::vector<char> copy(1 << 16);
+		for (size_t i = 0; i < m_parts.size(); i++)
+		{
+			uint64_t length = 0;
+			rewind(m_parts[i]);
+			size_t read;
+			while ((read = fread(copy.data(), 1, copy.size(), m_parts[i])) > 0)
+			{
+				if (fwrite(copy.data(), 1, read, buffer) != read)
+				{
+					fclose(buffer);
+					return false;
+				}
+				length += read;
+			}
+
+			offsets.push_back(offset);
+			lengths.push_back(length);
+			offset += length;
+		}
+
+		if (fclose(buffer) != 0)
+			return false;
+
+		FILE* file = fopen(m_path.c_str(), "wb");
+		if (!file)
+			return false;
+
+		size_t slash = m_buffer_path.find_last_of("/\\");
+		std::string uri = slash != std::string::npos ? m_buffer_path.substr(slash + 1) : m_buffer_path;
+
+		std::string json = "{\n\t\"asset\": { \"version\": \"2.0\", \"generator\": \"ManusConvert\" },\n";
+		json += "\t\"scene\": 0,\n\t\"scenes\": [ { \"nodes\": [ 0 ] } ],\n\t\"nodes\": [\n";
+		for (int i = 0; i < GLOVE_BONES; i++)
+		{
+			const GLOVE_POSE& rest = m_rest[i];
+			Append(json, "\t\t{ \"name\": \"%s\", \"translation\": [ %.4f, %.4f, %.4f ], \"rotation\": [ %.6f, %.6f, %.6f, %.6f ]",
+				g_bone_names[i], rest.position.x, rest.position.y, rest.position.z,
+				rest.orientation.x, rest.orientation.y, rest.orientation.z, rest.orientation.w);
+
+			std::string children;
+			for (int j = i + 1; j < GLOVE_BONES; j++)
+			{
+				if (g_bone_parents[j] == i)
+					Append(children, "%s%d", children.empty() ? "" : ", ", j);
+			}
+			if (!children.empty())
+				json += ", \"children\": [ " + children + " ]";
+
+			json += i + 1 < GLOVE_BONES ? " },\n" : " }\n";
+		}
+		json += "\t],\n";
+
+		Append(json, "\t\"buffers\": [ { \"uri\": \"%s\", \"byteLength\": %llu } ],\n", uri.c_str(), (unsigned long long)offset);
+
+		json += "\t\"bufferViews\": [\n";
+		for (size_t i = 0; i < m_parts.size(); i++)
+		{
+			Append(json, "\t\t{ \"buffer\": 0, \"byteOffset\": %llu, \"byteLength\": %llu }%s\n",
+				(unsigned long long)offsets[i], (unsigned long long)lengths[i], i + 1 < m_parts.size() ? "," : "");
+		}
+		json += "\t],\n";
+
+		float end = (float)((last - m_origin) / 1000000.0);
+		json += "\t\"accessors\": [\n";
+		Append(json, "\t\t{ \"bufferView\": 0, \"componentType\": 5126, \"count\": %u, \"type\": \"SCALAR\", \"min\": [ 0.0 ], \"max\": [ %.6f ] },\n",
+			(unsigned int)count, end);
+		for (int i = 0; i < GLOVE_BONES; i++)
+		{
+			Append(json, "\t\t{ \"bufferView\": %d, \"componentType\": 5126, \"count\": %u, \"type\": \"VEC4\" }%s\n",
+				1 + i, (unsigned int)count, i + 1 < GLOVE_BONES ? "," : "");
+		}
+		json += "\t],\n";
+
+		json += "\t\"animations\": [ {\n\t\t\"name\": \"glove\",\n\t\t\"samplers\": [\n";
+		for (int i = 0; i < GLOVE_BONES; i++)
+		{
+			Append(json, "\t\t\t{ \"input\": 0, \"output\": %d, \"interpolation\": \"LINEAR\" }%s\n",
+				1 + i, i + 1 < GLOVE_BONES ? "," : "");
+		}
+		json += "\t\t],\n\t\t\"channels\": [\n";
+		for (int i = 0; i < GLOVE_BONES; i++)
+		{
+			Append(json, "\t\t\t{ \"sampler\": %d, \"target\": { \"node\": %d, \"path\": \"rotation\" } }%s\n",
+				i, i, i + 1 < GLOVE_BONES ? "," : "");
+		}
+		json += "\t\t]\n\t} ]\n}\n";
+
+		bool result = fwrite(json.data(), 1, json.size(), file) == json.size();
+		return fclose(file) == 0 && result;
+	}
+};
+
+Exporter* Exporter::Create(const char* format)
+{
+	if (strcmp(format, "csv") == 0)
+		return new CsvExporter();
+	if (strcmp(format, "bvh") == 0)
+		return new BvhExporter();
+	if (strcmp(format, "gltf") == 0)
+		return new GltfExporter();
+
+	return nullptr;
+}
@@ -0,0 +1,83 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Manus.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/*! A sample converted to glove data and a skeletal model. */
+typedef struct
+{
+	uint64_t timestamp;
+	GLOVE_DATA data;
+	GLOVE_SKELETAL model;
+} FRAME;
+
+/*
+ * Writes the converted frames of a recording in an animation format.
+ *
+ * Frames are converted in chunks on several threads. Format is called on
+ * those threads and turns a chunk into one or more streams of bytes. Write
+ * then appends the streams of each chunk to the output in order, so only
+ * the chunks in flight are ever kept in memory.
+ */
+class Exporter
+{
+protected:
+	// Time of the first frame, the output starts at zero
+	uint64_t m_origin;
+
+public:
+	Exporter() : m_origin(0) {}
+	virtual ~Exporter() {}
+
+	/*! \brief Create the exporter for a format.
+	*
+	*  \param format One of "bvh", "csv" or "gltf".
+	*  \return The exporter, or nullptr for an unknown format.
+	*/
+	static Exporter* Create(const char* format);
+
+	/*! Number of streams Format fills for every chunk. */
+	virtual size_t GetStreamCount() const { return 1; }
+
+	/*! \brief Open the output and write the header.
+	*
+	*  \param first The first frame, which gives the origin of the time and the rest pose.
+	*/
+	virtual bool Begin(const char* path, GLOVE_HAND hand, const FRAME& first) = 0;
+
+	/*! Format a chunk of frames, may be called from several threads at once. */
+	virtual void Format(const FRAME* frames, size_t count, std::vector<std::string>& streams) const = 0;
+
+	/*! Append the streams of the next chunk to the output. */
+	virtual bool Write(const std::vector<std::string>& streams) = 0;
+
+	/*! \brief Finish the output.
+	*
+	*  \param last Timestamp of the last frame.
+	*  \param count Total number of frames.
+	*/
+	virtual bool End(uint64_t last, size_t count) = 0;
+};
@@ -0,0 +1,247 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Converts recordings made by ManusRecordStart to animation files.
+ *
+ * The SDK sources are compiled into this executable, so every report goes
+ * through the same decoder and skeletal model as a live glove. The blocks of
+ * the recording are converted in chunks on all cores and written in order as
+ * they complete, so memory use doesn't depend on the length of the session.
+ *
+ * Usage: ManusConvert [--format bvh|csv|gltf] [--threads n] [--profile file] input output
+ *
+ * Without --format the format is taken from the extension of the output.
+ */
+
+#include "stdafx.h"
+#include "Manus.h"
+#include "SkeletalModel.h"
+#include "FingerProfile.h"
+#include "RecordingWalker.h"
+#include "Exporters.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*! The animation data of a chunk, ready to be written. */
+typedef struct
+{
+	std::vector<std::string> streams;
+	uint64_t last;
+	size_t count;
+} CONVERTED;
+
+/*
+ * Runs the skeletal model over the samples of a recording and formats them.
+ */
+class Converter : public RecordingWalker<CONVERTED>
+{
+private:
+	Exporter* m_exporter;
+	const char* m_path;
+	GLOVE_HAND m_hand;
+
+	// One model per thread, they are not shared
+	std::vector<std::unique_ptr<SkeletalModel>> m_models;
+
+	bool m_begun;
+	bool m_reported;
+	size_t m_total;
+	uint64_t m_last;
+
+public:
+	Converter(Exporter* exporter, const char* path, GLOVE_HAND hand, unsigned int threads)
+		: RecordingWalker<CONVERTED>(threads)
+		, m_exporter(exporter)
+		, m_path(path)
+		, m_hand(hand)
+		, m_models(GetThreads())
+		, m_begun(false)
+		, m_reported(false)
+		, m_total(0)
+		, m_last(0)
+	{
+	}
+
+	//! True once the header of the output is written.
+	bool HasBegun() const { return m_begun; }
+	//! True if the failure of Walk was already reported.
+	bool HasReported() const { return m_reported; }
+	size_t GetTotal() const { return m_total; }
+	uint64_t GetLast() const { return m_last; }
+
+protected:
+	bool Begin(const GLOVE_RECORD& record, const GLOVE_DATA& data) override
+	{
+		// The first frame gives the header of the output
+		SkeletalModel model;
+		FRAME first;
+		first.timestamp = record.timestamp;
+		first.data = data;
+		if (!model.InitializeScene() || !model.Simulate(first.data, &first.model, m_hand))
+		{
+			fprintf(stderr, "Failed to load the hand model\n");
+			m_reported = true;
+			return false;
+		}
+
+		if (!m_exporter->Begin(m_path, m_hand, first))
+		{
+			fprintf(stderr, "Failed to open %s\n", m_path);
+			m_reported = true;
+			return false;
+		}
+
+		m_begun = true;
+		m_last = first.timestamp;
+		return true;
+	}
+
+	bool Start(unsigned int thread) override
+	{
+		m_models[thread].reset(new SkeletalModel());
+		return m_models[thread]->InitializeScene();
+	}
+
+	bool Process(unsigned int thread, const GLOVE_RECORD* records, const GLOVE_DATA* data,
+		size_t count, CONVERTED& output) override
+	{
+		std::vector<FRAME> frames(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			frames[i].timestamp = records[i].timestamp;
+			frames[i].data = data[i];
+			if (!m_models[thread]->Simulate(frames[i].data, &frames[i].model, m_hand))
+				return false;
+		}
+
+		output.streams.resize(m_exporter->GetStreamCount());
+		output.count = count;
+		output.last = count > 0 ? frames.back().timestamp : 0;
+		if (count > 0)
+			m_exporter->Format(frames.data(), count, output.streams);
+		return true;
+	}
+
+	bool Consume(CONVERTED& output) override
+	{
+		if (!m_exporter->Write(output.streams))
+		{
+			fprintf(stderr, "Failed to write %s\n", m_path);
+			m_reported = true;
+			return false;
+		}
+
+		if (output.count > 0)
+		{
+			m_total += output.count;
+			m_last = output.last;
+		}
+		return true;
+	}
+};
+
+static const char* GetExtension(const char* path)
+{
+	const char* dot = strrchr(path, '.');
+	return dot ? dot + 1 : "";
+}
+
+int main(int argc, char* argv[])
+{
+	const char* format = nullptr;
+	const char* profile_path = nullptr;
+	unsigned int threads = std::thread::hardware_concurrency();
+	const char* paths[2] = { nullptr, nullptr };
+	int num_paths = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+			format = argv[++i];
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+			threads = (unsigned int)atoi(argv[++i]);
+		else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+			profile_path = argv[++i];
+		else if (num_paths < 2)
+			paths[num_paths++] = argv[i];
+	}
+
+	if (num_paths != 2)
+	{
+		fprintf(stderr, "Usage: ManusConvert [--format bvh|csv|gltf] [--threads n] [--profile file] input output\n");
+		return 1;
+	}
+
+	if (threads == 0)
+		threads = 1;
+
+	std::unique_ptr<Exporter> exporter(Exporter::Create(format ? format : GetExtension(paths[1])));
+	if (!exporter)
+	{
+		fprintf(stderr, "Unknown output format, use bvh, csv or gltf\n");
+		return 1;
+	}
+
+	GLOVE_PROFILE profile;
+	FingerProfile::GetDefault(&profile);
+	if (profile_path && !FingerProfile::Load(profile_path, &profile))
+	{
+		fprintf(stderr, "Failed to read the profile %s\n", profile_path);
+		return 1;
+	}
+
+	RecordingReader reader;
+	if (!reader.Open(paths[0]))
+	{
+		fprintf(stderr, "Failed to read the recording %s\n", paths[0]);
+		return 1;
+	}
+
+	Converter converter(exporter.get(), paths[1], reader.GetHand(), threads);
+	if (!converter.Walk(reader, profile))
+	{
+		if (!converter.HasReported())
+			fprintf(stderr, "The recording %s is corrupt\n", paths[0]);
+		return 1;
+	}
+
+	if (!converter.HasBegun())
+	{
+		fprintf(stderr, "The recording %s is empty\n", paths[0]);
+		return 1;
+	}
+
+	size_t total = converter.GetTotal();
+	if (!exporter->End(converter.GetLast(), total))
+	{
+		fprintf(stderr, "Failed to write %s\n", paths[1]);
+		return 1;
+	}
+
+	printf("Converted %u samples to %s\n", (unsigned int)total, paths[1]);
+
+	return 0;
+}
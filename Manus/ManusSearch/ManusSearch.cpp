@@ -0,0 +1,374 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*
+ * Builds and queries a pose index over recordings made by ManusRecordStart.
+ *
+ * The reports of every recording go through the same decoder as a live
+ * glove. Building walks each recording in chunks of blocks that are decoded
+ * and reduced to descriptors on all cores, then trains the quantizer on the
+ * descriptors and encodes them in parallel.
+ *
+ * Usage:
+ *   ManusSearch build [--threads n] [--profile file] index recording...
+ *   ManusSearch query [--k n] [--probes n] [--profile file] index --pose f0,f1,f2,f3,f4[,w,x,y,z]
+ *   ManusSearch query [--k n] [--probes n] [--profile file] index --frame recording timestamp
+ *
+ * A pose without a quaternion matches the fingers in any orientation.
+ */
+
+#include "stdafx.h"
+#include "Manus.h"
+#include "FingerProfile.h"
+#include "RecordingWalker.h"
+#include "PoseIndex.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Samples encoded together by one thread
+#define ENCODE_SAMPLES 65536
+
+// Number of gravity directions scanned by default
+#define DEFAULT_PROBES 4
+
+#define USAGE \
+	"Usage: ManusSearch build [--threads n] [--profile file] index recording...\n" \
+	"       ManusSearch query [--k n] [--probes n] [--profile file] index --pose f0,f1,f2,f3,f4[,w,x,y,z]\n" \
+	"       ManusSearch query [--k n] [--probes n] [--profile file] index --frame recording timestamp\n"
+
+/*! The descriptors of all recordings, in the order they are read. */
+typedef struct
+{
+	std::vector<POSE_DESCRIPTOR> descriptors;
+	std::vector<uint64_t> timestamps;
+	std::vector<uint16_t> recordings;
+} SAMPLES;
+
+/*! The descriptors of a chunk of a recording. */
+typedef struct
+{
+	std::vector<POSE_DESCRIPTOR> descriptors;
+	std::vector<uint64_t> timestamps;
+} EXTRACTED;
+
+/*
+ * Reduces the samples of a recording to descriptors and appends them in order.
+ */
+class Extractor : public RecordingWalker<EXTRACTED>
+{
+private:
+	uint16_t m_recording;
+	SAMPLES& m_samples;
+
+public:
+	Extractor(uint16_t recording, unsigned int threads, SAMPLES& samples)
+		: RecordingWalker<EXTRACTED>(threads)
+		, m_recording(recording)
+		, m_samples(samples)
+	{
+	}
+
+protected:
+	bool Process(unsigned int thread, const GLOVE_RECORD* records, const GLOVE_DATA* data,
+		size_t count, EXTRACTED& output) override
+	{
+		output.descriptors.resize(count);
+		output.timestamps.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			PoseIndex::GetDescriptor(data[i], &output.descriptors[i]);
+			output.timestamps[i] = records[i].timestamp;
+		}
+		return true;
+	}
+
+	bool Consume(EXTRACTED& output) override
+	{
+		m_samples.descriptors.insert(m_samples.descriptors.end(), output.descriptors.begin(), output.descriptors.end());
+		m_samples.timestamps.insert(m_samples.timestamps.end(), output.timestamps.begin(), output.timestamps.end());
+		m_samples.recordings.insert(m_samples.recordings.end(), output.descriptors.size(), m_recording);
+		return true;
+	}
+};
+
+static bool ExtractRecording(const char* path, uint16_t recording, unsigned int threads,
+	const GLOVE_PROFILE& profile, SAMPLES& samples)
+{
+	RecordingReader reader;
+	if (!reader.Open(path))
+	{
+		fprintf(stderr, "Failed to read the recording %s\n", path);
+		return false;
+	}
+
+	Extractor extractor(recording, threads, samples);
+	if (!extractor.Walk(reader, profile))
+	{
+		fprintf(stderr, "The recording %s is corrupt\n", path);
+		return false;
+	}
+
+	return true;
+}
+
+static int Build(const char* index_path, const std::vector<const char*>& paths, unsigned int threads,
+	const GLOVE_PROFILE& profile)
+{
+	if (paths.size() > UINT16_MAX + 1)
+	{
+		fprintf(stderr, "An index holds at most %u recordings\n", UINT16_MAX + 1);
+		return 1;
+	}
+
+	PoseIndex index;
+	SAMPLES samples;
+	for (const char* path : paths)
+	{
+		if (!ExtractRecording(path, index.AddRecording(path), threads, profile, samples))
+			return 1;
+	}
+
+	size_t count = samples.descriptors.size();
+	if (count == 0)
+	{
+		fprintf(stderr, "The recordings are empty\n");
+		return 1;
+	}
+
+	index.Train(samples.descriptors.data(), count);
+
+	// Encode in parallel, the samples are added in order afterwards so the index doesn't depend on the threads
+	std::vector<uint8_t> codes(count * POSE_SUBSPACES);
+	std::vector<uint8_t> bins(count);
+	std::atomic<size_t> next(0);
+
+	std::vector<std::thread> workers;
+	for (unsigned int t = 0; t < threads; t++)
+	{
+		workers.push_back(std::thread([&] {
+			for (size_t start = next.fetch_add(ENCODE_SAMPLES); start < count; start = next.fetch_add(ENCODE_SAMPLES))
+			{
+				for (size_t i = start; i < count && i < start + ENCODE_SAMPLES; i++)
+				{
+					index.Encode(samples.descriptors[i], &codes[i * POSE_SUBSPACES]);
+					bins[i] = (uint8_t)PoseIndex::GetBin(samples.descriptors[i]);
+				}
+			}
+		}));
+	}
+
+	for (std::thread& worker : workers)
+		worker.join();
+
+	for (size_t i = 0; i < count; i++)
+		index.Add(bins[i], &codes[i * POSE_SUBSPACES], samples.recordings[i], samples.timestamps[i]);
+
+	if (!index.Save(index_path))
+	{
+		fprintf(stderr, "Failed to write %s\n", index_path);
+		return 1;
+	}
+
+	printf("Indexed %u samples of %u recordings in %s\n", (unsigned int)count, (unsigned int)paths.size(), index_path);
+
+	return 0;
+}
+
+static bool ParsePose(const char* text, GLOVE_DATA* data, bool* orientation)
+{
+	float values[9];
+	int count = 0;
+	const char* value = text;
+	while (true)
+	{
+		if (count == 9)
+			return false;
+
+		char* end;
+		values[count++] = strtof(value, &end);
+		if (end == value)
+			return false;
+		if (*end == '\0')
+			break;
+		if (*end != ',')
+			return false;
+		value = end + 1;
+	}
+
+	if (count != GLOVE_FINGERS && count != GLOVE_FINGERS + 4)
+		return false;
+
+	memset(data, 0, sizeof(GLOVE_DATA));
+	for (int i = 0; i < GLOVE_FINGERS; i++)
+		data->Fingers[i] = values[i];
+
+	*orientation = count > GLOVE_FINGERS;
+	if (*orientation)
+	{
+		data->Quaternion.w = values[5];
+		data->Quaternion.x = values[6];
+		data->Quaternion.y = values[7];
+		data->Quaternion.z = values[8];
+	}
+
+	return true;
+}
+
+static bool ReadFrame(const char* path, uint64_t timestamp, const GLOVE_PROFILE& profile, GLOVE_DATA* data)
+{
+	RecordingReader reader;
+	if (!reader.Open(path))
+		return false;
+
+	// Play the recording up to the frame so the glove is in the same state as during the build
+	RecordingPlayer player(reader.GetHand(), reader.GetFlags(), profile);
+	std::vector<GLOVE_RECORD> records;
+	bool found = false;
+	while (!found)
+	{
+		records.clear();
+		if (reader.ReadRecords(records) != RECORDING_BLOCK)
+			break;
+
+		for (const GLOVE_RECORD& record : records)
+		{
+			player.Play(record, data);
+			if (record.timestamp >= timestamp)
+			{
+				found = true;
+				break;
+			}
+		}
+	}
+
+	return found;
+}
+
+static int Query(const char* index_path, const char* pose, const char* frame, uint64_t timestamp,
+	size_t k, int probes, const GLOVE_PROFILE& profile)
+{
+	PoseIndex index;
+	if (!index.Load(index_path))
+	{
+		fprintf(stderr, "Failed to read the index %s\n", index_path);
+		return 1;
+	}
+
+	GLOVE_DATA data;
+	bool orientation = true;
+	if (pose && !ParsePose(pose, &data, &orientation))
+	{
+		fprintf(stderr, "A pose is five finger values optionally followed by a quaternion w,x,y,z\n");
+		return 1;
+	}
+	if (frame && !ReadFrame(frame, timestamp, profile, &data))
+	{
+		fprintf(stderr, "The recording %s has no sample at %" PRIu64 "\n", frame, timestamp);
+		return 1;
+	}
+
+	POSE_DESCRIPTOR query;
+	PoseIndex::GetDescriptor(data, &query, orientation);
+
+	std::vector<POSE_MATCH> matches;
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	index.Search(query, k, probes, orientation, matches);
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+	for (size_t i = 0; i < matches.size(); i++)
+	{
+		printf("%3u  %.4f  %s  %" PRIu64 "\n", (unsigned int)(i + 1), matches[i].distance,
+			index.GetRecording(matches[i].recording).c_str(), matches[i].timestamp);
+	}
+	printf("Found %u matches among %u samples in %.2f ms\n", (unsigned int)matches.size(),
+		(unsigned int)index.GetCount(), elapsed.count());
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2 || (strcmp(argv[1], "build") != 0 && strcmp(argv[1], "query") != 0))
+	{
+		fprintf(stderr, USAGE);
+		return 1;
+	}
+	bool build = strcmp(argv[1], "build") == 0;
+
+	const char* profile_path = nullptr;
+	unsigned int threads = std::thread::hardware_concurrency();
+	size_t k = 10;
+	int probes = DEFAULT_PROBES;
+	const char* pose = nullptr;
+	const char* frame = nullptr;
+	uint64_t timestamp = 0;
+	std::vector<const char*> paths;
+
+	for (int i = 2; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+			threads = (unsigned int)atoi(argv[++i]);
+		else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+			profile_path = argv[++i];
+		else if (strcmp(argv[i], "--k") == 0 && i + 1 < argc)
+			k = (size_t)atoi(argv[++i]);
+		else if (strcmp(argv[i], "--probes") == 0 && i + 1 < argc)
+			probes = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--pose") == 0 && i + 1 < argc)
+			pose = argv[++i];
+		else if (strcmp(argv[i], "--frame") == 0 && i + 2 < argc)
+		{
+			frame = argv[++i];
+			timestamp = strtoull(argv[++i], nullptr, 10);
+		}
+		else
+			paths.push_back(argv[i]);
+	}
+
+	if (build ? paths.size() < 2 : (paths.size() != 1 || (pose == nullptr) == (frame == nullptr)))
+	{
+		fprintf(stderr, USAGE);
+		return 1;
+	}
+
+	if (threads == 0)
+		threads = 1;
+
+	GLOVE_PROFILE profile;
+	FingerProfile::GetDefault(&profile);
+	if (profile_path && !FingerProfile::Load(profile_path, &profile))
+	{
+		fprintf(stderr, "Failed to read the profile %s\n", profile_path);
+		return 1;
+	}
+
+	if (build)
+		return Build(paths[0], std::vector<const char*>(paths.begin() + 1, paths.end()), threads, profile);
+	else
+		return Query(paths[0], pose, frame, timestamp, k, probes, profile);
+}
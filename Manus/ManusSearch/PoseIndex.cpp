@@ -0,0 +1,411 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "PoseIndex.h"
+#include "Glove.h"
+#include "ManusMath.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <queue>
+#include <thread>
+#include <utility>
+
+// Scale of the gravity direction against the fingers, turning the hand
+// upside down weighs as much as bending a single finger
+#define ORIENTATION_WEIGHT 0.5f
+
+// Descriptors the centroids are learned from and the k-means iterations
+#define POSE_TRAIN_SAMPLES 65536
+#define POSE_ITERATIONS    20
+
+// The orientation gets a subspace of its own so it can be left out of a query
+static const int g_offsets[POSE_SUBSPACES + 1] = { 0, 2, 4, 5, 8 };
+#define ORIENTATION_SUBSPACE 3
+
+typedef struct
+{
+	float x, y, z;
+} DIRECTION;
+
+static const DIRECTION* GetDirections()
+{
+	static const std::vector<DIRECTION> directions = [] {
+		std::vector<DIRECTION> result;
+		for (int x = -1; x <= 1; x++)
+		{
+			for (int y = -1; y <= 1; y++)
+			{
+				for (int z = -1; z <= 1; z++)
+				{
+					if (x == 0 && y == 0 && z == 0)
+						continue;
+
+					float length = sqrtf((float)(x * x + y * y + z * z));
+					result.push_back({ x / length, y / length, z / length });
+				}
+			}
+		}
+		return result;
+	}();
+	return directions.data();
+}
+
+static float Distance(const float* a, const float* b, int dimensions)
+{
+	float sum = 0.0f;
+	for (int d = 0; d < dimensions; d++)
+		sum += (a[d] - b[d]) * (a[d] - b[d]);
+	return sum;
+}
+
+static int Nearest(const std::vector<float>& centroids, const float* value, int dimensions)
+{
+	int nearest = 0;
+	float best = FLT_MAX;
+	for (int k = 0; k < POSE_CENTROIDS; k++)
+	{
+		float distance = Distance(&centroids[k * dimensions], value, dimensions);
+		if (distance < best)
+		{
+			best = distance;
+			nearest = k;
+		}
+	}
+	return nearest;
+}
+
+PoseIndex::PoseIndex()
+	: m_trained(false)
+{
+}
+
+void PoseIndex::GetDescriptor(const GLOVE_DATA& data, POSE_DESCRIPTOR* descriptor, bool orientation)
+{
+	for (int i = 0; i < GLOVE_FINGERS; i++)
+		descriptor->values[i] = data.Fingers[i];
+
+	GLOVE_VECTOR gravity = { 0.0f, 0.0f, 0.0f };
+	if (orientation)
+		ManusMath::GetGravity(&gravity, &data.Quaternion);
+
+	descriptor->values[GLOVE_FINGERS + 0] = gravity.x * ORIENTATION_WEIGHT;
+	descriptor->values[GLOVE_FINGERS + 1] = gravity.y * ORIENTATION_WEIGHT;
+	descriptor->values[GLOVE_FINGERS + 2] = gravity.z * ORIENTATION_WEIGHT;
+}
+
+int PoseIndex::GetBin(const POSE_DESCRIPTOR& descriptor)
+{
+	const float* gravity = &descriptor.values[GLOVE_FINGERS];
+	const DIRECTION* directions = GetDirections();
+
+	int bin = 0;
+	float best = -FLT_MAX;
+	for (int i = 0; i < POSE_BINS; i++)
+	{
+		float dot = gravity[0] * directions[i].x + gravity[1] * directions[i].y + gravity[2] * directions[i].z;
+		if (dot > best)
+		{
+			best = dot;
+			bin = i;
+		}
+	}
+	return bin;
+}
+
+void PoseIndex::Train(const POSE_DESCRIPTOR* descriptors, size_t count)
+{
+	size_t stride = std::max<size_t>(1, count / POSE_TRAIN_SAMPLES);
+	size_t samples = count / stride;
+
+	std::vector<std::thread> threads;
+	for (int m = 0; m < POSE_SUBSPACES; m++)
+	{
+		threads.push_back(std::thread([=] {
+			int dimensions = g_offsets[m + 1] - g_offsets[m];
+
+			std::vector<float> train(samples * dimensions);
+			for (size_t i = 0; i < samples; i++)
+			{
+				for (int d = 0; d < dimensions; d++)
+					train[i * dimensions + d] = descriptors[i * stride].values[g_offsets[m] + d];
+			}
+
+			// Start from samples spread over the whole set
+			std::vector<float>& centroids = m_centroids[m];
+			centroids.assign(POSE_CENTROIDS * dimensions, 0.0f);
+			for (int k = 0; k < POSE_CENTROIDS && samples > 0; k++)
+			{
+				size_t i = (size_t)k * samples / POSE_CENTROIDS;
+				for (int d = 0; d < dimensions; d++)
+					centroids[k * dimensions + d] = train[i * dimensions + d];
+			}
+
+			std::vector<double> sums(POSE_CENTROIDS * dimensions);
+			std::vector<size_t> sizes(POSE_CENTROIDS);
+			for (int iteration = 0; iteration < POSE_ITERATIONS && samples > 0; iteration++)
+			{
+				std::fill(sums.begin(), sums.end(), 0.0);
+				std::fill(sizes.begin(), sizes.end(), 0);
+
+				for (size_t i = 0; i < samples; i++)
+				{
+					int k = Nearest(centroids, &train[i * dimensions], dimensions);
+					for (int d = 0; d < dimensions; d++)
+						sums[k * dimensions + d] += train[i * dimensions + d];
+					sizes[k]++;
+				}
+
+				// An empty cluster keeps its centroid
+				for (int k = 0; k < POSE_CENTROIDS; k++)
+				{
+					if (sizes[k] == 0)
+						continue;
+					for (int d = 0; d < dimensions; d++)
+						centroids[k * dimensions + d] = (float)(sums[k * dimensions + d] / sizes[k]);
+				}
+			}
+		}));
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	m_trained = true;
+}
+
+void PoseIndex::Encode(const POSE_DESCRIPTOR& descriptor, uint8_t codes[POSE_SUBSPACES]) const
+{
+	for (int m = 0; m < POSE_SUBSPACES; m++)
+		codes[m] = (uint8_t)Nearest(m_centroids[m], &descriptor.values[g_offsets[m]], g_offsets[m + 1] - g_offsets[m]);
+}
+
+uint16_t PoseIndex::AddRecording(const char* path)
+{
+	m_recordings.push_back(path);
+	return (uint16_t)(m_recordings.size() - 1);
+}
+
+void PoseIndex::Add(int bin, const uint8_t codes[POSE_SUBSPACES], uint16_t recording, uint64_t timestamp)
+{
+	POSE_LIST& list = m_lists[bin];
+	list.codes.insert(list.codes.end(), codes, codes + POSE_SUBSPACES);
+	list.timestamps.push_back(timestamp);
+	list.recordings.push_back(recording);
+}
+
+size_t PoseIndex::GetCount() const
+{
+	size_t count = 0;
+	for (const POSE_LIST& list : m_lists)
+		count += list.timestamps.size();
+	return count;
+}
+
+void PoseIndex::Search(const POSE_DESCRIPTOR& query, size_t k, int probes, bool orientation,
+	std::vector<POSE_MATCH>& matches) const
+{
+	matches.clear();
+	if (!m_trained || k == 0)
+		return;
+
+	// Distance from the query to every centroid, a sample then costs one lookup per subspace
+	float table[POSE_SUBSPACES][POSE_CENTROIDS];
+	for (int m = 0; m < POSE_SUBSPACES; m++)
+	{
+		int dimensions = g_offsets[m + 1] - g_offsets[m];
+		for (int c = 0; c < POSE_CENTROIDS; c++)
+		{
+			if (m == ORIENTATION_SUBSPACE && !orientation)
+				table[m][c] = 0.0f;
+			else
+				table[m][c] = Distance(&m_centroids[m][c * dimensions], &query.values[g_offsets[m]], dimensions);
+		}
+	}
+
+	// Scan the lists of the gravity directions closest to the query
+	std::vector<std::pair<float, int>> bins;
+	const float* gravity = &query.values[GLOVE_FINGERS];
+	const DIRECTION* directions = GetDirections();
+	for (int i = 0; i < POSE_BINS; i++)
+		bins.push_back(std::make_pair(-(gravity[0] * directions[i].x + gravity[1] * directions[i].y + gravity[2] * directions[i].z), i));
+	std::sort(bins.begin(), bins.end());
+	if (orientation)
+		bins.resize(std::min(std::max(probes, 1), POSE_BINS));
+
+	// Max-heap of the best matches so far
+	typedef std::pair<float, std::pair<int, size_t>> CANDIDATE;
+	std::priority_queue<CANDIDATE> best;
+	float worst = FLT_MAX;
+
+	for (const std::pair<float, int>& bin : bins)
+	{
+		const POSE_LIST& list = m_lists[bin.second];
+		const uint8_t* codes = list.codes.data();
+		size_t count = list.timestamps.size();
+
+		for (size_t i = 0; i < count; i++, codes += POSE_SUBSPACES)
+		{
+			float distance = table[0][codes[0]] + table[1][codes[1]] + table[2][codes[2]] + table[3][codes[3]];
+			if (distance >= worst)
+				continue;
+
+			best.push(std::make_pair(distance, std::make_pair(bin.second, i)));
+			if (best.size() > k)
+				best.pop();
+			if (best.size() == k)
+				worst = best.top().first;
+		}
+	}
+
+	matches.resize(best.size());
+	for (size_t i = matches.size(); i > 0; i--)
+	{
+		const CANDIDATE& candidate = best.top();
+		const POSE_LIST& list = m_lists[candidate.second.first];
+		matches[i - 1].recording = list.recordings[candidate.second.second];
+		matches[i - 1].timestamp = list.timestamps[candidate.second.second];
+		matches[i - 1].distance = sqrtf(candidate.first);
+		best.pop();
+	}
+}
+
+bool PoseIndex::Save(const char* path) const
+{
+	if (!m_trained)
+		return false;
+
+	FILE* file = fopen(path, "wb");
+	if (!file)
+		return false;
+
+	uint32_t magic = POSE_INDEX_MAGIC;
+	uint8_t version[4] = { POSE_INDEX_VERSION, 0, 0, 0 };
+	uint32_t recordings = (uint32_t)m_recordings.size();
+	bool ok = fwrite(&magic, sizeof(magic), 1, file) == 1 &&
+		fwrite(version, sizeof(version), 1, file) == 1 &&
+		fwrite(&recordings, sizeof(recordings), 1, file) == 1;
+
+	for (const std::string& recording : m_recordings)
+	{
+		uint16_t length = (uint16_t)recording.size();
+		ok = ok && fwrite(&length, sizeof(length), 1, file) == 1 &&
+			fwrite(recording.data(), 1, length, file) == length;
+	}
+
+	for (int m = 0; m < POSE_SUBSPACES; m++)
+		ok = ok && fwrite(m_centroids[m].data(), sizeof(float), m_centroids[m].size(), file) == m_centroids[m].size();
+
+	for (const POSE_LIST& list : m_lists)
+	{
+		uint32_t count = (uint32_t)list.timestamps.size();
+		ok = ok && fwrite(&count, sizeof(count), 1, file) == 1;
+		if (count == 0)
+			continue;
+
+		ok = ok && fwrite(list.codes.data(), POSE_SUBSPACES, count, file) == count &&
+			fwrite(list.timestamps.data(), sizeof(uint64_t), count, file) == count &&
+			fwrite(list.recordings.data(), sizeof(uint16_t), count, file) == count;
+	}
+
+	return fclose(file) == 0 && ok;
+}
+
+bool PoseIndex::Load(const char* path)
+{
+	FILE* file = fopen(path, "rb");
+	if (!file)
+		return false;
+
+	// The counts in the file are checked against its length before anything is allocated
+	_fseeki64(file, 0, SEEK_END);
+	int64_t file_length = _ftelli64(file);
+	_fseeki64(file, 0, SEEK_SET);
+
+	uint32_t magic;
+	uint8_t version[4];
+	uint32_t recordings;
+	bool ok = fread(&magic, sizeof(magic), 1, file) == 1 && magic == POSE_INDEX_MAGIC &&
+		fread(version, sizeof(version), 1, file) == 1 && version[0] == POSE_INDEX_VERSION &&
+		fread(&recordings, sizeof(recordings), 1, file) == 1 && recordings <= UINT16_MAX + 1 &&
+		(int64_t)(recordings * sizeof(uint16_t)) <= file_length - _ftelli64(file);
+
+	m_recordings.clear();
+	for (uint32_t i = 0; i < recordings && ok; i++)
+	{
+		uint16_t length;
+		std::string recording;
+		ok = fread(&length, sizeof(length), 1, file) == 1 && length <= file_length - _ftelli64(file);
+		if (ok)
+		{
+			recording.resize(length);
+			ok = length == 0 || fread(&recording[0], 1, length, file) == length;
+		}
+		m_recordings.push_back(recording);
+	}
+
+	for (int m = 0; m < POSE_SUBSPACES && ok; m++)
+	{
+		size_t size = POSE_CENTROIDS * (g_offsets[m + 1] - g_offsets[m]);
+		ok = (int64_t)(size * sizeof(float)) <= file_length - _ftelli64(file);
+		if (!ok)
+			break;
+
+		m_centroids[m].resize(size);
+		ok = fread(m_centroids[m].data(), sizeof(float), m_centroids[m].size(), file) == m_centroids[m].size();
+	}
+
+	for (POSE_LIST& list : m_lists)
+	{
+		uint32_t count = 0;
+		ok = ok && fread(&count, sizeof(count), 1, file) == 1 &&
+			(int64_t)count * (int64_t)(POSE_SUBSPACES + sizeof(uint64_t) + sizeof(uint16_t)) <= file_length - _ftelli64(file);
+		if (!ok)
+			count = 0;
+
+		list.codes.resize((size_t)count * POSE_SUBSPACES);
+		list.timestamps.resize(count);
+		list.recordings.resize(count);
+		if (count == 0)
+			continue;
+
+		ok = fread(list.codes.data(), POSE_SUBSPACES, count, file) == count &&
+			fread(list.timestamps.data(), sizeof(uint64_t), count, file) == count &&
+			fread(list.recordings.data(), sizeof(uint16_t), count, file) == count;
+	}
+
+	// Nothing may follow the lists
+	ok = ok && _ftelli64(file) == file_length;
+	fclose(file);
+
+	// Every sample has to refer to a recording of the index
+	for (const POSE_LIST& list : m_lists)
+	{
+		for (uint16_t recording : list.recordings)
+			ok = ok && recording < m_recordings.size();
+	}
+
+	m_trained = ok;
+	return ok;
+}
@@ -0,0 +1,151 @@
+/**
+ * Copyright (C) 2015 Manus Machina
+ *
+ * This file is part of the Manus SDK.
+ *
+ * Manus SDK is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Manus SDK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Manus SDK. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "Manus.h"
+
+#include <inttypes.h>
+#include <string>
+#include <vector>
+
+#define POSE_INDEX_MAGIC   0x5849504D // "MPIX"
+#define POSE_INDEX_VERSION 1
+
+// Five fingers followed by the direction of gravity in the frame of the palm
+#define POSE_DIMENSIONS    8
+#define POSE_SUBSPACES     4
+#define POSE_CENTROIDS     256
+
+// Inverted lists, one for every direction from the center of a cube to
+// the center of one of its faces, edges or corners
+#define POSE_BINS          26
+
+/*! A pose reduced to the values that are compared by the index. */
+typedef struct
+{
+	float values[POSE_DIMENSIONS];
+} POSE_DESCRIPTOR;
+
+/*! A sample of a recording found by PoseIndex::Search. */
+typedef struct
+{
+	uint16_t recording;
+	uint64_t timestamp;
+	//! Approximate distance between the descriptors.
+	float distance;
+} POSE_MATCH;
+
+/*
+ * Nearest neighbour index over the poses of a set of recordings.
+ *
+ * A descriptor holds the five fingers and the direction of gravity as seen
+ * from the palm, which describes the orientation of the hand without its
+ * heading. The samples are split into inverted lists by the nearest of 26
+ * gravity directions, and within a list every descriptor is product
+ * quantized: it is cut into four subspaces and each subspace is replaced by
+ * the byte of its nearest centroid. A query only scans the lists of the
+ * directions closest to its own, summing the distances to the centroids from
+ * a small table, so millions of samples take a few milliseconds.
+ *
+ * File layout, all fields little-endian:
+ *
+ *   uint32  magic
+ *   uint8   version
+ *   uint8   reserved[3]
+ *   uint32  number of recordings
+ *   per recording:
+ *     uint16  length of the path
+ *     char    path[length]
+ *   float   centroids[POSE_SUBSPACES][POSE_CENTROIDS][dimensions of the subspace]
+ *   per list:
+ *     uint32  number of samples
+ *     uint8   codes[count][POSE_SUBSPACES]
+ *     uint64  timestamps[count]
+ *     uint16  recordings[count]
+ */
+class PoseIndex
+{
+private:
+	typedef struct
+	{
+		std::vector<uint8_t> codes;
+		std::vector<uint64_t> timestamps;
+		std::vector<uint16_t> recordings;
+	} POSE_LIST;
+
+	std::vector<std::string> m_recordings;
+	std::vector<float> m_centroids[POSE_SUBSPACES];
+	POSE_LIST m_lists[POSE_BINS];
+	bool m_trained;
+
+public:
+	PoseIndex();
+
+	/*! \brief Get the descriptor of a sample.
+	*
+	*  \param orientation False to leave the orientation out, which matches
+	*                     the fingers in any orientation.
+	*/
+	static void GetDescriptor(const GLOVE_DATA& data, POSE_DESCRIPTOR* descriptor, bool orientation = true);
+
+	/*! The inverted list a descriptor belongs to. */
+	static int GetBin(const POSE_DESCRIPTOR& descriptor);
+
+	/*! \brief Learn the centroids of every subspace.
+	*
+	*  Runs k-means on an evenly spaced subset of the descriptors, the
+	*  subspaces are trained in parallel.
+	*/
+	void Train(const POSE_DESCRIPTOR* descriptors, size_t count);
+
+	bool IsTrained() const { return m_trained; }
+
+	/*! Quantize a descriptor, may be called from several threads once trained. */
+	void Encode(const POSE_DESCRIPTOR& descriptor, uint8_t codes[POSE_SUBSPACES]) const;
+
+	/*! \brief Register a recording.
+	*
+	*  \return The number the samples of the recording are added with.
+	*/
+	uint16_t AddRecording(const char* path);
+
+	const std::string& GetRecording(uint16_t recording) const { return m_recordings[recording]; }
+	size_t GetRecordingCount() const { return m_recordings.size(); }
+
+	/*! Add an encoded sample to a list. */
+	void Add(int bin, const uint8_t codes[POSE_SUBSPACES], uint16_t recording, uint64_t timestamp);
+
+	/*! Total number of samples in the index. */
+	size_t GetCount() const;
+
+	/*! \brief Find the samples closest to a pose.
+	*
+	*  \param k Number of matches to return, closest first.
+	*  \param probes Number of gravity directions to scan, ignored when the
+	*                query has no orientation.
+	*  \param orientation False if the query was made without orientation.
+	*/
+	void Search(const POSE_DESCRIPTOR& query, size_t k, int probes, bool orientation,
+		std::vector<POSE_MATCH>& matches) const;
+
+	bool Save(const char* path) const;
+	bool Load(const char* path);
+};
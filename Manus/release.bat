@@ -18,6 +18,7 @@ copy .\Release\Manus.lib .\%RELDIR%
 copy .\Release\ManusTest.exe .\%RELDIR%
 
 copy .\Manus\Manus.h .\%RELDIR%
+copy .\Manus\ManusAsync.h .\%RELDIR%
 copy .\ManusUnity\Manus.cs .\%RELDIR%
 
 powershell.exe -nologo -noprofile -command "& { Add-Type -A 'System.IO.Compression.FileSystem'; [IO.Compression.ZipFile]::CreateFromDirectory('%RELDIR%', '%RELDIR%.zip'); }"